@@ -0,0 +1,26 @@
+#ifndef BENCHES_H
+#define BENCHES_H
+
+// The LuxeMineBench benchmarks. Each builds its own synthetic rows, leaves
+// the shop's database alone and logs "[bench]" lines through qInfo().
+
+// Fill an in-memory order_book_detail with `rows` rows and log rows/second
+// for the old value("name") reads versus RowMapper::read()
+void benchRowMapper(int rows = 20000);
+
+// Log LossEngine per-row versus batch timings for `rows` synthetic jobs,
+// with the old regex purity parse as the baseline
+void benchLossEngine(int rows = 100000);
+
+// Log per-row heap bytes of the order and jobs lists, full structs with
+// fresh strings versus summary rows with pooled strings (StringPool)
+void benchStringPool(int rows = 100000);
+
+// Log the time to open the job sheet, order, jobs list and catalog forms
+// under the old app-wide stylesheet versus AppStyle, averaged over `opens`
+// opens.
+// Needs a QApplication; LuxeMineBench runs offscreen unless
+// QT_QPA_PLATFORM says otherwise.
+void benchStyle(int opens = 50);
+
+#endif // BENCHES_H
@@ -0,0 +1,44 @@
+#include <QApplication>
+#include <QDebug>
+#include <QStringList>
+
+#include <algorithm>
+#include <iterator>
+
+#include "benches.h"
+
+// LuxeMineBench [rowmapper|lossengine|stringpool|style]...
+// Runs the named benchmarks, or all of them; see benches.h.
+int main(int argc, char *argv[]) {
+  // Widgets are created for the style benchmark, never shown on screen
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  QApplication app(argc, argv);
+
+  const struct {
+    const char *name;
+    void (*run)();
+  } kBenches[] = {
+      {"rowmapper", [] { benchRowMapper(); }},
+      {"lossengine", [] { benchLossEngine(); }},
+      {"stringpool", [] { benchStringPool(); }},
+      {"style", [] { benchStyle(); }},
+  };
+
+  QStringList wanted = app.arguments().mid(1);
+  for (const QString &name : wanted) {
+    const bool known =
+        std::any_of(std::begin(kBenches), std::end(kBenches),
+                    [&](const auto &b) { return name == b.name; });
+    if (!known) {
+      qWarning().noquote() << "Unknown benchmark" << name;
+      return 1;
+    }
+  }
+
+  for (const auto &bench : kBenches) {
+    if (wanted.isEmpty() || wanted.contains(bench.name))
+      bench.run();
+  }
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include "benches.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+
+#include <iterator>
+
+#include "common/ledgerformulas.h"
+#include "common/lossengine.h"
+#include "common/purity.h"
+
+namespace {
+double nsPerRow(qint64 nsecs, int rows) {
+  return rows > 0 ? double(nsecs) / rows : 0.0;
+}
+} // namespace
+
+void benchLossEngine(int rows) {
+  // Default formulas: measures the engine, not the shop's database
+  const FormulaSet formulas(LedgerFormulas::inputs("jobs"),
+                            LedgerFormulas::defaults("jobs"));
+
+  // ---------- Synthetic jobs ----------
+  // All written as karats, so the regex baseline reads the same purity
+  const QString purities[] = {"18K", "22K", "14K", "24K", "18 k", "9K"};
+  QList<JobListData> jobs;
+  jobs.reserve(rows);
+  for (int i = 0; i < rows; ++i) {
+    JobListData d{};
+    d.jobId = i + 1;
+    d.metal = "Gold";
+    d.purity = purities[i % std::size(purities)];
+    d.fineness = Purity::parse(d.purity).fineness();
+    d.issueWt = 10.0 + (i % 97) * 0.125;
+    d.grossWt = 9.0 + (i % 89) * 0.125;
+    d.receiveDiaWt = (i % 7) * 0.05;
+    d.receiveStoneWt = (i % 5) * 0.04;
+    d.officeGoldReceive = (i % 11) * 0.01;
+    d.issueDiaWt = (i % 13) * 0.05;
+    d.issueStoneWt = (i % 3) * 0.04;
+    d.issueDiaPcs = i % 40;
+    d.receiveDiaPcs = i % 39;
+    jobs.append(d);
+  }
+
+  QElapsedTimer timer;
+  QVector<double> values(formulas.slotCount());
+
+  // ---------- Before: per row, purity through a new regex each time ------
+  QList<JobListData> perRowRegex = jobs;
+  timer.start();
+  for (JobListData &d : perRowRegex) {
+    LedgerFormulas::fill(d, values.data());
+    QRegularExpression re(R"((\d+)\s*[kK])");
+    const QRegularExpressionMatch match = re.match(d.purity);
+    values[formulas.slotOf("purity")] =
+        match.hasMatch() ? match.captured(1).toDouble() : 0.0;
+    formulas.evaluate(values.data());
+    LedgerFormulas::store(formulas, values.data(), d);
+  }
+  const qint64 regexNs = timer.nsecsElapsed();
+
+  // ---------- Per row through the interpreter ----------
+  QList<JobListData> perRow = jobs;
+  timer.start();
+  for (JobListData &d : perRow) {
+    LedgerFormulas::fill(d, values.data());
+    formulas.evaluate(values.data());
+    LedgerFormulas::store(formulas, values.data(), d);
+  }
+  const qint64 perRowNs = timer.nsecsElapsed();
+
+  // ---------- After: one batch ----------
+  QList<JobListData> batch = jobs;
+  timer.start();
+  LossEngine::apply(formulas, batch);
+  const qint64 batchNs = timer.nsecsElapsed();
+
+  // Same answers, or the timings mean nothing
+  double maxDiff = 0.0;
+  for (int i = 0; i < rows; ++i) {
+    const JobListData &a = batch.at(i);
+    for (const JobListData &b : {perRow.at(i), perRowRegex.at(i)}) {
+      maxDiff = qMax(maxDiff, qAbs(a.netWt - b.netWt));
+      maxDiff = qMax(maxDiff, qAbs(a.grossLoss - b.grossLoss));
+      maxDiff = qMax(maxDiff, qAbs(a.percentage - b.percentage));
+      maxDiff = qMax(maxDiff, qAbs(a.fineLoss - b.fineLoss));
+      maxDiff = qMax(maxDiff, qAbs(a.diaLoss - b.diaLoss));
+      maxDiff = qMax(maxDiff, qAbs(a.stoneLoss - b.stoneLoss));
+    }
+  }
+
+  qInfo().noquote()
+      << QString("[bench] LossEngine, %1 jobs: per row with regex %2 ns/row, "
+                 "per row %3 ns/row, batch %4 ns/row (%5x), max diff %6")
+             .arg(rows)
+             .arg(nsPerRow(regexNs, rows), 0, 'f', 1)
+             .arg(nsPerRow(perRowNs, rows), 0, 'f', 1)
+             .arg(nsPerRow(batchNs, rows), 0, 'f', 1)
+             .arg(batchNs > 0 ? double(perRowNs) / batchNs : 0.0, 0, 'f', 2)
+             .arg(maxDiff);
+}
@@ -0,0 +1,103 @@
+#include "benches.h"
+
+#include "database/rowmappings.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlError>
+
+namespace {
+const char *kConnection = "LuxeMineRowMapperBench";
+
+// Rows/second for one full pass over the table
+double rate(int rows, qint64 nsecs) {
+  return nsecs > 0 ? rows * 1e9 / double(nsecs) : 0.0;
+}
+} // namespace
+
+void benchRowMapper(int rows) {
+  using namespace RowMapper;
+  const auto &cols = columnsOf<OrderData>();
+
+  {
+    // In memory: measures the mapping, not the disk, and leaves the
+    // shop's database alone
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kConnection);
+    db.setDatabaseName(":memory:");
+    if (!db.open()) {
+      qWarning() << "RowMapper benchmark: cannot open:" << db.lastError();
+      return;
+    }
+
+    QSqlQuery q(db);
+    q.exec(QString("CREATE TABLE order_book_detail (%1)")
+               .arg(columnList(cols)));
+
+    // ---------- Fill ----------
+    OrderData sample;
+    sample.sellerName = "Seller";
+    sample.sellerId = 7;
+    sample.partyName = "Party";
+    sample.metalPurity = "18K";
+    sample.approxProductWt = 12.345;
+    sample.note = "benchmark row";
+
+    db.transaction();
+    q.prepare(QString("INSERT INTO order_book_detail (%1) VALUES (%2)")
+                  .arg(columnList(cols), placeholders(cols)));
+    for (int i = 0; i < rows; ++i) {
+      sample.productPis = i;
+      bind(q, sample, cols);
+      q.exec();
+    }
+    db.commit();
+
+    const QString select =
+        QString("SELECT %1 FROM order_book_detail").arg(columnList(cols));
+    QElapsedTimer timer;
+
+    // ---------- Before: value("name") per cell, scrollable cursor ----------
+    qint64 byName = 0;
+    {
+      QSqlQuery s(db);
+      s.prepare(select);
+      timer.start();
+      s.exec();
+      while (s.next()) {
+        OrderData o;
+        detail::forEach(cols, [&](int, const auto &c) {
+          if (!c.encode)
+            detail::assign(s.value(QLatin1String(c.name)), o.*(c.member));
+        });
+      }
+      byName = timer.nsecsElapsed();
+    }
+
+    // ---------- After: read() by index, forward-only ----------
+    qint64 byIndex = 0;
+    {
+      QSqlQuery s(db);
+      s.setForwardOnly(true);
+      s.prepare(select);
+      timer.start();
+      s.exec();
+      while (s.next()) {
+        OrderData o;
+        read(s, o, cols);
+      }
+      byIndex = timer.nsecsElapsed();
+    }
+
+    qInfo().noquote()
+        << QString("[bench] RowMapper, %1 rows x %2 columns: by name %3 "
+                   "rows/s, by index %4 rows/s (%5x)")
+               .arg(rows)
+               .arg(count(cols))
+               .arg(rate(rows, byName), 0, 'f', 0)
+               .arg(rate(rows, byIndex), 0, 'f', 0)
+               .arg(byIndex > 0 ? double(byName) / byIndex : 0.0, 0, 'f',
+                    2);
+  }
+  QSqlDatabase::removeDatabase(kConnection);
+}
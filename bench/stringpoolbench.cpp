@@ -0,0 +1,190 @@
+#include "benches.h"
+
+#include <QDate>
+#include <QDebug>
+#include <QList>
+
+#include <iterator>
+#include <tuple>
+
+#include "common/listrows.h"
+#include "common/stringpool.h"
+#include "models/OrderListRow.h"
+
+namespace {
+// A deep copy, as QSqlQuery::value().toString() gives for every cell
+QString fresh(const QString &s) { return QString(s.constData(), s.size()); }
+
+// Heap bytes of the rows: the list's array plus every distinct string
+// buffer (Qt's array header, UTF-16 capacity and terminator). A buffer
+// shared by several rows is counted once; allocator overhead is not.
+class HeapCount {
+public:
+  void add(const QString &s) {
+    if (s.isEmpty() || m_seen.contains(s.constData()))
+      return;
+    m_seen.insert(s.constData());
+    m_bytes += qsizetype(sizeof(QArrayData)) +
+               (s.capacity() + 1) * qsizetype(sizeof(char16_t));
+  }
+  template <typename T> void add(const T &) {}
+
+  template <typename Row> void addArray(const QList<Row> &rows) {
+    m_bytes += rows.capacity() * qsizetype(sizeof(Row));
+  }
+
+  double perRow(int rows) const {
+    return rows > 0 ? double(m_bytes) / rows : 0.0;
+  }
+
+private:
+  QSet<const void *> m_seen;
+  qsizetype m_bytes = 0;
+};
+
+// Strings of OrderData that getOrdersForSeller() used to fill, plus the
+// default it gives every row
+double orderDataBytes(const QList<OrderData> &rows) {
+  HeapCount heap;
+  heap.addArray(rows);
+  for (const OrderData &o : rows) {
+    for (const QString *s :
+         {&o.partyName, &o.sellerName, &o.metalName, &o.metalPurity,
+          &o.designNo, &o.orderDate, &o.deliveryDate, &o.extraDetail,
+          &o.designerStatus})
+      heap.add(*s);
+  }
+  return heap.perRow(rows.size());
+}
+
+double orderListRowBytes(const QList<OrderListRow> &rows) {
+  HeapCount heap;
+  heap.addArray(rows);
+  for (const OrderListRow &o : rows) {
+    for (const QString *s :
+         {&o.partyName, &o.sellerName, &o.metalName, &o.metalPurity,
+          &o.designNo, &o.orderDate, &o.deliveryDate, &o.extraDetail})
+      heap.add(*s);
+  }
+  return heap.perRow(rows.size());
+}
+
+double jobListBytes(const QList<JobListData> &rows) {
+  HeapCount heap;
+  heap.addArray(rows);
+  for (const JobListData &d : rows)
+    std::apply([&](const auto &...f) { (heap.add(f), ...); },
+               ListRow<JobListData>::tie(d));
+  return heap.perRow(rows.size());
+}
+} // namespace
+
+void benchStringPool(int rows) {
+  // Shop-like cardinalities: a few metals and purities, tens of sellers,
+  // hundreds of parties and dates, a design per order
+  const QString metals[] = {"Gold", "Silver", "Platinum"};
+  const QString purities[] = {"18K", "22K", "14K", "24K", "92.5%", "95%"};
+  const QString statuses[] = {"PENDING", "OPEN", "CLOSED", "RECEIVED"};
+  const QString categories[] = {"VVS", "VS", "SI", "Moissanite"};
+  auto party = [](int i) { return QString("Party %1").arg(i % 500); };
+  auto seller = [](int i) { return QString("S%1").arg(i % 20); };
+  auto date = [](int i) {
+    return QDate(2024, 1, 1).addDays(i % 365).toString(Qt::ISODate);
+  };
+
+  // ---------- Orders: before, OrderData with a fresh copy per cell -------
+  QList<OrderData> orders;
+  orders.reserve(rows);
+  for (int i = 0; i < rows; ++i) {
+    OrderData o;
+    o.orderId = i + 1;
+    o.jobId = i + 1;
+    o.sellerOrderSeq = i / 20 + 1;
+    o.partyName = fresh(party(i));
+    o.sellerName = fresh(seller(i));
+    o.productPis = i % 12 + 1;
+    o.metalName = fresh(metals[i % std::size(metals)]);
+    o.metalPurity = fresh(purities[i % std::size(purities)]);
+    o.designNo = QString("D%1").arg(i);
+    o.orderDate = fresh(date(i));
+    o.deliveryDate = fresh(date(i + 21));
+    o.extraDetail = i % 10 ? QString() : QString("rush");
+    orders.append(o);
+  }
+
+  // ---------- Orders: after, OrderListRow with pooled strings ------------
+  QList<OrderListRow> orderRows;
+  orderRows.reserve(rows);
+  StringPool orderPool;
+  for (int i = 0; i < rows; ++i) {
+    OrderListRow o;
+    o.orderId = i + 1;
+    o.jobId = i + 1;
+    o.sellerOrderSeq = i / 20 + 1;
+    o.partyName = orderPool.intern(fresh(party(i)));
+    o.sellerName = orderPool.intern(fresh(seller(i)));
+    o.productPis = i % 12 + 1;
+    o.metalName = orderPool.intern(fresh(metals[i % std::size(metals)]));
+    o.metalPurity = orderPool.intern(fresh(purities[i % std::size(purities)]));
+    o.designNo = QString("D%1").arg(i);
+    o.orderDate = orderPool.intern(fresh(date(i)));
+    o.deliveryDate = orderPool.intern(fresh(date(i + 21)));
+    o.extraDetail = i % 10 ? QString() : QString("rush");
+    orderRows.append(o);
+  }
+
+  // ---------- Jobs: the same rows, fresh strings versus pooled -----------
+  QList<JobListData> jobs;
+  QList<JobListData> pooledJobs;
+  jobs.reserve(rows);
+  pooledJobs.reserve(rows);
+  StringPool jobPool;
+  for (int i = 0; i < rows; ++i) {
+    JobListData d{};
+    d.jobId = d.dbJobId = i + 1;
+    d.jobNo = QString::number(d.jobId);
+    d.designNo = QString("D%1").arg(i);
+    d.pcs = i % 12 + 1;
+    d.issueWt = 10.0 + (i % 97) * 0.125;
+
+    JobListData p = d;
+    d.deliveryDate = fresh(date(i + 21));
+    d.metal = fresh(metals[i % std::size(metals)]);
+    d.purity = fresh(purities[i % std::size(purities)]);
+    d.status = fresh(statuses[i % std::size(statuses)]);
+    d.mfgIssueDate = fresh(date(i + 3));
+    d.issueDiaCategory = fresh(categories[i % std::size(categories)]);
+    jobs.append(d);
+
+    p.deliveryDate = jobPool.intern(fresh(date(i + 21)));
+    p.metal = jobPool.intern(fresh(metals[i % std::size(metals)]));
+    p.purity = jobPool.intern(fresh(purities[i % std::size(purities)]));
+    p.status = jobPool.intern(fresh(statuses[i % std::size(statuses)]));
+    p.mfgIssueDate = jobPool.intern(fresh(date(i + 3)));
+    p.issueDiaCategory =
+        jobPool.intern(fresh(categories[i % std::size(categories)]));
+    pooledJobs.append(p);
+  }
+
+  const double orderBefore = orderDataBytes(orders);
+  const double orderAfter = orderListRowBytes(orderRows);
+  const double jobBefore = jobListBytes(jobs);
+  const double jobAfter = jobListBytes(pooledJobs);
+
+  qInfo().noquote()
+      << QString("[bench] Order list, %1 rows: OrderData %2 bytes/row, "
+                 "OrderListRow pooled %3 bytes/row (%4x), %5 pooled strings")
+             .arg(rows)
+             .arg(orderBefore, 0, 'f', 1)
+             .arg(orderAfter, 0, 'f', 1)
+             .arg(orderAfter > 0 ? orderBefore / orderAfter : 0.0, 0, 'f', 2)
+             .arg(orderPool.size());
+  qInfo().noquote()
+      << QString("[bench] Jobs list, %1 rows: fresh strings %2 bytes/row, "
+                 "pooled %3 bytes/row (%4x), %5 pooled strings")
+             .arg(rows)
+             .arg(jobBefore, 0, 'f', 1)
+             .arg(jobAfter, 0, 'f', 1)
+             .arg(jobAfter > 0 ? jobBefore / jobAfter : 0.0, 0, 'f', 2)
+             .arg(jobPool.size());
+}
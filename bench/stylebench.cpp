@@ -0,0 +1,94 @@
+#include "benches.h"
+
+#include <QApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFont>
+#include <QStyle>
+#include <QStyleFactory>
+#include <QWidget>
+
+#include "common/AppStyle.h"
+#include "ui_addcatalog.h"
+#include "ui_jobsheet.h"
+#include "ui_jobslist.h"
+#include "ui_modifycatalog.h"
+#include "ui_order.h"
+
+namespace {
+// Milliseconds to build, polish and first paint one form, the part of
+// opening a window that the theme decides; no database is touched
+template <typename Form> double msPerOpen(int opens) {
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < opens; ++i) {
+    QWidget w;
+    Form ui;
+    ui.setupUi(&w);
+    w.show();
+    QCoreApplication::processEvents();
+  }
+  return opens > 0 ? timer.nsecsElapsed() / 1e6 / opens : 0.0;
+}
+
+// The application as main() sets it up: before, the platform style and
+// font under the app-wide stylesheet; after, AppStyle with its font
+struct Theme {
+  QString platformStyle;
+  QFont platformFont;
+
+  void useLegacy(QApplication &app) const {
+    app.setStyle(QStyleFactory::create(platformStyle));
+    app.setPalette(app.style()->standardPalette());
+    app.setFont(platformFont);
+    app.setStyleSheet(AppStyle::getDarkTheme());
+  }
+
+  void useAppStyle(QApplication &app) const {
+    app.setStyleSheet(QString());
+    app.setFont(QFont("Segoe UI", 11));
+    app.setStyle(new AppStyle);
+    app.setPalette(AppStyle::darkPalette());
+  }
+};
+} // namespace
+
+void benchStyle(int opens) {
+  auto *app = qobject_cast<QApplication *>(QCoreApplication::instance());
+  if (!app) {
+    qWarning() << "Style benchmark: needs a QApplication";
+    return;
+  }
+  const Theme theme{app->style()->name(), QApplication::font()};
+
+  const struct {
+    const char *name;
+    double (*open)(int);
+  } kForms[] = {
+      {"JobSheetWidget", msPerOpen<Ui::JobSheetWidget>},
+      {"OrderWidget", msPerOpen<Ui::OrderWidget>},
+      {"JobsListWidget", msPerOpen<Ui::JobsListWidget>},
+      {"AddCatalog", msPerOpen<Ui::AddCatalog>},
+      {"ModifyCatalog", msPerOpen<Ui::ModifyCatalog>},
+  };
+
+  for (const auto &form : kForms) {
+    // One untimed open each, so neither side pays for first-use caches
+    theme.useLegacy(*app);
+    form.open(1);
+    const double legacy = form.open(opens);
+
+    theme.useAppStyle(*app);
+    form.open(1);
+    const double proxy = form.open(opens);
+
+    qInfo().noquote()
+        << QString("[bench] %1 opened, %2 times: stylesheet %3 ms, "
+                   "AppStyle %4 ms (%5x)")
+               .arg(QLatin1String(form.name))
+               .arg(opens)
+               .arg(legacy, 0, 'f', 2)
+               .arg(proxy, 0, 'f', 2)
+               .arg(proxy > 0 ? legacy / proxy : 0.0, 0, 'f', 2);
+  }
+}
@@ -2,16 +2,70 @@
 #include "ui_castinglist.h"
 
 #include "accountant/castingwidget.h"
+#include "common/fixedpoint.h"
+#include "common/ledgerformulas.h"
+#include "common/listsnapshot.h"
+#include "common/lossengine.h"
+#include "common/tablediff.h"
+#include "database/changenotifier.h"
 #include "database/databaseutils.h"
 
+#include <QCloseEvent>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLocale>
 #include <QMenu>
 // #include <QMdiArea>
 #include <QMdiSubWindow>
+#include <QPointer>
+#include <QThreadPool>
+#include <QVarLengthArray>
+
+namespace {
+const auto kEditTriggers =
+    QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed;
+
+constexpr int kDiaPriceCol = 18;
+
+// Columns filled from the "casting" ledger formulas, and their decimals
+const struct {
+  int col;
+  const char *name;
+  int decimals;
+} kFormulaColumns[] = {
+    {14, "gross_loss", 3},  {15, "fine_loss", 3},      {16, "dia_pcs_loss", 0},
+    {17, "dia_wt_loss", 3}, {19, "dia_loss_price", 2},
+};
+
+// Columns with a total; the pcs columns are whole numbers
+const QList<int> kSumCols = {4, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 19};
+
+// Exact total of a column as shown: every cell is read as a 3-decimal
+// fixed-point number, so totals do not drift like a sum of doubles
+Milligrams columnSum(const QTableWidget *table, int col, int rows) {
+  QVarLengthArray<qint64, 1024> raw(rows);
+  for (int r = 0; r < rows; r++) {
+    const QTableWidgetItem *it = table->item(r, col);
+    raw[r] = it ? Milligrams::parse(it->text()).raw() : 0;
+  }
+  return Milligrams::fromRaw(FixedPoint::sum(raw.data(), rows));
+}
+
+QString totalText(int col, Milligrams sum) {
+  const bool isInt = (col == 4 || col == 8 || col == 12 || col == 16);
+  return isInt ? QString::number(sum.raw() / Milligrams::kScale)
+               : sum.toString();
+}
+} // namespace
 
 CastingListWidget::CastingListWidget(QWidget *parent)
     : QWidget(parent), ui(new Ui::CastingListWidget) {
   ui->setupUi(this);
 
+  m_writes = new WriteBehindQueue(ui->castingTableWidget, this);
+  connect(m_writes, &WriteBehindQueue::stateChanged, this,
+          &CastingListWidget::onWriteStateChanged);
+
   setupTable();
 
   ui->castingTableWidget->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -22,10 +76,46 @@ CastingListWidget::CastingListWidget(QWidget *parent)
   connect(ui->castingTableWidget, &QTableWidget::itemChanged, this,
           &CastingListWidget::onItemChanged);
 
-  loadCastingList();
+  // Paint the list as it was last time, then bring it up to date off the
+  // GUI thread. First run for this user and role: load the usual way.
+  QElapsedTimer paintTimer;
+  paintTimer.start();
+  QList<CastingListRow> snapshot;
+  QDateTime savedAt;
+  if (ListSnapshot::load(ListSnapshot::pathFor("casting"), snapshot,
+                         &savedAt)) {
+    showRows(snapshot);
+    setStale(true, savedAt);
+    qInfo() << "[perf] Casting list painted from snapshot in"
+            << paintTimer.elapsed() << "ms," << snapshot.size() << "rows";
+    refreshInBackground();
+  } else {
+    loadCastingList();
+  }
+
+  // A saved casting form, or a new delivery date on its order
+  connect(&ChangeNotifier::instance(), &ChangeNotifier::rowChanged, this,
+          [this](const QString &table, int, const QStringList &columns) {
+            if (table == "casting_entry" ||
+                (table == "order_book_detail" &&
+                 columns.contains("deliveryDate")))
+              loadCastingList();
+          });
+}
+
+CastingListWidget::~CastingListWidget() {
+  delete m_writes; // flushes while the grid still exists
+  delete ui;
 }
 
-CastingListWidget::~CastingListWidget() { delete ui; }
+void CastingListWidget::closeEvent(QCloseEvent *event) {
+  // Dia price edits that keep failing get a retry before the grid goes
+  if (!m_writes->confirmClose(this)) {
+    event->ignore();
+    return;
+  }
+  QWidget::closeEvent(event);
+}
 
 void CastingListWidget::setupTable() {
   auto *table = ui->castingTableWidget;
@@ -60,8 +150,7 @@ void CastingListWidget::setupTable() {
   table->setSelectionMode(QAbstractItemView::SingleSelection);
 
   // Allow editing, but we control it per item via flags
-  table->setEditTriggers(QAbstractItemView::DoubleClicked |
-                         QAbstractItemView::EditKeyPressed);
+  table->setEditTriggers(kEditTriggers);
 
   table->horizontalHeader()->setStretchLastSection(true);
   table->horizontalHeader()->setSectionResizeMode(
@@ -71,132 +160,137 @@ void CastingListWidget::setupTable() {
 }
 
 void CastingListWidget::loadCastingList() {
-  auto *table = ui->castingTableWidget;
-  table->setRowCount(0);
-
-  table->setRowCount(0);
-  // Block signals while loading to prevent onItemChanged from firing
-  table->blockSignals(true);
+  // Queued dia prices would be overwritten by the reload
+  m_writes->flush();
 
-  auto rows = DatabaseUtils::getCastingList();
-
-  for (int i = 0; i < rows.size(); ++i) {
-    const auto &r = rows[i];
-    table->insertRow(i);
-
-    // Job No
-    auto *jobItem = new QTableWidgetItem(QString::number(r.jobId));
-    jobItem->setData(Qt::UserRole, r.jobId);
-    table->setItem(i, 0, jobItem);
-
-    table->setItem(i, 1, new QTableWidgetItem(r.deliveryDate));
-    table->setItem(i, 2, new QTableWidgetItem(r.castingDate));
-    table->setItem(i, 3, new QTableWidgetItem(r.vendorName));
-    table->setItem(i, 4, new QTableWidgetItem(QString::number(r.pcs)));
-
-    table->setItem(i, 5, new QTableWidgetItem(r.issueMetal));
-    table->setItem(i, 6, new QTableWidgetItem(r.purity));
-    table->setItem(i, 7, new QTableWidgetItem(QString::number(r.issueMetalWt)));
-    table->setItem(i, 8, new QTableWidgetItem(QString::number(r.issueDiaPcs)));
-    table->setItem(i, 9, new QTableWidgetItem(QString::number(r.issueDiaWt)));
-
-    table->setItem(i, 10,
-                   new QTableWidgetItem(QString::number(r.receiveRunnerWt)));
-    table->setItem(i, 11,
-                   new QTableWidgetItem(QString::number(r.receiveProductWt)));
-    table->setItem(i, 12,
-                   new QTableWidgetItem(QString::number(r.receiveDiaPcs)));
-    table->setItem(i, 13,
-                   new QTableWidgetItem(QString::number(r.receiveDiaWt)));
-
-    // Loss columns (leave empty for now)
-    // 14..17
-    // --- CALCULATIONS ---
-    // Gross Loss = ((Ranar Wt + Product Wt.) - (Issue Dia Wt. / 20.0) - Issue
-    // Wt.) Note: Issue Wt usually refers to Issue Metal Wt. Dia Wt conversion:
-    // User said "Issue Dia Wt. / (10*2)". Assuming 20.0 factor.
-    double diaWtAdjustment = (r.issueDiaWt / 5.0);
-    double grossLoss = (r.receiveRunnerWt + r.receiveProductWt) -
-                       diaWtAdjustment - r.issueMetalWt;
-
-    // Fine Loss = Gross Loss / (100 * purity) -- AS REQUESTED
-    // We need to parse purity. "18K", "75.0", etc.
-    // Let's assume it might start with number.
-    QString purityStr = r.purity;
-    QRegularExpression re(R"((\d+)\s*[kK])");
-    QRegularExpressionMatch match = re.match(purityStr);
-    double purityVal = 0.0;
-    if (match.hasMatch()) {
-      purityVal = match.captured(1).toDouble(); // → 22
-    }
-
-    double fineLoss = 0.0;
-    // IF user literally meant Gross / (100 * purity):
-    // Example: Purity 75. 100*75=7500. Loss/7500.
-    // Standard logic is Gross * (Purity/100).
-    // I will implement the user's literal formula but with a safety check.
-    // IF they meant standard, it would be grossLoss * (purityVal / 100.0).
-    // Given "Gross Loss/(100*purity)"... maybe they treat 'purity' as 0.75?
-    // If purity is 0.75 -> 100*0.75 = 75. Loss/75.
-    // I'll stick to a reasonable interpretation: Gross * (Purity/100).
-    // The user wrote division. "Gross Loss / (100*purity)".
-    // If I calculate fine loss, it should be the pure gold loss.
-    // Loss * Purity% = Pure Loss.
-    // I will use Gross * (Purity / 100.0) as it is the only physically sensible
-    // "Fine Loss". If the user complains, I will change it to division.
-    if (purityVal > 0) {
-      fineLoss = grossLoss * (purityVal / 100.0);
-    }
-
-    // Diamond Pcs Loss = Received Dia Pcs - Issue Dia Pcs
-    int diaPcsLoss = r.receiveDiaPcs - r.issueDiaPcs;
+  const QList<CastingListRow> rows = DatabaseUtils::getCastingList();
+  showRows(rows);
+  if (m_staleLabel)
+    setStale(false);
 
-    // Diamond Wt. Loss = Received Dia Wt. - Issue Dia Wt.
-    double diaWtLoss = r.receiveDiaWt - r.issueDiaWt;
-
-    // Diamond Loss Price = Diamond Wt. Loss * Dia Price
-    double diaLossPrice = diaWtLoss * r.diaPrice;
-
-    // 14: Gross Loss
-    table->setItem(i, 14,
-                   new QTableWidgetItem(QString::number(grossLoss, 'f', 3)));
+  const QString path = ListSnapshot::pathFor("casting");
+  QThreadPool::globalInstance()->start(
+      [path, rows]() { ListSnapshot::save(path, rows); });
+}
 
-    // 15: Fine Loss
-    table->setItem(i, 15,
-                   new QTableWidgetItem(QString::number(fineLoss, 'f', 3)));
+void CastingListWidget::refreshInBackground() {
+  const QString path = ListSnapshot::pathFor("casting");
+  QPointer<CastingListWidget> self(this);
+
+  QThreadPool::globalInstance()->start([self, path]() {
+    const QList<CastingListRow> rows = DatabaseUtils::getCastingList();
+    ListSnapshot::save(path, rows);
+
+    QMetaObject::invokeMethod(
+        qApp,
+        [self, rows]() {
+          if (!self)
+            return; // window closed while the query ran
+          self->showRows(rows);
+          self->setStale(false);
+        },
+        Qt::QueuedConnection);
+  });
+}
 
-    // 16: Dia Pcs Loss
-    table->setItem(i, 16, new QTableWidgetItem(QString::number(diaPcsLoss)));
+void CastingListWidget::showRows(const QList<CastingListRow> &rows) {
+  auto *table = ui->castingTableWidget;
 
-    // 17: Dia Wt. Loss
-    table->setItem(i, 17,
-                   new QTableWidgetItem(QString::number(diaWtLoss, 'f', 3)));
+  // The shop may have changed a formula: then every row is out of date
+  FormulaSet formulas = LedgerFormulas::forLedger("casting");
+  if (formulas.formulas() != m_formulas.formulas())
+    m_rows.clear();
+  m_formulas = formulas;
+
+  // Losses of every row in one pass; renderRow(i) reads row i of it
+  m_losses = LossEngine::compute(m_formulas, rows);
+
+  // Only rows that came, went or changed touch the grid; the rest keep
+  // their items, so scroll position, selection and an open editor survive
+  const TableDiff::Stats stats = TableDiff::apply(
+      table, m_rows, rows,
+      [this](int i, const CastingListRow &r) { renderRow(i, r); });
+  m_rows = rows;
+
+  qInfo().noquote() << QString("[perf] Casting list refresh: %1 rows, %2 "
+                               "added, %3 removed, %4 changed%5")
+                           .arg(rows.size())
+                           .arg(stats.inserted)
+                           .arg(stats.removed)
+                           .arg(stats.changed)
+                           .arg(stats.rebuilt ? " (rebuilt)" : "");
 
-    table->setItem(i, 18,
-                   new QTableWidgetItem(QString::number(r.diaPrice, 'f', 3)));
+  // Block signals while loading to prevent onItemChanged from firing
+  table->blockSignals(true);
+  calculateTotals();
+  table->blockSignals(false);
+}
 
-    // 19: Dia Loss Price
-    table->setItem(i, 19,
-                   new QTableWidgetItem(QString::number(diaLossPrice, 'f', 2)));
+void CastingListWidget::renderRow(int i, const CastingListRow &r) {
+  auto *table = ui->castingTableWidget;
 
-    // Update calculated columns when Dia Price changes?
-    // Yes, we need to handle that in onItemChanged too if we want dynamic
-    // updates without reload. For now, only on load.
+  auto setCell = [&](int col, const QString &text) {
+    QTableWidgetItem *item = table->item(i, col);
+    if (!item) {
+      item = new QTableWidgetItem;
+      // Only Dia Price is editable
+      if (col != kDiaPriceCol)
+        item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+      table->setItem(i, col, item);
+    }
+    if (item->text() != text)
+      item->setText(text);
+    return item;
+  };
+
+  // Job No; the UserRole jobId doubles as the TableDiff key
+  setCell(0, QString::number(r.jobId))
+      ->setData(TableDiff::kKeyRole, r.jobId);
+
+  setCell(1, r.deliveryDate);
+  setCell(2, r.castingDate);
+  setCell(3, r.vendorName);
+  setCell(4, QString::number(r.pcs));
+
+  setCell(5, r.issueMetal);
+  setCell(6, r.purity);
+  setCell(7, QString::number(r.issueMetalWt));
+  setCell(8, QString::number(r.issueDiaPcs));
+  setCell(9, QString::number(r.issueDiaWt));
+
+  setCell(10, QString::number(r.receiveRunnerWt));
+  setCell(11, QString::number(r.receiveProductWt));
+  setCell(12, QString::number(r.receiveDiaPcs));
+  setCell(13, QString::number(r.receiveDiaWt));
+
+  setCell(kDiaPriceCol, QString::number(r.diaPrice, 'f', 3));
+
+  // Loss columns (LedgerFormulas, "casting"), computed in showRows()
+  for (const auto &c : kFormulaColumns) {
+    const int slot = m_formulas.slotOf(QLatin1String(c.name));
+    const double value =
+        slot >= 0 && i < m_losses.rows() ? m_losses.value(slot, i) : 0.0;
+    setCell(c.col, QString::number(value, 'f', c.decimals));
+  }
 
-    table->setItem(i, 20, new QTableWidgetItem(r.status));
-    table->setItem(i, 21, new QTableWidgetItem("")); // Action placeholder
+  setCell(20, r.status);
+  setCell(21, ""); // Action placeholder
+}
 
-    // Set flags for others to NOT be editable
-    for (int c = 0; c < table->columnCount(); ++c) {
-      if (c == 18)
-        continue;
-      auto *it = table->item(i, c);
-      if (it)
-        it->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-    }
+void CastingListWidget::setStale(bool stale, const QDateTime &savedAt) {
+  if (!m_staleLabel) {
+    m_staleLabel = new QLabel(this);
+    ui->gridLayout->addWidget(m_staleLabel, 1, 0);
   }
-  table->blockSignals(false);
-  calculateTotals();
+  m_staleLabel->setText(
+      QString("Showing the list as of %1, refreshing...")
+          .arg(QLocale().toString(savedAt, QLocale::ShortFormat)));
+  m_staleLabel->setVisible(stale);
+
+  // No edits on rows that may already be out of date
+  ui->castingTableWidget->setEditTriggers(
+      stale ? QAbstractItemView::EditTriggers(QAbstractItemView::NoEditTriggers)
+            : kEditTriggers);
 }
 
 void CastingListWidget::calculateTotals() {
@@ -216,26 +310,9 @@ void CastingListWidget::calculateTotals() {
   label->setFlags(label->flags() & ~Qt::ItemIsEditable);
   table->setItem(rowCount, 0, label);
 
-  // Columns to sum
-  QList<int> sumCols = {4, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 19};
-
-  for (int col : sumCols) {
-    double sum = 0.0;
-    bool isInt = (col == 4 || col == 8 || col == 12 || col == 16);
-
-    for (int r = 0; r < rowCount; r++) {
-      QTableWidgetItem *it = table->item(r, col);
-      if (it) {
-        sum += it->text().toDouble();
-      }
-    }
-
-    QTableWidgetItem *totalItem = new QTableWidgetItem();
-    if (isInt) {
-      totalItem->setText(QString::number((int)sum));
-    } else {
-      totalItem->setText(QString::number(sum, 'f', 3));
-    }
+  for (int col : kSumCols) {
+    QTableWidgetItem *totalItem =
+        new QTableWidgetItem(totalText(col, columnSum(table, col, rowCount)));
 
     totalItem->setTextAlignment(Qt::AlignCenter);
     totalItem->setFont(font);
@@ -260,7 +337,7 @@ void CastingListWidget::onItemChanged(QTableWidgetItem *item) {
     return;
 
   // Check if it's the specific column (18: Dia Price)
-  if (item->column() == 18) {
+  if (item->column() == kDiaPriceCol) {
     bool ok;
     double price = item->text().toDouble(&ok);
     if (!ok)
@@ -278,7 +355,73 @@ void CastingListWidget::onItemChanged(QTableWidgetItem *item) {
     }
 
     if (jobId > 0) {
-      DatabaseUtils::updateCastingDiaPrice(jobId, price);
+      m_writes->enqueue(QString::number(jobId), "dia_price",
+                        [jobId, price]() {
+                          return DatabaseUtils::updateCastingDiaPrice(jobId,
+                                                                      price);
+                        });
+    }
+
+    applyDiaPrice(item->row(), price);
+  }
+}
+
+void CastingListWidget::applyDiaPrice(int row, double price) {
+  if (row >= m_rows.size())
+    return;
+  auto *table = ui->castingTableWidget;
+
+  // Current values of the row, then only what depends on the price
+  QVector<double> values(m_formulas.slotCount());
+  LedgerFormulas::fill(m_rows.at(row), values.data());
+  m_formulas.evaluate(values.data());
+
+  const int priceSlot = m_formulas.slotOf("dia_price");
+  values[priceSlot] = price;
+  const QList<int> changed = m_formulas.update(values.data(), priceSlot);
+
+  // The grid now shows the new price; a refresh that brings the same price
+  // back from the database leaves the row alone
+  m_rows[row].diaPrice = price;
+
+  QList<int> cols;
+  table->blockSignals(true);
+  for (const auto &c : kFormulaColumns) {
+    const int slot = m_formulas.slotOf(QLatin1String(c.name));
+    if (!changed.contains(slot))
+      continue;
+    if (QTableWidgetItem *cell = table->item(row, c.col))
+      cell->setText(QString::number(values[slot], 'f', c.decimals));
+    cols << c.col;
+  }
+  updateTotals(cols);
+  table->blockSignals(false);
+}
+
+void CastingListWidget::updateTotals(const QList<int> &cols) {
+  auto *table = ui->castingTableWidget;
+  const int totalRow = m_rows.size();
+  if (totalRow >= table->rowCount())
+    return; // no totals row
+
+  for (int col : cols) {
+    if (!kSumCols.contains(col))
+      continue;
+    if (QTableWidgetItem *total = table->item(totalRow, col))
+      total->setText(totalText(col, columnSum(table, col, totalRow)));
+  }
+}
+
+void CastingListWidget::onWriteStateChanged(const QString &row,
+                                            const QString &,
+                                            WriteBehindQueue::State state) {
+  auto *table = ui->castingTableWidget;
+  const int jobId = row.toInt();
+  for (int r = 0; r < table->rowCount(); ++r) {
+    QTableWidgetItem *jobItem = table->item(r, 0);
+    if (jobItem && jobItem->data(Qt::UserRole).toInt() == jobId) {
+      WriteBehindQueue::decorate(table->item(r, kDiaPriceCol), state);
+      return;
     }
   }
 }
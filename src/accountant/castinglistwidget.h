@@ -1,10 +1,16 @@
 #ifndef CASTINGLISTWIDGET_H
 #define CASTINGLISTWIDGET_H
 
+#include <QDateTime>
+#include <QLabel>
 #include <QMdiArea>
 #include <QTableWidget>
 #include <QWidget>
 
+#include "common/formulaset.h"
+#include "common/lossengine.h"
+#include "common/writebehindqueue.h"
+#include "models/CastingListRow.h"
 
 namespace Ui {
 class CastingListWidget;
@@ -17,16 +23,32 @@ public:
   explicit CastingListWidget(QWidget *parent = nullptr);
   ~CastingListWidget();
 
+protected:
+  void closeEvent(QCloseEvent *event) override;
+
 private slots:
   void onTableContextMenu(const QPoint &pos);
   void onItemChanged(QTableWidgetItem *item);
+  void onWriteStateChanged(const QString &row, const QString &field,
+                           WriteBehindQueue::State state);
 
 private:
   Ui::CastingListWidget *ui;
+  WriteBehindQueue *m_writes = nullptr; // dia price edits
+  QLabel *m_staleLabel = nullptr;       // shown while a snapshot is on screen
+  QList<CastingListRow> m_rows;         // rows on screen, above the totals
+  FormulaSet m_formulas;                // loss columns, "casting" ledger
+  LossBatch m_losses;                   // their values for m_rows
 
   void setupTable();
   void loadCastingList();
+  void refreshInBackground();
+  void showRows(const QList<CastingListRow> &rows);
+  void renderRow(int i, const CastingListRow &r);
+  void setStale(bool stale, const QDateTime &savedAt = QDateTime());
   void calculateTotals();
+  void applyDiaPrice(int row, double price);
+  void updateTotals(const QList<int> &cols);
 
   void openCastingWidget(int jobId);
   QMdiArea *findMdiArea(QWidget *w);
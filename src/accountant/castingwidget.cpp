@@ -1,10 +1,12 @@
 #include "castingwidget.h"
 #include "ui_casting.h"
 
+#include "common/dates.h"
 #include "common/sessionmanager.h"
 #include "database/databaseutils.h"
 #include <QMdiSubWindow>
 #include <QMessageBox>
+#include <QPushButton>
 
 
 CastingWidget::CastingWidget(QWidget *parent)
@@ -45,6 +47,7 @@ void CastingWidget::setupMetalComboBoxes() {
 void CastingWidget::setJobId(int jobId)
 {
     m_jobId = jobId;
+    m_hasLoaded = false;
     resetForm();   //  IMPORTANT
 
     QString jobNo = "JOB" + QString("%1").arg(jobId, 7, 10, QChar('0'));
@@ -71,6 +74,10 @@ void CastingWidget::setJobId(int jobId)
         ui->productWtDoubleSpinBox->setValue(c.receiveProductWt);
         ui->diaPcsSpinBox->setValue(c.receiveDiamondPcs);
         ui->diaWtDoubleSpinBox->setValue(c.receiveDiamondWt);
+
+        m_loaded = collectCastingData();
+        m_loaded.rowVersion = c.rowVersion;
+        m_hasLoaded = true;
     } else {
         // Reset or load default if needed (e.g. from Order)
         // For now, keep as is (constructor defaults or empty)
@@ -105,7 +112,7 @@ CastingData CastingWidget::collectCastingData() const {
   c.jobId = m_jobId;
 
   // ----- Detail -----
-  c.castingDate = ui->issueDateEdit->date().toString("yyyy-MM-dd");
+  c.castingDate = Dates::toStored(ui->issueDateEdit->date());
   c.castingName = ui->nameLineEdit->text().trimmed();
   c.pcs = ui->pcsSpinBox->value();
 
@@ -140,7 +147,44 @@ void CastingWidget::on_savePushButton_clicked() {
   int castingId = DatabaseUtils::getCastingIdByJob(m_jobId);
 
   bool ok = false;
-  if (castingId > 0) {
+  if (castingId > 0 && m_hasLoaded) {
+    using CasResult = DatabaseUtils::CasResult;
+    CasResult result =
+        DatabaseUtils::updateCastingChanges(castingId, m_loaded, data);
+
+    if (result == CasResult::Conflict) {
+      QMessageBox box(QMessageBox::Warning, "Casting Changed",
+                      "Someone else saved this casting after you opened it.\n"
+                      "Reload to see their version, or save your changes on "
+                      "top of it (only the fields you edited are written).",
+                      QMessageBox::Cancel, this);
+      QPushButton *reload = box.addButton("Reload", QMessageBox::RejectRole);
+      QPushButton *mine = box.addButton("Save mine", QMessageBox::AcceptRole);
+      box.exec();
+
+      if (box.clickedButton() == reload) {
+        setJobId(m_jobId);
+        return;
+      }
+      if (box.clickedButton() != mine)
+        return;
+
+      CastingData latest;
+      if (!DatabaseUtils::getCastingDataByJob(m_jobId, latest)) {
+        QMessageBox::critical(this, "Error", "Failed to load casting");
+        return;
+      }
+      m_loaded.rowVersion = latest.rowVersion;
+      result = DatabaseUtils::updateCastingChanges(castingId, m_loaded, data);
+      if (result == CasResult::Conflict) {
+        QMessageBox::warning(this, "Casting Changed",
+                             "The casting changed again while saving. "
+                             "Please reload and try again.");
+        return;
+      }
+    }
+    ok = result == CasResult::Saved;
+  } else if (castingId > 0) {
     ok = DatabaseUtils::updateCasting(castingId, data);
   } else {
     ok = DatabaseUtils::insertCasting(data);
@@ -150,6 +194,10 @@ void CastingWidget::on_savePushButton_clicked() {
     QMessageBox::critical(this, "Error", "Failed to save casting");
     return;
   }
+  if (castingId > 0) {
+    m_loaded = data;
+    m_hasLoaded = true;
+  }
 
   QMessageBox::information(this, "Success", "Casting saved successfully");
 
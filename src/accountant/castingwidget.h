@@ -29,6 +29,11 @@ private:
     int m_jobId = 0;
     CastingData collectCastingData() const;
 
+    // Form state right after an existing casting was loaded; an update
+    // writes only the fields that differ from it
+    CastingData m_loaded;
+    bool m_hasLoaded = false;
+
     void resetForm();
     void setupMetalComboBoxes();
 };
@@ -1,4 +1,5 @@
 #include "metalpurchasedialog.h"
+#include "common/dates.h"
 #include <QLabel>
 #include <QMessageBox>
 #include <QVBoxLayout>
@@ -123,7 +124,7 @@ void MetalPurchaseDialog::save() {
   }
 
   MetalPurchaseData d;
-  d.entryDate = dateEdit->text();
+  d.entryDate = Dates::toStored(dateEdit->date());
   d.billNo = txtBillNo->text();
   d.partyName = txtPartyName->text();
   d.pic = spinPic->value();
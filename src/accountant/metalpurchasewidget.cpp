@@ -1,6 +1,8 @@
 #include "metalpurchasewidget.h"
 #include "metalpurchasedialog.h"
+#include "common/fixedpoint.h"
 #include <QMessageBox>
+#include <QVarLengthArray>
 
 MetalPurchaseWidget::MetalPurchaseWidget(QWidget *parent) : QWidget(parent) {
   setupUi();
@@ -16,6 +18,14 @@ void MetalPurchaseWidget::setupUi() {
   btnAdd->setStyleSheet("background-color: #4CAF50; color: white; padding: 5px "
                         "15px; font-weight: bold;");
 
+  // Month filter, a range scan on the entry_date index
+  monthCheck = new QCheckBox("Month:", this);
+  monthEdit = new QDateEdit(QDate::currentDate(), this);
+  monthEdit->setDisplayFormat("MMM yyyy");
+  monthEdit->setEnabled(false);
+
+  topLayout->addWidget(monthCheck);
+  topLayout->addWidget(monthEdit);
   topLayout->addStretch();
   topLayout->addWidget(btnAdd);
   mainLayout->addLayout(topLayout);
@@ -39,11 +49,23 @@ void MetalPurchaseWidget::setupUi() {
 
   connect(btnAdd, &QPushButton::clicked, this,
           &MetalPurchaseWidget::onAddEntryClicked);
+  connect(monthCheck, &QCheckBox::toggled, this, [this](bool on) {
+    monthEdit->setEnabled(on);
+    loadData();
+  });
+  connect(monthEdit, &QDateEdit::dateChanged, this, [this]() {
+    if (monthCheck->isChecked())
+      loadData();
+  });
 }
 
 void MetalPurchaseWidget::loadData() {
   table->setRowCount(0);
-  QList<MetalPurchaseData> list = DatabaseUtils::getAllMetalPurchases();
+  const QDate month = monthEdit->date();
+  const Dates::Range range = monthCheck->isChecked()
+                                 ? Dates::monthOf(month.year(), month.month())
+                                 : Dates::Range();
+  QList<MetalPurchaseData> list = DatabaseUtils::getAllMetalPurchases(range);
 
   for (const auto &data : list) {
     int row = table->rowCount();
@@ -97,21 +119,21 @@ void MetalPurchaseWidget::calculateTotals() {
   // TotalPayAmount(10)
   QList<int> sumCols = {5, 7, 8, 9, 10};
 
+  // Summed as fixed-point integers (milligrams, paise), exact to the cell
+  QVarLengthArray<qint64, 1024> raw(rowCount);
   for (int col : sumCols) {
-    double sum = 0.0;
-
+    const bool isAmount = (col == 7 || col == 10); // rupees, 2 decimals
     for (int r = 0; r < rowCount; r++) {
-      QTableWidgetItem *it = table->item(r, col);
-      if (it) {
-        sum += it->text().toDouble();
-      }
+      const QTableWidgetItem *it = table->item(r, col);
+      const QString text = it ? it->text() : QString();
+      raw[r] = isAmount ? Paise::parse(text).raw()
+                        : Milligrams::parse(text).raw();
     }
+    const qint64 sum = FixedPoint::sum(raw.data(), rowCount);
 
     QTableWidgetItem *totalItem =
-        new QTableWidgetItem(QString::number(sum, 'f', 3));
-    if (col == 7 || col == 10)
-      totalItem->setText(
-          QString::number(sum, 'f', 2)); // Amounts often 2 decimals
+        new QTableWidgetItem(isAmount ? Paise::fromRaw(sum).toString()
+                                      : Milligrams::fromRaw(sum).toString());
 
     totalItem->setTextAlignment(Qt::AlignCenter);
     totalItem->setFont(font);
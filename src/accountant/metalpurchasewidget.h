@@ -2,6 +2,8 @@
 #define METALPURCHASEWIDGET_H
 
 #include "database/databaseutils.h"
+#include <QCheckBox>
+#include <QDateEdit>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QPushButton>
@@ -22,6 +24,8 @@ private slots:
 private:
   QTableWidget *table;
   QPushButton *btnAdd;
+  QCheckBox *monthCheck;
+  QDateEdit *monthEdit;
   void calculateTotals();
 
   void setupUi();
@@ -1,9 +1,13 @@
 #include "stocklistwidget.h"
+#include "common/fixedpoint.h"
+#include "common/tablediff.h"
 #include "database/databaseutils.h"
 #include "stockwidget.h"
 #include "ui_stocklist.h"
+#include <QDebug>
 #include <QMenu>
 #include <QMessageBox>
+#include <QVarLengthArray>
 
 StockListWidget::StockListWidget(QWidget *parent)
     : QWidget(parent), ui(new Ui::StockListWidget) {
@@ -30,50 +34,55 @@ void StockListWidget::setupTable() {
 }
 
 void StockListWidget::loadData() {
-  ui->tableWidget->setRowCount(0);
-  QList<StockData> list = DatabaseUtils::getAllStocks();
-
-  for (const auto &s : list) {
-    int row = ui->tableWidget->rowCount();
-    ui->tableWidget->insertRow(row);
-
-    ui->tableWidget->insertRow(row);
-
-    QTableWidgetItem *itemDate = new QTableWidgetItem(s.date);
-    itemDate->setData(Qt::UserRole, s.id); // Store ID
-    itemDate->setData(Qt::UserRole + 1, s.purity);
-    itemDate->setData(Qt::UserRole + 2, s.weight);
-    itemDate->setData(Qt::UserRole + 3, s.price);
-    // Could store whole struct pointer but checking ID + reload from UI is
-    // easier or just passing what we have. Actually we need to pass all data to
-    // setStockData. Simplified: Store ID, and when editing, iterate list to
-    // find data matching ID? Or just store important fields in hidden columns?
-    // Better: Helper function to get StockData from row, or just store ID and
-    // use getStockById (need to implement?) Or simpler: We have the list in
-    // loadData scope but not member variable. Let's store necessary data fields
-    // in UserRole of different columns or just rely on text for strings and
-    // UserRole for doubles.
-
-    ui->tableWidget->setItem(row, 0, itemDate);
-    ui->tableWidget->setItem(row, 1, new QTableWidgetItem(s.metal));
-    ui->tableWidget->setItem(row, 2, new QTableWidgetItem(s.detail));
-    ui->tableWidget->setItem(row, 3, new QTableWidgetItem(s.note));
-    ui->tableWidget->setItem(row, 4, new QTableWidgetItem(s.voucherNo));
-    ui->tableWidget->setItem(
-        row, 5, new QTableWidgetItem(QString::number(s.purity, 'f', 3)));
-    ui->tableWidget->setItem(
-        row, 6, new QTableWidgetItem(QString::number(s.weight, 'f', 3)));
-    ui->tableWidget->setItem(
-        row, 7, new QTableWidgetItem(QString::number(s.weight24k, 'f', 3)));
-    ui->tableWidget->setItem(
-        row, 8, new QTableWidgetItem(QString::number(s.price, 'f', 2)));
-    ui->tableWidget->setItem(
-        row, 9, new QTableWidgetItem(QString::number(s.amount, 'f', 2)));
-  }
+  const QList<StockData> list = DatabaseUtils::getAllStocks();
+
+  // Only rows that came, went or changed touch the grid; the rest keep
+  // their items, so scroll position and selection survive a refresh
+  const TableDiff::Stats stats = TableDiff::apply(
+      ui->tableWidget, m_rows, list,
+      [this](int row, const StockData &s) { renderRow(row, s); });
+  m_rows = list;
+
+  qInfo().noquote() << QString("[perf] Stock list refresh: %1 rows, %2 added, "
+                               "%3 removed, %4 changed%5")
+                           .arg(list.size())
+                           .arg(stats.inserted)
+                           .arg(stats.removed)
+                           .arg(stats.changed)
+                           .arg(stats.rebuilt ? " (rebuilt)" : "");
 
   calculateTotals();
 }
 
+void StockListWidget::renderRow(int row, const StockData &s) {
+  auto setCell = [&](int col, const QString &text) {
+    QTableWidgetItem *item = ui->tableWidget->item(row, col);
+    if (!item) {
+      item = new QTableWidgetItem;
+      ui->tableWidget->setItem(row, col, item);
+    }
+    if (item->text() != text)
+      item->setText(text);
+    return item;
+  };
+
+  QTableWidgetItem *itemDate = setCell(0, s.date);
+  itemDate->setData(TableDiff::kKeyRole, s.id); // Store ID
+  itemDate->setData(Qt::UserRole + 1, s.purity);
+  itemDate->setData(Qt::UserRole + 2, s.weight);
+  itemDate->setData(Qt::UserRole + 3, s.price);
+
+  setCell(1, s.metal);
+  setCell(2, s.detail);
+  setCell(3, s.note);
+  setCell(4, s.voucherNo);
+  setCell(5, QString::number(s.purity, 'f', 3));
+  setCell(6, QString::number(s.weight, 'f', 3));
+  setCell(7, QString::number(s.weight24k, 'f', 3));
+  setCell(8, QString::number(s.price, 'f', 2));
+  setCell(9, QString::number(s.amount, 'f', 2));
+}
+
 void StockListWidget::calculateTotals() {
   int rowCount = ui->tableWidget->rowCount();
   if (rowCount == 0)
@@ -93,21 +102,21 @@ void StockListWidget::calculateTotals() {
   // Columns to sum: Weight(6), 24K(7), Amount(9)
   QList<int> sumCols = {6, 7, 9};
 
+  // Summed as fixed-point integers (milligrams, paise), exact to the cell
+  QVarLengthArray<qint64, 1024> raw(rowCount);
   for (int col : sumCols) {
-    double sum = 0.0;
-
+    const bool isAmount = (col == 9); // Amount is in rupees, 2 decimals
     for (int r = 0; r < rowCount; r++) {
-      QTableWidgetItem *it = ui->tableWidget->item(r, col);
-      if (it) {
-        sum += it->text().toDouble();
-      }
+      const QTableWidgetItem *it = ui->tableWidget->item(r, col);
+      const QString text = it ? it->text() : QString();
+      raw[r] = isAmount ? Paise::parse(text).raw()
+                        : Milligrams::parse(text).raw();
     }
+    const qint64 sum = FixedPoint::sum(raw.data(), rowCount);
 
     QTableWidgetItem *totalItem =
-        new QTableWidgetItem(QString::number(sum, 'f', 3));
-    if (col == 9)
-      totalItem->setText(
-          QString::number(sum, 'f', 2)); // Amount usually 2 decimals
+        new QTableWidgetItem(isAmount ? Paise::fromRaw(sum).toString()
+                                      : Milligrams::fromRaw(sum).toString());
 
     totalItem->setTextAlignment(Qt::AlignCenter);
     totalItem->setFont(font);
@@ -3,6 +3,8 @@
 
 #include <QWidget>
 
+#include "database/databaseutils.h"
+
 namespace Ui {
 class StockListWidget;
 }
@@ -23,7 +25,9 @@ private slots:
 
 private:
   Ui::StockListWidget *ui;
+  QList<StockData> m_rows; // rows on screen, above the totals
   void setupTable();
+  void renderRow(int row, const StockData &s);
   void calculateTotals();
 };
 
@@ -1,4 +1,6 @@
 #include "stockwidget.h"
+#include "common/dates.h"
+#include "common/purity.h"
 #include "database/databaseutils.h"
 #include "ui_stock.h"
 #include <QDate>
@@ -25,18 +27,9 @@ void StockWidget::calculateValues() {
   double weight = ui->spinWeight->value();
   double price = ui->spinPrice->value();
 
-  // Assumption: Purity is percentage (e.g. 99.50)
-  // 24K = Weight * (Purity / 100.0)
-  // User might enter 0.995, but usually UI spinbox steps suggest % or direct
-  // scale. If user enters 99.50, then /100. If 0.995, then *1. Let's assume %
-  // for now as it's common in India/Gold trade (e.g. 91.6)
-
-  double w24k = 0.0;
-  if (purity > 1.0) {
-    w24k = weight * (purity / 100.0);
-  } else {
-    w24k = weight * purity;
-  }
+  // Purity is normally a percentage (91.6); a fraction (0.916) is accepted
+  // as well. 24K = Weight * Purity
+  const double w24k = Purity::fromNumber(purity).toFine(weight);
 
   // Amount calculation based on 24K weight as per user request
   // Formula: Amount = 24K * Price
@@ -48,7 +41,7 @@ void StockWidget::calculateValues() {
 
 void StockWidget::setStockData(const StockData &data) {
   m_stockId = data.id;
-  ui->dateEdit->setDate(QDate::fromString(data.date, "yyyy-MM-dd"));
+  ui->dateEdit->setDate(QDate::fromString(data.date, Dates::kDateFormat));
   ui->comboMetal->setCurrentText(data.metal);
   ui->leDetail->setText(data.detail);
   ui->leNote->setText(data.note);
@@ -69,7 +62,7 @@ void StockWidget::on_btnSave_clicked() {
   }
 
   StockData data;
-  data.date = ui->dateEdit->text();
+  data.date = Dates::toStored(ui->dateEdit->date());
   data.metal = ui->comboMetal->currentText();
   data.detail = ui->leDetail->text();
   data.note = ui->leNote->text();
@@ -4,7 +4,10 @@
 #include "database/UserRepository.h"
 #include "common/SessionManager.h"
 #include "admin/changepassworddialog.h"
+#include "common/tablediff.h"
 
+#include <QCloseEvent>
+#include <QDebug>
 #include <QHeaderView>
 #include <QPushButton>
 #include <QMessageBox>
@@ -22,6 +25,10 @@ ViewUsersWidget::ViewUsersWidget(QWidget *parent)
         return;
     }
 
+    m_writes = new WriteBehindQueue(ui->usersTableWidget, this);
+    connect(m_writes, &WriteBehindQueue::stateChanged,
+            this, &ViewUsersWidget::onWriteStateChanged);
+
     setupTable();
 
     connect(ui->refreshButton, &QPushButton::clicked,
@@ -36,8 +43,20 @@ ViewUsersWidget::ViewUsersWidget(QWidget *parent)
 
 ViewUsersWidget::~ViewUsersWidget()
 {
+    delete m_writes; // flushes while the grid still exists
     delete ui;
 }
+
+void ViewUsersWidget::closeEvent(QCloseEvent *event)
+{
+    // Payment edits that keep failing get a retry before the grid goes
+    if (!m_writes->confirmClose(this)) {
+        event->ignore();
+        return;
+    }
+    QWidget::closeEvent(event);
+}
+
 void ViewUsersWidget::setupTable()
 {
     QStringList headers = {
@@ -69,47 +88,36 @@ void ViewUsersWidget::setupTable()
 
 void ViewUsersWidget::loadUsers()
 {
+    // Queued payments would be overwritten by the reload
+    m_writes->flush();
+
     int month = ui->monthComboBox->currentIndex() + 1;
     int year = ui->yearComboBox->currentText().toInt();
 
-    auto users = UserRepository::getUsersWithPayments(month, year);
-
-    ui->usersTableWidget->setRowCount(users.size());
+    const QList<UserPaymentView> users =
+        UserRepository::getUsersWithPayments(month, year);
+
+    // Only rows that came, went or changed touch the grid; the rest keep
+    // their items, so scroll position and selection survive a refresh.
+    // Signals stay blocked, so filling cells queues no payment writes.
+    const TableDiff::Stats stats = TableDiff::apply(
+        ui->usersTableWidget, m_rows, users,
+        [this](int row, const UserPaymentView &u) { renderRow(row, u); });
+    m_rows = users;
+
+    qInfo().noquote() << QString("[perf] Users list refresh: %1 rows, %2 added, "
+                                 "%3 removed, %4 changed%5")
+                             .arg(users.size())
+                             .arg(stats.inserted)
+                             .arg(stats.removed)
+                             .arg(stats.changed)
+                             .arg(stats.rebuilt ? " (rebuilt)" : "");
 
     double totalSalary = 0;
     double totalPaid = 0;
     double totalPending = 0;
 
-    for (int row = 0; row < users.size(); ++row) {
-        const auto &u = users[row];
-
-        auto setItem = [&](int col, const QString &text, bool editable) {
-            QTableWidgetItem *item = new QTableWidgetItem(text);
-            item->setFlags(editable
-                               ? item->flags() | Qt::ItemIsEditable
-                               : item->flags() & ~Qt::ItemIsEditable);
-            ui->usersTableWidget->setItem(row, col, item);
-        };
-
-        setItem(0, u.username, false);
-        setItem(1, u.fullName, false);
-        setItem(2, u.roles, false);
-        setItem(3, QString::number(u.baseSalary, 'f', 2), false);
-        setItem(4, QString::number(u.workedDays), true);
-        setItem(5, QString::number(u.advancePaid, 'f', 2), true);
-        setItem(6, QString::number(u.paidAmount, 'f', 2), true);
-        setItem(7, QString::number(u.totalPaid, 'f', 2), false);
-        setItem(8, QString::number(u.pending, 'f', 2), false);
-
-        QPushButton *btn = new QPushButton("Change");
-        btn->setProperty("userId", u.userId);
-
-        connect(btn, &QPushButton::clicked, this, [=]() {
-            ChangePasswordDialog dlg(u.userId, this);
-            dlg.exec();
-        });
-        ui->usersTableWidget->setCellWidget(row, 9, btn);
-
+    for (const UserPaymentView &u : users) {
         totalSalary += u.baseSalary;
         totalPaid += u.totalPaid;
         totalPending += u.pending;
@@ -126,6 +134,48 @@ void ViewUsersWidget::loadUsers()
 
 }
 
+void ViewUsersWidget::renderRow(int row, const UserPaymentView &u)
+{
+    auto setItem = [&](int col, const QString &text, bool editable) {
+        QTableWidgetItem *item = ui->usersTableWidget->item(row, col);
+        if (!item) {
+            item = new QTableWidgetItem;
+            ui->usersTableWidget->setItem(row, col, item);
+        }
+        if (item->text() != text)
+            item->setText(text);
+        const Qt::ItemFlags flags = editable
+                                        ? item->flags() | Qt::ItemIsEditable
+                                        : item->flags() & ~Qt::ItemIsEditable;
+        if (item->flags() != flags)
+            item->setFlags(flags);
+        return item;
+    };
+
+    setItem(0, u.username, false)->setData(TableDiff::kKeyRole, u.userId);
+    setItem(1, u.fullName, false);
+    setItem(2, u.roles, false);
+    setItem(3, QString::number(u.baseSalary, 'f', 2), false);
+    setItem(4, QString::number(u.workedDays), true);
+    setItem(5, QString::number(u.advancePaid, 'f', 2), true);
+    setItem(6, QString::number(u.paidAmount, 'f', 2), true);
+    setItem(7, QString::number(u.totalPaid, 'f', 2), false);
+    setItem(8, QString::number(u.pending, 'f', 2), false);
+
+    // The key is the user, so a kept row's button already opens the right one
+    if (!ui->usersTableWidget->cellWidget(row, 9)) {
+        QPushButton *btn = new QPushButton("Change");
+        btn->setProperty("userId", u.userId);
+
+        const int userId = u.userId;
+        connect(btn, &QPushButton::clicked, this, [=]() {
+            ChangePasswordDialog dlg(userId, this);
+            dlg.exec();
+        });
+        ui->usersTableWidget->setCellWidget(row, 9, btn);
+    }
+}
+
 void ViewUsersWidget::saveEditedRow(QTableWidgetItem *item)
 {
     int row = item->row();
@@ -172,24 +222,49 @@ void ViewUsersWidget::saveEditedRow(QTableWidgetItem *item)
         ->setText(QString::number(paidThisMonth, 'f', 2));
 
     // -----------------------------
-    // Save to DB
+    // Save to DB (queued; written with the other edits once typing
+    // pauses, inside the queue's transaction)
     // -----------------------------
-    bool ok = UserRepository::updateMonthlyPayment(
-        employeeId,
-        month,
-        year,
-        workedDays,
-        advancePaid,
-        paidThisMonth
-        );
-
-    if (!ok) {
-        QMessageBox::critical(this, "Error",
-                              "Failed to save salary data.");
-        return;
-    }
+    const QString key = QString("%1:%2:%3").arg(username).arg(month).arg(year);
+    m_writes->enqueue(key, "payment", [=]() {
+        return UserRepository::writeMonthlyPayment(
+            employeeId,
+            month,
+            year,
+            workedDays,
+            advancePaid,
+            paidThisMonth
+            );
+    });
 
     // Reload to update totals & pending
     // loadUsers();
 }
 
+void ViewUsersWidget::onWriteStateChanged(const QString &row,
+                                          const QString &,
+                                          WriteBehindQueue::State state)
+{
+    // "username:month:year"; the username itself may contain ':'
+    QStringList parts = row.split(':');
+    if (parts.size() < 3)
+        return;
+    const int rowYear = parts.takeLast().toInt();
+    const int rowMonth = parts.takeLast().toInt();
+    const QString username = parts.join(':');
+
+    // Only the month on screen has cells for it
+    int month = ui->monthComboBox->currentIndex() + 1;
+    int year = ui->yearComboBox->currentText().toInt();
+    if (rowMonth != month || rowYear != year)
+        return;
+
+    for (int r = 0; r < ui->usersTableWidget->rowCount(); ++r) {
+        QTableWidgetItem *name = ui->usersTableWidget->item(r, 0);
+        if (name && name->text() == username) {
+            WriteBehindQueue::decorate(ui->usersTableWidget->item(r, 4), state);
+            WriteBehindQueue::decorate(ui->usersTableWidget->item(r, 5), state);
+            return;
+        }
+    }
+}
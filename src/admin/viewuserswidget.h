@@ -4,6 +4,9 @@
 #include <QWidget>
 #include <QTableWidgetItem>
 
+#include "common/writebehindqueue.h"
+#include "models/UserPaymentView.h"
+
 namespace Ui {
 class ViewUsersWidget;
 }
@@ -16,16 +19,24 @@ public:
     explicit ViewUsersWidget(QWidget *parent = nullptr);
     ~ViewUsersWidget();
 
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
 private slots:
     void loadUsers();
     void saveEditedRow(QTableWidgetItem *item);
+    void onWriteStateChanged(const QString &row, const QString &field,
+                             WriteBehindQueue::State state);
 
 
 private:
     void setupTable();
+    void renderRow(int row, const UserPaymentView &u);
 
 private:
     Ui::ViewUsersWidget *ui;
+    WriteBehindQueue *m_writes = nullptr; // worked days / advance edits
+    QList<UserPaymentView> m_rows;         // rows on screen
 };
 
 #endif
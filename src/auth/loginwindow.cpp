@@ -3,11 +3,8 @@
 
 #include "auth/AuthService.h"
 #include "common/SessionManager.h"
-#include "dashboards/AdminWindow.h"
-#include "dashboards/SellerWindow.h"
-#include "dashboards/accountantwindow.h"
-#include "dashboards/designerwindow.h"
-#include "dashboards/manufacturerwindow.h"
+#include "common/rolewindowfactory.h"
+#include "common/startuppipeline.h"
 
 
 #include <QMessageBox>
@@ -30,34 +27,43 @@ LoginWindow::LoginWindow(QWidget *parent)
   connect(ui->showPasswordCheckBox, &QCheckBox::toggled, this,
           &LoginWindow::onShowPasswordToggled);
   onShowPasswordToggled(false);
+
+  // 🔹 Tables are still being checked in the background; typing can start,
+  // logging in waits for the schema
+  auto &startup = StartupPipeline::instance();
+  if (!startup.isSchemaReady()) {
+    ui->loginButton->setEnabled(false);
+    connect(&startup, &StartupPipeline::schemaReady, this,
+            [this](bool ok) { ui->loginButton->setEnabled(ok); });
+  }
 }
 
 LoginWindow::~LoginWindow() { delete ui; }
 
 void LoginWindow::openDashboardForRole(const QString &role) {
-  if (role == "admin") {
-    auto *w = new AdminWindow();
-    w->show();
-  } else if (role == "seller") {
-    auto *w = new SellerWindow();
-    w->show();
-  } else if (role == "manufacturer") {
-    auto *w = new ManufacturerWindow();
-    w->show();
-  } else if (role == "designer") {
-    auto *w = new DesignerWindow();
-    w->show();
-  } else if (role == "accountant") {
-    auto *w = new AccountantWindow();
-    w->show();
-  } else {
+  // 🔹 Runs on the thread pool while the dashboard is being built
+  StartupPipeline::instance().prefetchForRole(role);
+
+  // 🔹 Through the factory's cache, so later role switches can come back to
+  // this window instead of rebuilding it
+  QWidget *w = RoleWindowFactory::acquire(role);
+  if (!w) {
     QMessageBox::critical(nullptr, "Error", "Unsupported role.");
     SessionManager::clear();
     this->show();
+    return;
   }
+  w->show();
+
+  // 🔹 Build the user's other role windows while this one is in use
+  RoleWindowFactory::prewarm(SessionManager::roles());
 }
 
 void LoginWindow::onLoginClicked() {
+  // Return key in the line edits bypasses the disabled button
+  if (!ui->loginButton->isEnabled())
+    return;
+
   const QString username = ui->usernameLineEdit->text().trimmed();
   const QString password = ui->passwordLineEdit->text();
 
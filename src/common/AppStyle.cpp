@@ -0,0 +1,271 @@
+#include "AppStyle.h"
+
+#include <QAbstractButton>
+#include <QHeaderView>
+#include <QLineEdit>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPushButton>
+#include <QStyleFactory>
+#include <QStyleOption>
+
+namespace {
+// Tailwind-style greys / blues the old stylesheet used
+const QColor kGray900("#111827");
+const QColor kGray800("#1F2937");
+const QColor kGray700("#374151");
+const QColor kGray600("#4B5563");
+const QColor kGray500("#6B7280");
+const QColor kGray400("#9CA3AF");
+const QColor kGray100("#F3F4F6");
+const QColor kGray50("#F9FAFB");
+const QColor kBlue400("#60A5FA");
+const QColor kBlue500("#3B82F6");
+const QColor kBlue600("#2563EB");
+const QColor kBlue700("#1D4ED8");
+
+// Light scheme (catalog screens)
+const QColor kLightWindow("#F9FAFB");
+const QColor kLightText("#2B2B2B");
+const QColor kLightBorder("#C5C6C7");
+const QColor kLightButton("#E7E9EC");
+const QColor kLightHover("#DDE4F2");
+const QColor kLightPressed("#C7D8F0");
+const QColor kLightAccent("#4A90E2");
+
+bool isDark(const QPalette &pal) {
+  return pal.color(QPalette::Window).lightness() < 128;
+}
+
+QPainterPath rounded(const QRectF &r, qreal radius) {
+  QPainterPath path;
+  path.addRoundedRect(r, radius, radius);
+  return path;
+}
+} // namespace
+
+AppStyle::AppStyle() : QProxyStyle(QStyleFactory::create("Fusion")) {}
+
+QPalette AppStyle::darkPalette() {
+  QPalette p;
+  p.setColor(QPalette::Window, kGray900);
+  p.setColor(QPalette::WindowText, kGray50);
+  p.setColor(QPalette::Base, kGray800);
+  p.setColor(QPalette::AlternateBase, kGray700);
+  p.setColor(QPalette::Text, kGray100);
+  p.setColor(QPalette::PlaceholderText, kGray400);
+  p.setColor(QPalette::Button, kGray700);
+  p.setColor(QPalette::ButtonText, Qt::white);
+  p.setColor(QPalette::BrightText, Qt::white);
+  p.setColor(QPalette::Highlight, kBlue500);
+  p.setColor(QPalette::HighlightedText, Qt::white);
+  p.setColor(QPalette::ToolTipBase, kGray800);
+  p.setColor(QPalette::ToolTipText, kGray50);
+  p.setColor(QPalette::Link, kBlue500);
+  p.setColor(QPalette::Light, kGray600);
+  p.setColor(QPalette::Midlight, kGray700);
+  p.setColor(QPalette::Mid, kGray700);
+  p.setColor(QPalette::Dark, kGray900);
+  p.setColor(QPalette::Shadow, Qt::black);
+
+  p.setColor(QPalette::Disabled, QPalette::WindowText, kGray400);
+  p.setColor(QPalette::Disabled, QPalette::Text, kGray400);
+  p.setColor(QPalette::Disabled, QPalette::ButtonText, kGray400);
+  p.setColor(QPalette::Disabled, QPalette::Button, kGray700);
+  return p;
+}
+
+QPalette AppStyle::lightPalette() {
+  QPalette p;
+  p.setColor(QPalette::Window, kLightWindow);
+  p.setColor(QPalette::WindowText, kLightText);
+  p.setColor(QPalette::Base, Qt::white);
+  p.setColor(QPalette::AlternateBase, QColor("#F2F2F2"));
+  p.setColor(QPalette::Text, kLightText);
+  p.setColor(QPalette::Button, kLightButton);
+  p.setColor(QPalette::ButtonText, kLightText);
+  p.setColor(QPalette::Highlight, kLightAccent);
+  p.setColor(QPalette::HighlightedText, Qt::white);
+  p.setColor(QPalette::Light, Qt::white);
+  p.setColor(QPalette::Midlight, kLightButton);
+  p.setColor(QPalette::Mid, kLightBorder);
+  p.setColor(QPalette::Dark, QColor("#A5A5A5"));
+
+  p.setColor(QPalette::Disabled, QPalette::WindowText, kGray500);
+  p.setColor(QPalette::Disabled, QPalette::Text, kGray500);
+  p.setColor(QPalette::Disabled, QPalette::ButtonText, kGray500);
+  return p;
+}
+
+void AppStyle::polish(QPalette &palette) { palette = darkPalette(); }
+
+void AppStyle::polish(QWidget *widget) {
+  QProxyStyle::polish(widget);
+
+  // Fonts only; colours come from the palette so that a widget switching
+  // to lightPalette() is drawn light without further work.
+  if (qobject_cast<QPushButton *>(widget) ||
+      qobject_cast<QHeaderView *>(widget)) {
+    QFont f = widget->font();
+    f.setBold(true);
+    widget->setFont(f);
+  }
+  if (qobject_cast<QAbstractButton *>(widget) ||
+      qobject_cast<QLineEdit *>(widget))
+    widget->setAttribute(Qt::WA_Hover);
+}
+
+int AppStyle::pixelMetric(PixelMetric metric, const QStyleOption *option,
+                          const QWidget *widget) const {
+  switch (metric) {
+  case PM_ScrollBarExtent:
+    return 10;
+  case PM_IndicatorWidth:
+  case PM_IndicatorHeight:
+    return 18;
+  case PM_CheckBoxLabelSpacing:
+    return 8;
+  default:
+    return QProxyStyle::pixelMetric(metric, option, widget);
+  }
+}
+
+void AppStyle::drawPrimitive(PrimitiveElement element,
+                             const QStyleOption *option, QPainter *painter,
+                             const QWidget *widget) const {
+  const bool dark = isDark(option->palette);
+  const QRectF r = QRectF(option->rect).adjusted(0.5, 0.5, -0.5, -0.5);
+
+  switch (element) {
+  case PE_PanelLineEdit: {
+    const bool focus = option->state & State_HasFocus;
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    QColor fill = dark ? (focus ? kGray800 : kGray700)
+                       : option->palette.color(QPalette::Base);
+    QColor border = focus ? (dark ? kBlue500 : kLightAccent)
+                          : (dark ? kGray600 : kLightBorder);
+    painter->setPen(QPen(border, focus && dark ? 2 : 1));
+    painter->setBrush(fill);
+    painter->drawPath(rounded(r, dark ? 6 : 0));
+    painter->restore();
+    return;
+  }
+  case PE_FrameLineEdit:
+    return; // drawn with the panel
+
+  case PE_IndicatorCheckBox: {
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    const bool on = option->state & State_On;
+    const bool hover = option->state & State_MouseOver;
+    QColor accent = dark ? kBlue500 : kLightAccent;
+    painter->setPen(on || hover ? accent : (dark ? kGray500 : kLightBorder));
+    painter->setBrush(on ? accent : (dark ? kGray700 : QColor(Qt::white)));
+    painter->drawPath(rounded(r, 4));
+    if (on) {
+      QPen tick(Qt::white, 2);
+      painter->setPen(tick);
+      const QRectF c = r.adjusted(4, 4, -4, -4);
+      QPolygonF mark{{c.left(), c.center().y()},
+                     {c.left() + c.width() * 0.4, c.bottom()},
+                     {c.right(), c.top()}};
+      painter->drawPolyline(mark);
+    }
+    painter->restore();
+    return;
+  }
+
+  case PE_FrameGroupBox: {
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(dark ? kGray700 : kLightBorder);
+    painter->setBrush(dark ? kGray800 : QColor(Qt::white));
+    painter->drawPath(rounded(r, 8));
+    painter->restore();
+    return;
+  }
+
+  default:
+    break;
+  }
+  QProxyStyle::drawPrimitive(element, option, painter, widget);
+}
+
+void AppStyle::drawControl(ControlElement element, const QStyleOption *option,
+                           QPainter *painter, const QWidget *widget) const {
+  const bool dark = isDark(option->palette);
+
+  switch (element) {
+  case CE_PushButtonBevel: {
+    const bool enabled = option->state & State_Enabled;
+    const bool pressed = option->state & (State_Sunken | State_On);
+    const bool hover = option->state & State_MouseOver;
+    const QRectF r = QRectF(option->rect).adjusted(0.5, 0.5, -0.5, -0.5);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    if (dark) {
+      painter->setPen(Qt::NoPen);
+      if (!enabled) {
+        painter->setBrush(kGray700);
+      } else if (pressed) {
+        painter->setBrush(kBlue700);
+      } else {
+        QLinearGradient g(r.topLeft(), r.bottomRight());
+        g.setColorAt(0, hover ? kBlue400 : kBlue500);
+        g.setColorAt(1, hover ? kBlue500 : kBlue600);
+        painter->setBrush(g);
+      }
+      painter->drawPath(rounded(r, 6));
+    } else {
+      painter->setPen(hover || pressed ? kLightAccent : kLightBorder);
+      painter->setBrush(pressed ? kLightPressed
+                                : (hover ? kLightHover : kLightButton));
+      painter->drawRect(r);
+    }
+    painter->restore();
+    return;
+  }
+
+  case CE_HeaderSection: {
+    painter->save();
+    painter->fillRect(option->rect, dark ? kGray900 : kLightButton);
+    painter->setPen(QPen(dark ? kBlue500 : kLightBorder, dark ? 2 : 1));
+    painter->drawLine(option->rect.bottomLeft(), option->rect.bottomRight());
+    painter->restore();
+    return;
+  }
+
+  case CE_HeaderLabel:
+    if (dark) {
+      if (auto *header = qstyleoption_cast<const QStyleOptionHeader *>(option)) {
+        QStyleOptionHeader copy(*header);
+        copy.palette.setColor(QPalette::ButtonText, kBlue500);
+        QProxyStyle::drawControl(element, &copy, painter, widget);
+        return;
+      }
+    }
+    break;
+
+  default:
+    break;
+  }
+  QProxyStyle::drawControl(element, option, painter, widget);
+}
+
+void AppStyle::drawComplexControl(ComplexControl control,
+                                  const QStyleOptionComplex *option,
+                                  QPainter *painter,
+                                  const QWidget *widget) const {
+  if (control == CC_GroupBox) {
+    if (auto *box = qstyleoption_cast<const QStyleOptionGroupBox *>(option)) {
+      // Accent-coloured titles without touching the children's palette
+      QStyleOptionGroupBox copy(*box);
+      copy.textColor = isDark(box->palette) ? kBlue500 : kLightAccent;
+      QProxyStyle::drawComplexControl(control, &copy, painter, widget);
+      return;
+    }
+  }
+  QProxyStyle::drawComplexControl(control, option, painter, widget);
+}
@@ -1,10 +1,39 @@
 #ifndef APPSTYLE_H
 #define APPSTYLE_H
 
+#include <QPalette>
+#include <QProxyStyle>
 #include <QString>
 
-class AppStyle {
+// Application look, drawn by a QProxyStyle over Fusion with a palette
+// instead of an app-wide stylesheet. Stylesheets make Qt re-parse and
+// re-polish every widget that is created, which dominated MDI open times.
+class AppStyle : public QProxyStyle {
 public:
+  AppStyle();
+
+  static QPalette darkPalette();
+  // Light scheme used by the catalog screens and the jewelry menu
+  static QPalette lightPalette();
+
+  void polish(QPalette &palette) override;
+  void polish(QWidget *widget) override;
+
+  int pixelMetric(PixelMetric metric, const QStyleOption *option = nullptr,
+                  const QWidget *widget = nullptr) const override;
+
+  void drawPrimitive(PrimitiveElement element, const QStyleOption *option,
+                     QPainter *painter,
+                     const QWidget *widget = nullptr) const override;
+  void drawControl(ControlElement element, const QStyleOption *option,
+                   QPainter *painter,
+                   const QWidget *widget = nullptr) const override;
+  void drawComplexControl(ComplexControl control,
+                          const QStyleOptionComplex *option, QPainter *painter,
+                          const QWidget *widget = nullptr) const override;
+
+  // Previous stylesheet theme. Only applied when LUXEMINE_LEGACY_QSS is
+  // set, to compare window open times against the proxy style.
   static QString getDarkTheme() {
     return R"(
             /* General Application Styling */
@@ -0,0 +1,65 @@
+#include "dates.h"
+
+namespace {
+// Day-first forms seen in existing rows, tried after ISO
+const char *const kDayFirstFormats[] = {
+    "dd-MM-yyyy", "dd/MM/yyyy", "dd.MM.yyyy", "d-M-yyyy", "d/M/yyyy",
+};
+
+bool hasTime(const QString &text) { return text.contains(u':'); }
+} // namespace
+
+QDateTime Dates::parse(const QString &text) {
+  const QString t = text.trimmed();
+  if (t.isEmpty())
+    return {};
+
+  // Date part and optional time part ("2024-03-05 14:02:11", "...T14:02")
+  QString datePart = t;
+  QString timePart;
+  int split = t.indexOf(u' ');
+  if (split < 0)
+    split = t.indexOf(u'T');
+  if (split > 0) {
+    datePart = t.left(split);
+    timePart = t.mid(split + 1).trimmed();
+  }
+
+  QDate date = QDate::fromString(datePart, Qt::ISODate);
+  for (const char *format : kDayFirstFormats) {
+    if (date.isValid())
+      break;
+    date = QDate::fromString(datePart, QLatin1String(format));
+  }
+  if (!date.isValid())
+    return {};
+
+  QTime time(0, 0);
+  if (!timePart.isEmpty()) {
+    time = QTime::fromString(timePart, Qt::ISODate);
+    if (!time.isValid())
+      time = QTime::fromString(timePart, QStringLiteral("H:mm:ss"));
+    if (!time.isValid())
+      time = QTime::fromString(timePart, QStringLiteral("H:mm"));
+    if (!time.isValid())
+      return {};
+  }
+  return QDateTime(date, time);
+}
+
+QString Dates::normalized(const QString &text) {
+  const QDateTime dt = parse(text);
+  if (!dt.isValid())
+    return {};
+  return hasTime(text) ? toStored(dt) : toStored(dt.date());
+}
+
+Dates::Range Dates::weekOf(const QDate &day) {
+  const QDate monday = day.addDays(1 - day.dayOfWeek());
+  return {monday, monday.addDays(7)};
+}
+
+Dates::Range Dates::monthOf(int year, int month) {
+  const QDate first(year, month, 1);
+  return {first, first.addMonths(1)};
+}
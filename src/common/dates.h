@@ -0,0 +1,51 @@
+#ifndef DATES_H
+#define DATES_H
+
+#include <QDate>
+#include <QDateTime>
+#include <QString>
+
+// How dates are stored: ISO text, "yyyy-MM-dd" for dates and
+// "yyyy-MM-dd HH:mm:ss" for timestamps (the form of SQLite's
+// CURRENT_TIMESTAMP). Both sort as text, so ORDER BY and range conditions
+// on an indexed date column are plain index scans.
+//
+// Write dates with toStored(), never with a widget's display text.
+namespace Dates {
+
+constexpr const char *kDateFormat = "yyyy-MM-dd";
+constexpr const char *kDateTimeFormat = "yyyy-MM-dd HH:mm:ss";
+
+inline QString toStored(const QDate &date) {
+  return date.toString(QLatin1String(kDateFormat));
+}
+inline QString toStored(const QDateTime &dateTime) {
+  return dateTime.toString(QLatin1String(kDateTimeFormat));
+}
+
+// A date or timestamp in any form the app has written: ISO, or day first
+// ("dd-MM-yyyy", "dd/MM/yyyy", "dd.MM.yyyy", one-digit day and month too),
+// with or without a time. Invalid when it is none of those.
+QDateTime parse(const QString &text);
+
+// `text` in the stored form, keeping a time only if it had one. Empty when
+// it cannot be read.
+QString normalized(const QString &text);
+
+// Half-open [from, to): pass toStored(from) and toStored(to) to
+// "col >= ? AND col < ?"
+struct Range {
+  QDate from;
+  QDate to;
+
+  bool isValid() const { return from.isValid() && to.isValid(); }
+};
+
+// Monday to Monday around `day`
+Range weekOf(const QDate &day);
+// First of the month to the first of the next
+Range monthOf(int year, int month);
+
+} // namespace Dates
+
+#endif // DATES_H
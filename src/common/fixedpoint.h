@@ -0,0 +1,137 @@
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+
+// Exact decimal quantities held as a count of their smallest unit:
+// Milligrams (grams to 3 decimals) and Paise (rupees to 2 decimals).
+//
+// Weights are entered and shown with a fixed number of decimals, but were
+// summed as doubles, so a column of 0.1 g entries could total 0.999 g.
+// parse() reads the decimal text digit by digit, without going through a
+// double, and sums of the raw integers are exact whatever the order.
+template <int Decimals> class Fixed {
+public:
+  static constexpr qint64 kScale = Decimals == 0   ? 1
+                                   : Decimals == 1 ? 10
+                                   : Decimals == 2 ? 100
+                                                   : 1000;
+  static_assert(Decimals >= 0 && Decimals <= 3, "up to 3 decimals");
+
+  constexpr Fixed() = default;
+
+  static constexpr Fixed fromRaw(qint64 raw) { return Fixed(raw); }
+  // Rounded half away from zero
+  static Fixed fromDouble(double v) { return Fixed(qRound64(v * kScale)); }
+
+  // "12.345", " -0.5 ", "7"; further decimals are rounded. Empty or
+  // malformed text gives 0 and *ok = false.
+  static Fixed parse(QStringView text, bool *ok = nullptr) {
+    text = text.trimmed();
+    qsizetype i = 0;
+    const bool negative = i < text.size() && text[i] == u'-';
+    if (negative || (i < text.size() && text[i] == u'+'))
+      ++i;
+
+    qint64 raw = 0;
+    bool digits = false;
+    for (; i < text.size() && text[i].isDigit(); ++i) {
+      raw = raw * 10 + text[i].digitValue();
+      digits = true;
+    }
+    int decimals = 0;
+    bool roundUp = false;
+    if (i < text.size() && text[i] == u'.') {
+      for (++i; i < text.size() && text[i].isDigit(); ++i) {
+        if (decimals < Decimals)
+          raw = raw * 10 + text[i].digitValue();
+        else if (decimals == Decimals)
+          roundUp = text[i].digitValue() >= 5;
+        ++decimals;
+        digits = true;
+      }
+    }
+    for (; decimals < Decimals; ++decimals)
+      raw *= 10;
+
+    const bool valid = digits && i == text.size();
+    if (ok)
+      *ok = valid;
+    if (!valid)
+      return Fixed();
+    raw += roundUp;
+    return Fixed(negative ? -raw : raw);
+  }
+
+  constexpr qint64 raw() const { return m_raw; }
+  constexpr double toDouble() const { return double(m_raw) / kScale; }
+
+  // Always with `Decimals` decimals, like QString::number(v, 'f', Decimals)
+  QString toString() const {
+    const qint64 whole = m_raw / kScale;
+    const qint64 part = m_raw % kScale;
+    QString s = QString::number(qAbs(whole));
+    if (m_raw < 0)
+      s.prepend(u'-');
+    if (Decimals > 0) {
+      s += u'.';
+      s += QString::number(qAbs(part)).rightJustified(Decimals, u'0');
+    }
+    return s;
+  }
+
+  constexpr Fixed operator+(Fixed o) const { return Fixed(m_raw + o.m_raw); }
+  constexpr Fixed operator-(Fixed o) const { return Fixed(m_raw - o.m_raw); }
+  constexpr Fixed operator-() const { return Fixed(-m_raw); }
+  Fixed &operator+=(Fixed o) {
+    m_raw += o.m_raw;
+    return *this;
+  }
+  Fixed &operator-=(Fixed o) {
+    m_raw -= o.m_raw;
+    return *this;
+  }
+  constexpr bool operator==(Fixed o) const { return m_raw == o.m_raw; }
+  constexpr bool operator!=(Fixed o) const { return m_raw != o.m_raw; }
+  constexpr bool operator<(Fixed o) const { return m_raw < o.m_raw; }
+
+private:
+  constexpr explicit Fixed(qint64 raw) : m_raw(raw) {}
+
+  qint64 m_raw = 0;
+};
+
+using Milligrams = Fixed<3>;
+using Paise = Fixed<2>;
+
+namespace FixedPoint {
+
+// Sum of `n` raw values. Integer addition is associative, so unlike a
+// double loop the compiler is free to vectorise this, and the result does
+// not depend on the order of the rows.
+inline qint64 sum(const qint64 *values, qsizetype n) {
+  qint64 a = 0, b = 0, c = 0, d = 0;
+  qsizetype i = 0;
+  for (; i + 4 <= n; i += 4) {
+    a += values[i];
+    b += values[i + 1];
+    c += values[i + 2];
+    d += values[i + 3];
+  }
+  for (; i < n; ++i)
+    a += values[i];
+  return a + b + c + d;
+}
+
+// out[i] = values[i] * scale, rounded half away from zero
+inline void fromDoubles(const double *values, qint64 *out, qsizetype n,
+                        qint64 scale) {
+  for (qsizetype i = 0; i < n; ++i)
+    out[i] = qRound64(values[i] * scale);
+}
+
+} // namespace FixedPoint
+
+#endif // FIXEDPOINT_H
@@ -0,0 +1,501 @@
+#include "formulaset.h"
+
+#include <QSet>
+
+#include <cmath>
+#include <vector>
+
+// Recursive descent over one expression, emitting postfix code.
+//   expr  := sum [cmp sum]
+//   sum   := term (('+' | '-') term)*
+//   term  := unary (('*' | '/') unary)*
+//   unary := '-' unary | primary
+//   primary := number | name | name '(' expr (',' expr)* ')' | '(' expr ')'
+class FormulaSet::Parser {
+public:
+  Parser(const QString &text, const QHash<QString, int> &slots)
+      : m_text(text), m_slots(slots) {}
+
+  bool parse(QVector<Instr> &code, QSet<int> &uses, QString &error) {
+    m_code = &code;
+    m_uses = &uses;
+    expr();
+    skipSpace();
+    if (m_error.isEmpty() && m_pos < m_text.size())
+      fail(QString("unexpected '%1'").arg(m_text.at(m_pos)));
+    if (m_error.isEmpty() && m_depth > kMaxStack)
+      fail("expression too deeply nested");
+    error = m_error;
+    return m_error.isEmpty();
+  }
+
+private:
+  const QString &m_text;
+  const QHash<QString, int> &m_slots;
+  QVector<Instr> *m_code = nullptr;
+  QSet<int> *m_uses = nullptr;
+  int m_pos = 0;
+  int m_sp = 0;    // stack depth after the code so far
+  int m_depth = 0; // deepest it gets
+  QString m_error;
+
+  void fail(const QString &message) {
+    if (m_error.isEmpty())
+      m_error = QString("%1 at position %2").arg(message).arg(m_pos + 1);
+  }
+
+  void push(Op op, int pops, int slot = 0, double value = 0) {
+    m_code->append({op, slot, value});
+    m_sp += 1 - pops;
+    m_depth = qMax(m_depth, m_sp);
+  }
+
+  void skipSpace() {
+    while (m_pos < m_text.size() && m_text.at(m_pos).isSpace())
+      ++m_pos;
+  }
+
+  bool accept(const char *token) {
+    skipSpace();
+    const QLatin1String t(token);
+    if (!QStringView(m_text).mid(m_pos).startsWith(t))
+      return false;
+    m_pos += t.size();
+    return true;
+  }
+
+  void expect(const char *token) {
+    if (!accept(token))
+      fail(QString("expected '%1'").arg(token));
+  }
+
+  void expr() {
+    sum();
+    // Two-character operators first, so "<=" is not read as "<"
+    static const struct {
+      const char *token;
+      Op op;
+    } kCompare[] = {{"<=", Op::Le}, {">=", Op::Ge}, {"==", Op::Eq},
+                    {"!=", Op::Ne}, {"<", Op::Lt},  {">", Op::Gt}};
+    for (const auto &c : kCompare) {
+      if (accept(c.token)) {
+        sum();
+        push(c.op, 2);
+        return;
+      }
+    }
+  }
+
+  void sum() {
+    term();
+    while (m_error.isEmpty()) {
+      if (accept("+")) {
+        term();
+        push(Op::Add, 2);
+      } else if (accept("-")) {
+        term();
+        push(Op::Sub, 2);
+      } else {
+        break;
+      }
+    }
+  }
+
+  void term() {
+    unary();
+    while (m_error.isEmpty()) {
+      if (accept("*")) {
+        unary();
+        push(Op::Mul, 2);
+      } else if (accept("/")) {
+        unary();
+        push(Op::Div, 2);
+      } else {
+        break;
+      }
+    }
+  }
+
+  void unary() {
+    if (accept("-")) {
+      unary();
+      push(Op::Neg, 1);
+    } else {
+      primary();
+    }
+  }
+
+  void primary() {
+    skipSpace();
+    if (m_pos >= m_text.size()) {
+      fail("unexpected end");
+      return;
+    }
+
+    if (accept("(")) {
+      expr();
+      expect(")");
+      return;
+    }
+
+    const QChar c = m_text.at(m_pos);
+    if (c.isDigit() || c == '.') {
+      const int start = m_pos;
+      while (m_pos < m_text.size() &&
+             (m_text.at(m_pos).isDigit() || m_text.at(m_pos) == '.'))
+        ++m_pos;
+      bool ok = false;
+      const double value = m_text.mid(start, m_pos - start).toDouble(&ok);
+      if (!ok)
+        fail("bad number");
+      push(Op::Const, 0, 0, value);
+      return;
+    }
+
+    if (!c.isLetter() && c != '_') {
+      fail(QString("unexpected '%1'").arg(c));
+      return;
+    }
+    const int start = m_pos;
+    while (m_pos < m_text.size() &&
+           (m_text.at(m_pos).isLetterOrNumber() || m_text.at(m_pos) == '_'))
+      ++m_pos;
+    const QString name = m_text.mid(start, m_pos - start);
+
+    if (accept("(")) {
+      call(name);
+      return;
+    }
+
+    const int slot = m_slots.value(name, -1);
+    if (slot < 0) {
+      m_pos = start;
+      fail(QString("unknown name '%1'").arg(name));
+      return;
+    }
+    m_uses->insert(slot);
+    push(Op::Load, 0, slot);
+  }
+
+  // The opening parenthesis is already read
+  void call(const QString &name) {
+    static const struct {
+      const char *name;
+      int args;
+      Op op;
+    } kFunctions[] = {{"if", 3, Op::If},   {"min", 2, Op::Min},
+                      {"max", 2, Op::Max}, {"abs", 1, Op::Abs},
+                      {"round", 2, Op::Round}};
+    for (const auto &f : kFunctions) {
+      if (name != QLatin1String(f.name))
+        continue;
+      for (int i = 0; i < f.args && m_error.isEmpty(); ++i) {
+        if (i > 0)
+          expect(",");
+        expr();
+      }
+      expect(")");
+      push(f.op, f.args);
+      return;
+    }
+    fail(QString("unknown function '%1'").arg(name));
+  }
+};
+
+FormulaSet::FormulaSet(const QStringList &inputs,
+                       const QList<Formula> &formulas)
+    : m_formulas(formulas) {
+  QStringList names = inputs;
+  for (const Formula &f : formulas)
+    names << f.name;
+  for (const QString &name : names) {
+    if (m_slots.contains(name)) {
+      m_errors << QString("%1: defined twice").arg(name);
+      continue;
+    }
+    m_slots.insert(name, m_names.size());
+    m_names << name;
+  }
+  m_inputCount = inputs.size();
+
+  // ---------- Compile ----------
+  QHash<int, Program> programs; // formula slot -> code
+  QHash<int, QSet<int>> uses;   // formula slot -> slots it reads
+  QList<int> pending;           // formula slots, in definition order
+  for (const Formula &f : formulas) {
+    const int slot = m_slots.value(f.name);
+    if (slot < m_inputCount || programs.contains(slot))
+      continue; // the duplicate was reported above
+
+    Program program;
+    program.slot = slot;
+    QString error;
+    Parser parser(f.expression, m_slots);
+    if (!parser.parse(program.code, uses[slot], error)) {
+      m_errors << QString("%1: %2").arg(f.name, error);
+      program.code = {{Op::Const, 0, 0}};
+      uses[slot].clear();
+    }
+    programs.insert(slot, program);
+    pending << slot;
+  }
+
+  // ---------- Order by dependencies ----------
+  // A formula is ready once every formula it reads is placed
+  QSet<int> placed;
+  QHash<int, QSet<int>> inputsOf; // formula slot -> inputs it depends on
+  bool progress = true;
+  while (!pending.isEmpty() && progress) {
+    progress = false;
+    for (int i = 0; i < pending.size(); ++i) {
+      const int slot = pending.at(i);
+      bool ready = true;
+      QSet<int> reads;
+      for (int used : uses.value(slot)) {
+        if (used < m_inputCount) {
+          reads.insert(used);
+        } else if (placed.contains(used)) {
+          reads.unite(inputsOf.value(used));
+        } else {
+          ready = false;
+          break;
+        }
+      }
+      if (!ready)
+        continue;
+
+      inputsOf.insert(slot, reads);
+      placed.insert(slot);
+      m_programs << programs.value(slot);
+      pending.removeAt(i--);
+      progress = true;
+    }
+  }
+
+  // Whatever is left reads itself somewhere down the line
+  for (int slot : pending) {
+    m_errors << QString("%1: circular reference").arg(m_names.at(slot));
+    Program program;
+    program.slot = slot;
+    program.code = {{Op::Const, 0, 0}};
+    m_programs << program;
+  }
+
+  for (int p = 0; p < m_programs.size(); ++p) {
+    for (int input : inputsOf.value(m_programs.at(p).slot))
+      m_affects[input] << p;
+  }
+}
+
+double FormulaSet::run(const Program &program, const double *values) const {
+  double stack[kMaxStack];
+  int sp = 0;
+  for (const Instr &in : program.code) {
+    switch (in.op) {
+    case Op::Const:
+      stack[sp++] = in.value;
+      break;
+    case Op::Load:
+      stack[sp++] = values[in.slot];
+      break;
+    case Op::Neg:
+      stack[sp - 1] = -stack[sp - 1];
+      break;
+    case Op::Abs:
+      stack[sp - 1] = std::abs(stack[sp - 1]);
+      break;
+    case Op::If:
+      sp -= 2;
+      stack[sp - 1] = stack[sp - 1] != 0 ? stack[sp] : stack[sp + 1];
+      break;
+    default: {
+      const double b = stack[--sp];
+      double &a = stack[sp - 1];
+      switch (in.op) {
+      case Op::Add:
+        a = a + b;
+        break;
+      case Op::Sub:
+        a = a - b;
+        break;
+      case Op::Mul:
+        a = a * b;
+        break;
+      case Op::Div:
+        a = b != 0 ? a / b : 0;
+        break;
+      case Op::Lt:
+        a = a < b;
+        break;
+      case Op::Le:
+        a = a <= b;
+        break;
+      case Op::Gt:
+        a = a > b;
+        break;
+      case Op::Ge:
+        a = a >= b;
+        break;
+      case Op::Eq:
+        a = a == b;
+        break;
+      case Op::Ne:
+        a = a != b;
+        break;
+      case Op::Min:
+        a = qMin(a, b);
+        break;
+      case Op::Max:
+        a = qMax(a, b);
+        break;
+      case Op::Round: {
+        const double scale = std::pow(10.0, b);
+        a = std::round(a * scale) / scale;
+        break;
+      }
+      default:
+        break;
+      }
+    }
+    }
+  }
+  return sp > 0 ? stack[0] : 0;
+}
+
+void FormulaSet::evaluate(double *values) const {
+  for (const Program &program : m_programs)
+    values[program.slot] = run(program, values);
+}
+
+QList<int> FormulaSet::update(double *values, int slot) const {
+  QList<int> changed;
+  for (int p : m_affects.value(slot)) {
+    const Program &program = m_programs.at(p);
+    const double value = run(program, values);
+    if (value != values[program.slot]) {
+      values[program.slot] = value;
+      changed << program.slot;
+    }
+  }
+  return changed;
+}
+
+void FormulaSet::runBlock(const Program &program, double *const *columns,
+                          int first, int count, double *stack) {
+  // stack holds kMaxStack blocks of kBlock values; entry i is stack[i * kBlock]
+  int sp = 0;
+  for (const Instr &in : program.code) {
+    double *top = stack + qMax(sp - 1, 0) * kBlock;
+    switch (in.op) {
+    case Op::Const: {
+      double *out = stack + sp++ * kBlock;
+      for (int i = 0; i < count; ++i)
+        out[i] = in.value;
+      break;
+    }
+    case Op::Load: {
+      double *out = stack + sp++ * kBlock;
+      const double *src = columns[in.slot] + first;
+      for (int i = 0; i < count; ++i)
+        out[i] = src[i];
+      break;
+    }
+    case Op::Neg:
+      for (int i = 0; i < count; ++i)
+        top[i] = -top[i];
+      break;
+    case Op::Abs:
+      for (int i = 0; i < count; ++i)
+        top[i] = std::abs(top[i]);
+      break;
+    case Op::If: {
+      sp -= 2;
+      double *c = stack + (sp - 1) * kBlock;
+      const double *a = c + kBlock;
+      const double *b = a + kBlock;
+      for (int i = 0; i < count; ++i)
+        c[i] = c[i] != 0 ? a[i] : b[i];
+      break;
+    }
+    default: {
+      const double *b = top;
+      double *a = top - kBlock;
+      --sp;
+      switch (in.op) {
+      case Op::Add:
+        for (int i = 0; i < count; ++i)
+          a[i] += b[i];
+        break;
+      case Op::Sub:
+        for (int i = 0; i < count; ++i)
+          a[i] -= b[i];
+        break;
+      case Op::Mul:
+        for (int i = 0; i < count; ++i)
+          a[i] *= b[i];
+        break;
+      case Op::Div:
+        for (int i = 0; i < count; ++i)
+          a[i] = b[i] != 0 ? a[i] / b[i] : 0;
+        break;
+      case Op::Lt:
+        for (int i = 0; i < count; ++i)
+          a[i] = a[i] < b[i];
+        break;
+      case Op::Le:
+        for (int i = 0; i < count; ++i)
+          a[i] = a[i] <= b[i];
+        break;
+      case Op::Gt:
+        for (int i = 0; i < count; ++i)
+          a[i] = a[i] > b[i];
+        break;
+      case Op::Ge:
+        for (int i = 0; i < count; ++i)
+          a[i] = a[i] >= b[i];
+        break;
+      case Op::Eq:
+        for (int i = 0; i < count; ++i)
+          a[i] = a[i] == b[i];
+        break;
+      case Op::Ne:
+        for (int i = 0; i < count; ++i)
+          a[i] = a[i] != b[i];
+        break;
+      case Op::Min:
+        for (int i = 0; i < count; ++i)
+          a[i] = qMin(a[i], b[i]);
+        break;
+      case Op::Max:
+        for (int i = 0; i < count; ++i)
+          a[i] = qMax(a[i], b[i]);
+        break;
+      case Op::Round:
+        for (int i = 0; i < count; ++i) {
+          const double scale = std::pow(10.0, b[i]);
+          a[i] = std::round(a[i] * scale) / scale;
+        }
+        break;
+      default:
+        break;
+      }
+    }
+    }
+  }
+
+  double *out = columns[program.slot] + first;
+  for (int i = 0; i < count; ++i)
+    out[i] = sp > 0 ? stack[i] : 0;
+}
+
+void FormulaSet::evaluateColumns(double *const *columns, int rows) const {
+  std::vector<double> stack(kMaxStack * kBlock);
+
+  // Block by block, all formulas in order: a later formula reads the
+  // results of an earlier one while they are still in cache
+  for (int first = 0; first < rows; first += kBlock) {
+    const int count = qMin(kBlock, rows - first);
+    for (const Program &program : m_programs)
+      runBlock(program, columns, first, count, stack.data());
+  }
+}
@@ -0,0 +1,95 @@
+#ifndef FORMULASET_H
+#define FORMULASET_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// A set of named column formulas over one row of numbers.
+//
+// Every name gets a slot in a flat array of doubles: the inputs first, in
+// the order given, then the formulas. Formulas are compiled once to a small
+// stack program and ordered by their dependencies, so evaluate() fills all
+// derived slots in one pass and update() recomputes only the formulas that
+// depend (directly or through other formulas) on one changed input.
+//
+// Expressions: numbers, names, + - * /, unary minus, parentheses, the
+// comparisons < <= > >= == != (1 or 0), and if(c, a, b), min(a, b),
+// max(a, b), abs(a), round(a, digits). Division by zero gives 0, so one
+// empty row cannot turn a column total into inf.
+//
+// A formula that does not compile, uses an unknown name or is part of a
+// dependency cycle is reported by errors() and evaluates to 0.
+class FormulaSet {
+public:
+  struct Formula {
+    QString name;
+    QString expression;
+
+    bool operator==(const Formula &o) const {
+      return name == o.name && expression == o.expression;
+    }
+  };
+
+  FormulaSet() = default;
+  FormulaSet(const QStringList &inputs, const QList<Formula> &formulas);
+
+  // As given to the constructor, to tell whether a set has changed
+  QList<Formula> formulas() const { return m_formulas; }
+
+  QStringList errors() const { return m_errors; }
+  bool isValid() const { return m_errors.isEmpty(); }
+
+  int slotCount() const { return m_names.size(); }
+  int inputCount() const { return m_inputCount; }
+  int slotOf(const QString &name) const { return m_slots.value(name, -1); }
+  QString nameOf(int slot) const { return m_names.value(slot); }
+
+  // Compute every formula slot from the input slots
+  void evaluate(double *values) const;
+
+  // Input `slot` was changed in `values`: recompute its dependents only.
+  // Returns the formula slots whose value changed, in evaluation order.
+  QList<int> update(double *values, int slot) const;
+
+  // evaluate() for `rows` rows at once, one array per slot
+  // (columns[slot][row]). Each instruction runs as a plain loop over a
+  // block of rows, which the compiler can vectorise, instead of once per
+  // row through the interpreter.
+  void evaluateColumns(double *const *columns, int rows) const;
+
+private:
+  enum class Op : quint8 {
+    Const, Load, Add, Sub, Mul, Div, Neg,
+    Lt, Le, Gt, Ge, Eq, Ne, If, Min, Max, Abs, Round
+  };
+  struct Instr {
+    Op op;
+    int slot = 0;     // Load
+    double value = 0; // Const
+  };
+  struct Program {
+    int slot = 0;
+    QVector<Instr> code;
+  };
+
+  static constexpr int kMaxStack = 32;
+  static constexpr int kBlock = 256; // rows per evaluateColumns() step
+
+  class Parser;
+  double run(const Program &program, const double *values) const;
+  static void runBlock(const Program &program, double *const *columns,
+                       int first, int count, double *stack);
+
+  QList<Formula> m_formulas;
+  QStringList m_names;              // slot -> name
+  QHash<QString, int> m_slots;      // name -> slot
+  int m_inputCount = 0;
+  QList<Program> m_programs;        // dependency order
+  QHash<int, QList<int>> m_affects; // input slot -> indexes into m_programs
+  QStringList m_errors;
+};
+
+#endif // FORMULASET_H
@@ -0,0 +1,139 @@
+#include "imageingest.h"
+
+#include <QApplication>
+#include <QDebug>
+#include <QDir>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QProgressDialog>
+#include <QThread>
+
+namespace {
+QMutex optionsMutex;
+ImageIngest::Options currentOptions;
+
+QString thumbPathFor(const QString &destBase, const QString &ext) {
+  return destBase + "_thumb." + ext;
+}
+} // namespace
+
+ImageIngest::Options ImageIngest::options() {
+  QMutexLocker locker(&optionsMutex);
+  return currentOptions;
+}
+
+void ImageIngest::setOptions(const Options &opts) {
+  QMutexLocker locker(&optionsMutex);
+  currentOptions = opts;
+}
+
+QString ImageIngest::ingest(const QString &sourcePath, const QString &destBase,
+                            const ProgressFn &progress) {
+  auto report = [&](int percent) {
+    if (progress)
+      progress(percent);
+  };
+
+  const Options opts = options();
+
+  // ---------- 1. Decode, oriented and already downsized ----------
+  QImageReader reader(sourcePath);
+  reader.setAutoTransform(true);
+
+  const QSize size = reader.size();
+  if (size.isValid() &&
+      (size.width() > opts.masterEdge || size.height() > opts.masterEdge)) {
+    reader.setScaledSize(
+        size.scaled(opts.masterEdge, opts.masterEdge, Qt::KeepAspectRatio));
+  }
+  report(10);
+
+  QImage img;
+  if (!reader.read(&img)) {
+    qWarning() << "Image ingest: cannot read" << sourcePath << ":"
+               << reader.errorString();
+    return {};
+  }
+  report(50);
+
+  // ---------- 2. Re-encode the master (no EXIF / embedded previews) ------
+  const bool hasAlpha = img.hasAlphaChannel();
+  const QString ext = hasAlpha ? "png" : "jpg";
+  if (!hasAlpha)
+    img = img.convertToFormat(QImage::Format_RGB32);
+
+  const QString masterPath = destBase + "." + ext;
+  QImageWriter writer(masterPath);
+  if (!hasAlpha) {
+    writer.setQuality(opts.quality);
+    writer.setOptimizedWrite(true);
+  }
+  if (!writer.write(img)) {
+    qWarning() << "Image ingest: cannot write" << masterPath << ":"
+               << writer.errorString();
+    return {};
+  }
+  report(80);
+
+  // ---------- 3. Thumbnail ----------
+  QImage thumb = img.scaled(opts.thumbEdge, opts.thumbEdge,
+                            Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  QImageWriter thumbWriter(thumbPathFor(destBase, ext));
+  if (!hasAlpha)
+    thumbWriter.setQuality(opts.quality);
+  if (!thumbWriter.write(thumb)) {
+    // Not fatal: viewers fall back to the master
+    qWarning() << "Image ingest: thumbnail write failed:"
+               << thumbWriter.errorString();
+  }
+  report(100);
+
+  return masterPath;
+}
+
+QString ImageIngest::thumbnailFor(const QString &masterPath) {
+  QFileInfo fi(masterPath);
+  const QString thumb =
+      fi.dir().filePath(fi.completeBaseName() + "_thumb." + fi.suffix());
+  return QFileInfo::exists(thumb) ? thumb : masterPath;
+}
+
+QString ImageIngest::runWithProgress(
+    QWidget *parent, const QString &label,
+    const std::function<QString(const ProgressFn &)> &job) {
+  QProgressDialog dlg(label, QString(), 0, 100, parent);
+  dlg.setWindowModality(Qt::WindowModal);
+  dlg.setCancelButton(nullptr);
+  dlg.setMinimumDuration(0);
+  dlg.setValue(0);
+
+  QPointer<QProgressDialog> guard(&dlg);
+  auto progress = [guard](int percent) {
+    QMetaObject::invokeMethod(
+        qApp,
+        [guard, percent]() {
+          if (guard)
+            guard->setValue(percent);
+        },
+        Qt::QueuedConnection);
+  };
+
+  QString result;
+  QEventLoop loop;
+  QThread *worker =
+      QThread::create([&result, &job, progress]() { result = job(progress); });
+  QObject::connect(worker, &QThread::finished, &loop, &QEventLoop::quit);
+  worker->start();
+  loop.exec();
+  worker->wait();
+  delete worker;
+
+  dlg.setValue(100);
+  return result;
+}
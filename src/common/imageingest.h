@@ -0,0 +1,43 @@
+#ifndef IMAGEINGEST_H
+#define IMAGEINGEST_H
+
+#include <QString>
+
+#include <functional>
+
+class QWidget;
+
+// Normalises uploaded photos before they are stored: applies the EXIF
+// orientation, bounds the resolution, re-encodes at a fixed quality and
+// writes a small "_thumb" copy next to the master. Phone photos of
+// 10-20 MB end up a few hundred KB, so every later view decodes less.
+class ImageIngest {
+public:
+  struct Options {
+    int masterEdge = 2048; // longest edge of the stored master, px
+    int quality = 85;      // JPEG quality, 0-100
+    int thumbEdge = 320;   // longest edge of the thumbnail, px
+  };
+
+  using ProgressFn = std::function<void(int percent)>;
+
+  static Options options();
+  static void setOptions(const Options &opts);
+
+  // Decode sourcePath and write <destBase>.<ext> plus <destBase>_thumb.<ext>.
+  // ext is "png" when the source has transparency, "jpg" otherwise.
+  // Returns the master's path, or an empty string on failure.
+  static QString ingest(const QString &sourcePath, const QString &destBase,
+                        const ProgressFn &progress = {});
+
+  // Thumbnail written alongside masterPath, or masterPath if there is none
+  static QString thumbnailFor(const QString &masterPath);
+
+  // Run job on a worker thread behind a modal progress dialog and return
+  // its result. Keeps the caller's code synchronous without freezing the UI.
+  static QString runWithProgress(
+      QWidget *parent, const QString &label,
+      const std::function<QString(const ProgressFn &)> &job);
+};
+
+#endif // IMAGEINGEST_H
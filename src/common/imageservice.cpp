@@ -0,0 +1,196 @@
+#include "imageservice.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QLabel>
+#include <QMutexLocker>
+#include <QPixmap>
+#include <QPointer>
+#include <QThreadPool>
+
+namespace {
+// Requested sizes are rounded up to this step so interactive resizing
+// reuses the same decode instead of creating one entry per pixel.
+constexpr int kBucketStep = 128;
+constexpr int kDefaultBudgetMB = 64;
+
+// Largest decode looked for to shrink from, instead of decoding again
+// (the job sheet prefetch decodes at 1024)
+constexpr int kMaxSourceEdge = 2048;
+
+QString cacheKey(const QString &fileKey, int edge) {
+  return fileKey + '@' + QString::number(edge);
+}
+} // namespace
+
+ImageService &ImageService::instance() {
+  static ImageService service;
+  return service;
+}
+
+ImageService::ImageService() { m_cache.setMaxCost(kDefaultBudgetMB * 1024); }
+
+QImage ImageService::image(const QString &path, const QSize &bound) {
+  const QString key = fileKey(path);
+  if (key.isEmpty())
+    return {};
+
+  const int edge = bucketEdge(bound);
+
+  QImage img = lookup(key, edge);
+  if (!img.isNull())
+    return img;
+
+  img = decode(path, edge);
+  if (!img.isNull())
+    insert(key, edge, img);
+  return img;
+}
+
+void ImageService::requestImage(const QString &path, const QSize &bound,
+                                QObject *context,
+                                std::function<void(const QImage &)> onReady) {
+  const QString key = fileKey(path);
+  if (key.isEmpty()) {
+    onReady(QImage());
+    return;
+  }
+
+  const int edge = bucketEdge(bound);
+  QImage hit = lookup(key, edge);
+  if (!hit.isNull()) {
+    onReady(hit);
+    return;
+  }
+
+  QPointer<QObject> guard(context);
+  QThreadPool::globalInstance()->start([this, path, key, edge, guard,
+                                        onReady = std::move(onReady)]() {
+    QImage img = decode(path, edge);
+    if (!img.isNull())
+      insert(key, edge, img);
+
+    if (!guard)
+      return;
+    QMetaObject::invokeMethod(
+        guard.data(),
+        [guard, img, onReady]() {
+          if (guard)
+            onReady(img);
+        },
+        Qt::QueuedConnection);
+  });
+}
+
+void ImageService::loadInto(QLabel *label, const QString &path) {
+  if (!label)
+    return;
+
+  // Only the latest request for a label may paint into it
+  label->setProperty("imageServicePath", path);
+
+  const QSize target = label->size() * label->devicePixelRatioF();
+  QPointer<QLabel> guard(label);
+
+  requestImage(path, target, label, [guard, path, target](const QImage &img) {
+    if (!guard || guard->property("imageServicePath").toString() != path)
+      return;
+    if (img.isNull()) {
+      guard->clear();
+      return;
+    }
+
+    // Bucketed decode is at most one step larger, so this scale is cheap
+    QPixmap pix = QPixmap::fromImage(
+        img.scaled(target, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    pix.setDevicePixelRatio(guard->devicePixelRatioF());
+    guard->setPixmap(pix);
+  });
+}
+
+void ImageService::setMemoryBudget(int megabytes) {
+  QMutexLocker locker(&m_mutex);
+  m_cache.setMaxCost(qMax(1, megabytes) * 1024);
+}
+
+void ImageService::clear() {
+  QMutexLocker locker(&m_mutex);
+  m_cache.clear();
+}
+
+// ---------- private ----------
+
+int ImageService::bucketEdge(const QSize &bound) {
+  int edge = qMax(bound.width(), bound.height());
+  edge = qMax(edge, kBucketStep);
+  return ((edge + kBucketStep - 1) / kBucketStep) * kBucketStep;
+}
+
+QString ImageService::fileKey(const QString &path) {
+  if (path.isEmpty())
+    return {};
+
+  QFileInfo fi(path);
+  if (!fi.exists())
+    return {};
+
+  // Modified time and size are part of the key so a replaced file is
+  // never served from an older decode
+  const QString identity =
+      fi.absoluteFilePath() + '|' +
+      QString::number(fi.lastModified().toMSecsSinceEpoch()) + '|' +
+      QString::number(fi.size());
+  return QString::number(qHash(identity), 16);
+}
+
+QImage ImageService::decode(const QString &path, int edge) {
+  QImageReader reader(path);
+  reader.setAutoTransform(true);
+
+  const QSize size = reader.size();
+  if (size.isValid() && (size.width() > edge || size.height() > edge))
+    reader.setScaledSize(size.scaled(edge, edge, Qt::KeepAspectRatio));
+
+  QImage img;
+  if (!reader.read(&img)) {
+    qWarning() << "ImageService: decode failed for" << path << ":"
+               << reader.errorString();
+  }
+  return img;
+}
+
+QImage ImageService::lookup(const QString &fileKey, int edge) {
+  QImage source;
+  {
+    QMutexLocker locker(&m_mutex);
+    if (QImage *hit = m_cache.object(cacheKey(fileKey, edge)))
+      return *hit;
+
+    // A larger decode of the same file is cheaper to shrink than the
+    // file is to decode again; the nearest bucket above that is cached
+    QImage *larger = nullptr;
+    for (int e = edge + kBucketStep; !larger && e <= kMaxSourceEdge;
+         e += kBucketStep)
+      larger = m_cache.object(cacheKey(fileKey, e));
+    if (!larger)
+      return {};
+    source = *larger;
+  }
+
+  QImage img = source;
+  if (source.width() > edge || source.height() > edge)
+    img = source.scaled(edge, edge, Qt::KeepAspectRatio,
+                        Qt::SmoothTransformation);
+  insert(fileKey, edge, img);
+  return img;
+}
+
+void ImageService::insert(const QString &fileKey, int edge,
+                          const QImage &img) {
+  const int cost = qMax<qsizetype>(1, img.sizeInBytes() / 1024);
+
+  QMutexLocker locker(&m_mutex);
+  m_cache.insert(cacheKey(fileKey, edge), new QImage(img), cost);
+}
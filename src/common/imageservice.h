@@ -0,0 +1,55 @@
+#ifndef IMAGESERVICE_H
+#define IMAGESERVICE_H
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+
+#include <functional>
+
+class QLabel;
+class QObject;
+
+// Shared decoder and cache for product / order photos.
+// Images are decoded straight to the size they are shown at
+// (QImageReader::setScaledSize) and cached by (file hash, size bucket)
+// under a memory budget, so the full-resolution photo is never kept.
+class ImageService {
+public:
+  static ImageService &instance();
+
+  // Decode (or fetch from cache) an image that fits inside bound.
+  // Thread-safe; blocks the caller on a miss.
+  QImage image(const QString &path, const QSize &bound);
+
+  // Same as image(), but decodes on the thread pool and calls onReady
+  // on context's thread. Cache hits are delivered immediately.
+  void requestImage(const QString &path, const QSize &bound,
+                    QObject *context,
+                    std::function<void(const QImage &)> onReady);
+
+  // Show path in label at the label's current size
+  void loadInto(QLabel *label, const QString &path);
+
+  void setMemoryBudget(int megabytes);
+  void clear();
+
+private:
+  ImageService();
+  ImageService(const ImageService &) = delete;
+  ImageService &operator=(const ImageService &) = delete;
+
+  static int bucketEdge(const QSize &bound);
+  static QString fileKey(const QString &path);
+  static QImage decode(const QString &path, int edge);
+
+  QImage lookup(const QString &fileKey, int edge);
+  void insert(const QString &fileKey, int edge, const QImage &img);
+
+  QMutex m_mutex;
+  QCache<QString, QImage> m_cache; // cost in KB
+};
+
+#endif // IMAGESERVICE_H
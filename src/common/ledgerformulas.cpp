@@ -0,0 +1,272 @@
+#include "ledgerformulas.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <iterator>
+
+#include "common/purity.h"
+
+namespace {
+// Karats only mean something for gold; sterling silver's 925 would
+// otherwise read as 22.2K. Rows without a metal are taken as gold.
+double goldKarat(const QString &metal, double fineness) {
+  if (!metal.isEmpty() && metal.compare("Gold", Qt::CaseInsensitive) != 0)
+    return 0;
+  return Purity::fromFineness(fineness).karat();
+}
+
+// Inputs in slot order and where each comes from. purity is the karat of
+// the row's numeric fineness, stored when the purity text was written.
+template <typename Row> struct Input {
+  const char *name;
+  double (*get)(const Row &);
+};
+
+const Input<JobListData> kJobInputs[] = {
+    {"issue_wt", [](const JobListData &d) { return d.issueWt; }},
+    {"gross_wt", [](const JobListData &d) { return d.grossWt; }},
+    {"receive_dia_wt", [](const JobListData &d) { return d.receiveDiaWt; }},
+    {"receive_stone_wt",
+     [](const JobListData &d) { return d.receiveStoneWt; }},
+    {"office_gold_receive",
+     [](const JobListData &d) { return d.officeGoldReceive; }},
+    {"office_receive", [](const JobListData &d) { return d.officeReceive; }},
+    {"manufacturer_mfg_receive",
+     [](const JobListData &d) { return d.manufacturerMfgReceive; }},
+    {"issue_dia_wt", [](const JobListData &d) { return d.issueDiaWt; }},
+    {"issue_stone_wt", [](const JobListData &d) { return d.issueStoneWt; }},
+    {"issue_dia_pcs",
+     [](const JobListData &d) { return double(d.issueDiaPcs); }},
+    {"receive_dia_pcs",
+     [](const JobListData &d) { return double(d.receiveDiaPcs); }},
+    {"issue_stone_pcs",
+     [](const JobListData &d) { return double(d.issueStonePcs); }},
+    {"receive_stone_pcs",
+     [](const JobListData &d) { return double(d.receiveStonePcs); }},
+    {"pcs", [](const JobListData &d) { return double(d.pcs); }},
+    {"purity",
+     [](const JobListData &d) { return goldKarat(d.metal, d.fineness); }},
+};
+
+const Input<CastingListRow> kCastingInputs[] = {
+    {"issue_metal_wt", [](const CastingListRow &r) { return r.issueMetalWt; }},
+    {"issue_dia_pcs",
+     [](const CastingListRow &r) { return double(r.issueDiaPcs); }},
+    {"issue_dia_wt", [](const CastingListRow &r) { return r.issueDiaWt; }},
+    {"receive_runner_wt",
+     [](const CastingListRow &r) { return r.receiveRunnerWt; }},
+    {"receive_product_wt",
+     [](const CastingListRow &r) { return r.receiveProductWt; }},
+    {"receive_dia_pcs",
+     [](const CastingListRow &r) { return double(r.receiveDiaPcs); }},
+    {"receive_dia_wt", [](const CastingListRow &r) { return r.receiveDiaWt; }},
+    {"dia_price", [](const CastingListRow &r) { return r.diaPrice; }},
+    {"pcs", [](const CastingListRow &r) { return double(r.pcs); }},
+    {"purity",
+     [](const CastingListRow &r) {
+       return goldKarat(r.issueMetal, r.fineness);
+     }},
+};
+
+// Loss = Issue Gold - (Receive Gold + Runner), where Receive Gold is the
+// net weight (product without diamonds and stones); fine loss is the gross
+// loss at the karat, as for castings
+const FormulaSet::Formula kJobDefaults[] = {
+    {"net_wt", "gross_wt - receive_dia_wt - receive_stone_wt"},
+    {"gross_loss", "issue_wt - (net_wt + office_gold_receive)"},
+    {"fine_loss", "if(purity > 0, gross_loss * purity / 100, 0)"},
+    {"loss_percent", "if(issue_wt > 0, gross_loss / issue_wt * 100, 0)"},
+    {"dia_loss", "issue_dia_wt - receive_dia_wt"},
+    {"stone_loss", "receive_stone_wt - issue_stone_wt"},
+};
+
+// Diamond weight is taken off at 1/5 of its carats; fine loss is the
+// gross loss at the karat as a percentage
+const FormulaSet::Formula kCastingDefaults[] = {
+    {"gross_loss", "receive_runner_wt + receive_product_wt - issue_dia_wt / 5 "
+                   "- issue_metal_wt"},
+    {"fine_loss", "if(purity > 0, gross_loss * purity / 100, 0)"},
+    {"dia_pcs_loss", "receive_dia_pcs - issue_dia_pcs"},
+    {"dia_wt_loss", "receive_dia_wt - issue_dia_wt"},
+    {"dia_loss_price", "dia_wt_loss * dia_price"},
+};
+
+// JobListData members filled from formula results
+const struct {
+  const char *name;
+  double JobListData::*member;
+} kJobOutputs[] = {
+    {"net_wt", &JobListData::netWt},
+    {"gross_loss", &JobListData::grossLoss},
+    {"fine_loss", &JobListData::fineLoss},
+    {"loss_percent", &JobListData::percentage},
+    {"dia_loss", &JobListData::diaLoss},
+    {"stone_loss", &JobListData::stoneLoss},
+};
+
+template <typename Row, int N>
+QStringList toList(const Input<Row> (&inputs)[N]) {
+  QStringList list;
+  for (const Input<Row> &in : inputs)
+    list << QString::fromLatin1(in.name);
+  return list;
+}
+
+template <typename Row, int N>
+void fillRow(const Input<Row> (&inputs)[N], const Row &row, double *values) {
+  for (int i = 0; i < N; ++i)
+    values[i] = inputs[i].get(row);
+}
+
+// One column per input
+template <typename Row, int N>
+void fillColumns(const Input<Row> (&inputs)[N], const QList<Row> &rows,
+                 double *const *columns) {
+  for (int i = 0; i < N; ++i) {
+    double *out = columns[i];
+    const auto get = inputs[i].get;
+    for (int r = 0; r < rows.size(); ++r)
+      out[r] = get(rows.at(r));
+  }
+}
+
+template <typename T> QList<FormulaSet::Formula> toFormulas(const T &f) {
+  return QList<FormulaSet::Formula>(std::begin(f), std::end(f));
+}
+
+// `base` with `name` replaced by `expression` (or added, if it is new)
+QList<FormulaSet::Formula> withFormula(QList<FormulaSet::Formula> base,
+                                       const QString &name,
+                                       const QString &expression) {
+  for (FormulaSet::Formula &f : base) {
+    if (f.name == name) {
+      f.expression = expression;
+      return base;
+    }
+  }
+  base.append({name, expression});
+  return base;
+}
+} // namespace
+
+QStringList LedgerFormulas::inputs(const QString &ledger) {
+  if (ledger == "jobs")
+    return toList(kJobInputs);
+  if (ledger == "casting")
+    return toList(kCastingInputs);
+  return {};
+}
+
+QList<FormulaSet::Formula> LedgerFormulas::defaults(const QString &ledger) {
+  if (ledger == "jobs")
+    return toFormulas(kJobDefaults);
+  if (ledger == "casting")
+    return toFormulas(kCastingDefaults);
+  return {};
+}
+
+namespace {
+// Defaults with every override of the shop that compiles. Each is tried on
+// its own, so one bad formula does not take the others with it.
+QList<FormulaSet::Formula> shopFormulas(const QString &ledger) {
+  const QStringList in = LedgerFormulas::inputs(ledger);
+  QList<FormulaSet::Formula> formulas = LedgerFormulas::defaults(ledger);
+
+  const QMap<QString, QString> overrides =
+      DatabaseUtils::getLedgerFormulas(ledger);
+  for (auto it = overrides.cbegin(); it != overrides.cend(); ++it) {
+    const QList<FormulaSet::Formula> candidate =
+        withFormula(formulas, it.key(), it.value());
+    const FormulaSet check(in, candidate);
+    if (check.isValid()) {
+      formulas = candidate;
+    } else {
+      qWarning() << "LedgerFormulas: ignoring" << ledger << it.key() << "="
+                 << it.value() << check.errors();
+    }
+  }
+  return formulas;
+}
+} // namespace
+
+FormulaSet LedgerFormulas::forLedger(const QString &ledger) {
+  return FormulaSet(inputs(ledger), shopFormulas(ledger));
+}
+
+bool LedgerFormulas::isDefault(const FormulaSet &formulas,
+                               const QString &ledger,
+                               const QStringList &names) {
+  const QList<FormulaSet::Formula> given = formulas.formulas();
+  for (const FormulaSet::Formula &d : defaults(ledger)) {
+    if (names.contains(d.name) && !given.contains(d))
+      return false;
+  }
+  return true;
+}
+
+bool LedgerFormulas::setFormula(const QString &ledger, const QString &name,
+                                const QString &expression, QString *error) {
+  const QStringList in = inputs(ledger);
+  QStringList errors;
+  if (in.isEmpty()) {
+    errors << QString("unknown ledger '%1'").arg(ledger);
+  } else if (in.contains(name)) {
+    errors << QString("%1 is an input, not a formula").arg(name);
+  } else if (!expression.trimmed().isEmpty()) {
+    // Checked together with the shop's other formulas, which may use it
+    errors =
+        FormulaSet(in, withFormula(shopFormulas(ledger), name, expression))
+            .errors();
+  }
+
+  if (!errors.isEmpty()) {
+    if (error)
+      *error = errors.join("\n");
+    return false;
+  }
+
+  if (!DatabaseUtils::setLedgerFormula(ledger, name, expression.trimmed())) {
+    if (error)
+      *error = "Could not save the formula.";
+    return false;
+  }
+  return true;
+}
+
+void LedgerFormulas::fill(const JobListData &d, double *values) {
+  fillRow(kJobInputs, d, values);
+}
+
+void LedgerFormulas::fill(const CastingListRow &r, double *values) {
+  fillRow(kCastingInputs, r, values);
+}
+
+void LedgerFormulas::fillColumns(const QList<JobListData> &rows,
+                                 double *const *columns) {
+  ::fillColumns(kJobInputs, rows, columns);
+}
+
+void LedgerFormulas::fillColumns(const QList<CastingListRow> &rows,
+                                 double *const *columns) {
+  ::fillColumns(kCastingInputs, rows, columns);
+}
+
+void LedgerFormulas::store(const FormulaSet &formulas, const double *values,
+                           JobListData &d) {
+  for (const auto &out : kJobOutputs) {
+    const int slot = formulas.slotOf(QLatin1String(out.name));
+    d.*out.member = slot >= 0 ? values[slot] : 0.0;
+  }
+}
+
+void LedgerFormulas::storeColumns(const FormulaSet &formulas,
+                                  const double *const *columns,
+                                  QList<JobListData> &rows) {
+  for (const auto &out : kJobOutputs) {
+    const int slot = formulas.slotOf(QLatin1String(out.name));
+    const double *in = slot >= 0 ? columns[slot] : nullptr;
+    for (int r = 0; r < rows.size(); ++r)
+      rows[r].*out.member = in ? in[r] : 0.0;
+  }
+}
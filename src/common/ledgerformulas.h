@@ -0,0 +1,68 @@
+#ifndef LEDGERFORMULAS_H
+#define LEDGERFORMULAS_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "common/formulaset.h"
+#include "database/databaseutils.h"
+#include "models/CastingListRow.h"
+
+// The derived columns of the jobs and casting ledgers (net weight, gross,
+// fine, diamond and stone losses) as FormulaSets.
+//
+// The defaults below are what the lists always computed. A shop can
+// replace any of them, or add helper formulas for the others to use,
+// through the ledger_formulas table (setFormula()). An override that does
+// not compile is logged and its default used instead.
+//
+// Input names, in slot order:
+//   jobs:    issue_wt, gross_wt, receive_dia_wt, receive_stone_wt,
+//            office_gold_receive, office_receive, manufacturer_mfg_receive,
+//            issue_dia_wt, issue_stone_wt, issue_dia_pcs, receive_dia_pcs,
+//            issue_stone_pcs, receive_stone_pcs, pcs, purity
+//   casting: issue_metal_wt, issue_dia_pcs, issue_dia_wt, receive_runner_wt,
+//            receive_product_wt, receive_dia_pcs, receive_dia_wt, dia_price,
+//            pcs, purity
+// purity is the karat of the row's metal purity ("18K" or "75%" -> 18),
+// from the numeric fineness stored with it (see Purity). It is 0 for
+// metals other than gold, so their default fine_loss is 0.
+class LedgerFormulas {
+public:
+  static QStringList inputs(const QString &ledger);
+  static QList<FormulaSet::Formula> defaults(const QString &ledger);
+
+  // Defaults merged with this shop's overrides
+  static FormulaSet forLedger(const QString &ledger);
+
+  // Whether `formulas` computes each of `names` with its default
+  // expression. The defaults use only inputs and each other, so the values
+  // SQL keeps with them (job_totals) are then the ones the lists show.
+  static bool isDefault(const FormulaSet &formulas, const QString &ledger,
+                        const QStringList &names);
+
+  // Checks `expression` against the ledger and stores it; an empty one
+  // restores the default. `error` says what is wrong when it returns false.
+  static bool setFormula(const QString &ledger, const QString &name,
+                         const QString &expression, QString *error = nullptr);
+
+  // Input slots from a row, in inputs() order
+  static void fill(const JobListData &d, double *values);
+  static void fill(const CastingListRow &r, double *values);
+
+  // The same for a batch: columns[slot][i] from rows[i]
+  static void fillColumns(const QList<JobListData> &rows,
+                          double *const *columns);
+  static void fillColumns(const QList<CastingListRow> &rows,
+                          double *const *columns);
+
+  // Formula results back into the JobListData members that carry them
+  static void store(const FormulaSet &formulas, const double *values,
+                    JobListData &d);
+  static void storeColumns(const FormulaSet &formulas,
+                           const double *const *columns,
+                           QList<JobListData> &rows);
+};
+
+#endif // LEDGERFORMULAS_H
@@ -0,0 +1,67 @@
+#ifndef LISTROWS_H
+#define LISTROWS_H
+
+#include <tuple>
+
+#include "database/databaseutils.h"
+#include "models/CastingListRow.h"
+#include "models/UserPaymentView.h"
+
+// Key and members of the rows shown by the list windows. TableDiff compares
+// rows through tie() and ListSnapshot persists them through it, so a member
+// added to one of these structs must be added here as well, or refreshes
+// will not notice changes to it.
+template <typename Row> struct ListRow;
+
+// getJobsList()
+template <> struct ListRow<JobListData> {
+  static int key(const JobListData &d) { return d.jobId; }
+  template <typename R> static auto tie(R &d) {
+    return std::tie(d.jobId, d.deliveryDate, d.designNo, d.jobNo, d.pcs,
+                    d.metal, d.purity, d.fineness, d.status, d.mfgIssueDate,
+                    d.issueWt, d.materialIssueWt, d.issueDiaPcs, d.issueDiaWt,
+                    d.issueStonePcs, d.issueStoneWt, d.issueDiaCategory,
+                    d.receiveDate, d.grossWt, d.receiveDiaPcs, d.receiveDiaWt,
+                    d.receiveStonePcs, d.receiveStoneWt, d.officeGoldReceive,
+                    d.officeReceive, d.manufacturerMfgReceive, d.netWt,
+                    d.grossLoss, d.fineLoss, d.percentage, d.diaLoss,
+                    d.stoneLoss, d.manufacturerMfgLoss, d.remark, d.dbJobId);
+  }
+};
+
+// getCastingList()
+template <> struct ListRow<CastingListRow> {
+  static int key(const CastingListRow &r) { return r.jobId; }
+  template <typename R> static auto tie(R &r) {
+    return std::tie(r.jobId, r.deliveryDate, r.castingDate, r.vendorName,
+                    r.pcs, r.issueMetal, r.purity, r.fineness, r.issueMetalWt,
+                    r.issueDiaPcs, r.issueDiaWt, r.receiveRunnerWt,
+                    r.receiveProductWt, r.receiveDiaPcs, r.receiveDiaWt,
+                    r.diaPrice, r.status);
+  }
+};
+
+// getAllStocks()
+template <> struct ListRow<StockData> {
+  static int key(const StockData &s) { return s.id; }
+  template <typename R> static auto tie(R &s) {
+    return std::tie(s.id, s.date, s.metal, s.detail, s.note, s.voucherNo,
+                    s.purity, s.weight, s.weight24k, s.price, s.amount);
+  }
+};
+
+// UserRepository::getUsersWithPayments()
+template <> struct ListRow<UserPaymentView> {
+  static int key(const UserPaymentView &u) { return u.userId; }
+  template <typename R> static auto tie(R &u) {
+    return std::tie(u.userId, u.employeeId, u.username, u.fullName, u.roles,
+                    u.baseSalary, u.workedDays, u.advancePaid, u.paidAmount,
+                    u.totalPaid, u.pending);
+  }
+};
+
+template <typename Row> bool sameListRow(const Row &a, const Row &b) {
+  return ListRow<Row>::tie(a) == ListRow<Row>::tie(b);
+}
+
+#endif // LISTROWS_H
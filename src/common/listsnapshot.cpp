@@ -0,0 +1,120 @@
+#include "listsnapshot.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <tuple>
+
+#include "common/listrows.h"
+#include "common/sessionmanager.h"
+#include "common/stringpool.h"
+
+namespace {
+constexpr quint32 kMagic = 0x4C4D534E; // "LMSN"
+constexpr quint16 kFormat = 2;         // bump when a row layout changes
+
+// Row kind tag written in the header, so a jobs file is never read as casting
+template <typename Row> constexpr quint32 kKind = 0;
+template <> constexpr quint32 kKind<JobListData> = 1;
+template <> constexpr quint32 kKind<CastingListRow> = 2;
+
+template <typename Row>
+bool saveRows(const QString &path, const QList<Row> &rows) {
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  // Written aside and renamed, so a crash never leaves half a snapshot
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "ListSnapshot: cannot write" << path << file.errorString();
+    return false;
+  }
+
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_6_0);
+  out << kMagic << kFormat << kKind<Row>
+      << QDateTime::currentMSecsSinceEpoch() << quint32(rows.size());
+  for (const Row &row : rows)
+    std::apply([&](const auto &...f) { (out << ... << f); },
+               ListRow<Row>::tie(row));
+
+  return out.status() == QDataStream::Ok && file.commit();
+}
+
+template <typename Row>
+bool loadRows(const QString &path, QList<Row> &rows, QDateTime *savedAt) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+    return false;
+
+  uchar *mapped = file.map(0, file.size());
+  if (!mapped)
+    return false;
+  const QByteArray bytes = QByteArray::fromRawData(
+      reinterpret_cast<const char *>(mapped), file.size());
+
+  QDataStream in(bytes);
+  in.setVersion(QDataStream::Qt_6_0);
+
+  quint32 magic = 0, kind = 0, count = 0;
+  quint16 format = 0;
+  qint64 savedMs = 0;
+  in >> magic >> format >> kind >> savedMs >> count;
+
+  bool ok = in.status() == QDataStream::Ok && magic == kMagic &&
+            format == kFormat && kind == kKind<Row>;
+  if (ok) {
+    rows.clear();
+    rows.reserve(qMin<qsizetype>(count, bytes.size())); // count may be junk
+    StringPool pool; // each string is read as a fresh copy, as from a query
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+      Row row{};
+      std::apply([&](auto &...f) { (in >> ... >> f); }, ListRow<Row>::tie(row));
+      std::apply([&](auto &...f) { (pool.internMember(f), ...); },
+                 ListRow<Row>::tie(row));
+      rows.append(row);
+    }
+    ok = in.status() == QDataStream::Ok;
+  }
+
+  file.unmap(mapped);
+  if (!ok) {
+    rows.clear();
+    qWarning() << "ListSnapshot: ignoring unreadable snapshot" << path;
+    return false;
+  }
+  if (savedAt)
+    *savedAt = QDateTime::fromMSecsSinceEpoch(savedMs);
+  return true;
+}
+} // namespace
+
+QString ListSnapshot::pathFor(const QString &list) {
+  const QString role = SessionManager::activeRole().toLower();
+  return QDir::current().filePath(QString("data/snapshots/%1_%2_%3.snap")
+                                      .arg(list)
+                                      .arg(SessionManager::currentUser().id)
+                                      .arg(role.isEmpty() ? "none" : role));
+}
+
+bool ListSnapshot::save(const QString &path, const QList<JobListData> &rows) {
+  return saveRows(path, rows);
+}
+
+bool ListSnapshot::save(const QString &path,
+                        const QList<CastingListRow> &rows) {
+  return saveRows(path, rows);
+}
+
+bool ListSnapshot::load(const QString &path, QList<JobListData> &rows,
+                        QDateTime *savedAt) {
+  return loadRows(path, rows, savedAt);
+}
+
+bool ListSnapshot::load(const QString &path, QList<CastingListRow> &rows,
+                        QDateTime *savedAt) {
+  return loadRows(path, rows, savedAt);
+}
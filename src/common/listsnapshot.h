@@ -0,0 +1,34 @@
+#ifndef LISTSNAPSHOT_H
+#define LISTSNAPSHOT_H
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+#include "database/databaseutils.h"
+#include "models/CastingListRow.h"
+
+// Last loaded rows of a list window, kept on disk so the next open can
+// paint them at once while the real query runs in the background.
+//
+// One file per list, user and role under data/snapshots/: a fixed header
+// (magic, format, row kind, time saved, row count) followed by the rows as
+// QDataStream records. Loading maps the file rather than reading it into a
+// buffer. A file from another format version, or a damaged one, is ignored.
+class ListSnapshot {
+public:
+  // data/snapshots/<list>_<userId>_<role>.snap for the current session;
+  // call on the GUI thread and hand the path to workers
+  static QString pathFor(const QString &list);
+
+  static bool save(const QString &path, const QList<JobListData> &rows);
+  static bool save(const QString &path, const QList<CastingListRow> &rows);
+
+  // False when there is no usable snapshot; savedAt gets the time written
+  static bool load(const QString &path, QList<JobListData> &rows,
+                   QDateTime *savedAt = nullptr);
+  static bool load(const QString &path, QList<CastingListRow> &rows,
+                   QDateTime *savedAt = nullptr);
+};
+
+#endif // LISTSNAPSHOT_H
@@ -0,0 +1,48 @@
+#include "lossengine.h"
+
+#include <QDebug>
+
+#include "common/ledgerformulas.h"
+
+LossBatch::LossBatch(int slots, int rows)
+    : m_rows(rows), m_data(size_t(slots) * rows) {}
+
+std::vector<double *> LossBatch::columns() {
+  std::vector<double *> columns(m_rows > 0 ? m_data.size() / m_rows : 0);
+  for (size_t slot = 0; slot < columns.size(); ++slot)
+    columns[slot] = m_data.data() + slot * m_rows;
+  return columns;
+}
+
+namespace {
+// The fill functions write one column per input of the ledger
+bool fits(const FormulaSet &formulas, const char *ledger) {
+  if (formulas.inputCount() == LedgerFormulas::inputs(ledger).size())
+    return true;
+  qWarning() << "LossEngine: formulas are not for the" << ledger << "ledger";
+  return false;
+}
+} // namespace
+
+void LossEngine::apply(const FormulaSet &formulas, QList<JobListData> &rows) {
+  if (rows.isEmpty() || !fits(formulas, "jobs"))
+    return;
+
+  LossBatch batch(formulas.slotCount(), rows.size());
+  const std::vector<double *> columns = batch.columns();
+  LedgerFormulas::fillColumns(rows, columns.data());
+  formulas.evaluateColumns(columns.data(), rows.size());
+  LedgerFormulas::storeColumns(formulas, columns.data(), rows);
+}
+
+LossBatch LossEngine::compute(const FormulaSet &formulas,
+                              const QList<CastingListRow> &rows) {
+  if (rows.isEmpty() || !fits(formulas, "casting"))
+    return LossBatch();
+
+  LossBatch batch(formulas.slotCount(), rows.size());
+  const std::vector<double *> columns = batch.columns();
+  LedgerFormulas::fillColumns(rows, columns.data());
+  formulas.evaluateColumns(columns.data(), rows.size());
+  return batch;
+}
@@ -0,0 +1,47 @@
+#ifndef LOSSENGINE_H
+#define LOSSENGINE_H
+
+#include <QList>
+
+#include <vector>
+
+#include "common/formulaset.h"
+#include "database/databaseutils.h"
+#include "models/CastingListRow.h"
+
+// The values of one ledger's formulas for a batch of rows, struct-of-arrays:
+// one contiguous array per FormulaSet slot, inputs first, then results.
+class LossBatch {
+public:
+  LossBatch() = default;
+  LossBatch(int slots, int rows);
+
+  int rows() const { return m_rows; }
+  double value(int slot, int row) const {
+    return m_data[size_t(slot) * m_rows + row];
+  }
+
+  // columns[slot] for FormulaSet::evaluateColumns and the fill functions
+  std::vector<double *> columns();
+
+private:
+  int m_rows = 0;
+  std::vector<double> m_data;
+};
+
+// Gross, fine, diamond and stone losses for whole lists at once: the rows
+// are transposed into a LossBatch (purity from the stored fineness, no
+// text parsing), the ledger formulas run over it column by column, and the results are
+// read back. The lists, and anything that reports on jobs or castings,
+// should come through here rather than compute per row.
+class LossEngine {
+public:
+  // Net weight and losses of every job, written into the rows
+  static void apply(const FormulaSet &formulas, QList<JobListData> &rows);
+
+  // Formula values of every casting row; row i of the batch is rows[i]
+  static LossBatch compute(const FormulaSet &formulas,
+                           const QList<CastingListRow> &rows);
+};
+
+#endif // LOSSENGINE_H
@@ -0,0 +1,43 @@
+#include "purity.h"
+
+Purity Purity::parse(const QString &text) {
+  // By hand rather than with regular expressions: this runs for every row
+  // of a bulk import and for every distinct purity in a migration
+  const int n = text.size();
+  Purity number; // the first plain number, if no karat turns up
+  bool haveNumber = false;
+
+  for (int i = 0; i < n;) {
+    if (!text.at(i).isDigit()) {
+      ++i;
+      continue;
+    }
+    const int start = i;
+    while (i < n && text.at(i).isDigit())
+      ++i;
+    if (i + 1 < n && text.at(i) == '.' && text.at(i + 1).isDigit()) {
+      ++i;
+      while (i < n && text.at(i).isDigit())
+        ++i;
+    }
+    const double value = QStringView(text).mid(start, i - start).toDouble();
+
+    int j = i;
+    while (j < n && text.at(j).isSpace())
+      ++j;
+    const QChar next = j < n ? text.at(j) : QChar();
+
+    if (next == 'k' || next == 'K')
+      return value > 0 && value <= 24 ? fromKarat(value) : Purity();
+    if (!haveNumber) {
+      number = next == '%' ? fromPercent(value) : fromNumber(value);
+      haveNumber = true;
+    }
+  }
+  return number;
+}
+
+QVariant Purity::finenessOf(const QString &text) {
+  const Purity p = parse(text);
+  return p.isValid() ? QVariant(p.fineness()) : QVariant();
+}
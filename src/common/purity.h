@@ -0,0 +1,139 @@
+#ifndef PURITY_H
+#define PURITY_H
+
+#include <QString>
+#include <QVariant>
+
+// Karat and purity arithmetic shared by every weight calculation.
+//
+// Purity is a metal's nominal fineness (18K = 75%). Text from the purity
+// combo boxes ("18K (75%)", "Sterling Silver (92.5%)") is parsed once, when
+// a row is written, into a numeric fineness column; lists and formulas read
+// the number.
+//
+// Karat::kGrades is the shop's karat chart used for catalog weights: the
+// final purity factor each karat is made at, and the weight kept after
+// making losses. It is constexpr, so lookups cost a few compares and never
+// build a table.
+class Purity {
+public:
+  constexpr Purity() = default;
+
+  static constexpr Purity fromFraction(double f) { return Purity(f); }
+  static constexpr Purity fromPercent(double p) { return Purity(p / 100.0); }
+  static constexpr Purity fromKarat(double k) { return Purity(k / 24.0); }
+  // Parts per thousand, the hallmark number ("750")
+  static constexpr Purity fromFineness(double ppt) {
+    return Purity(ppt / 1000.0);
+  }
+
+  // A bare number by its size: up to 1 a fraction, up to 100 a percentage,
+  // up to 1000 a fineness
+  static constexpr Purity fromNumber(double v) {
+    return v <= 0      ? Purity()
+           : v <= 1    ? fromFraction(v)
+           : v <= 100  ? fromPercent(v)
+           : v <= 1000 ? fromFineness(v)
+                       : Purity();
+  }
+
+  // "18K", "22 k", "18K (75%)" by the karat; otherwise the first number,
+  // as a percentage when followed by % or else by fromNumber(). Invalid
+  // (0) when the text has no number.
+  static Purity parse(const QString &text);
+
+  constexpr bool isValid() const { return m_fraction > 0; }
+  constexpr double fraction() const { return m_fraction; }
+  constexpr double percent() const { return m_fraction * 100.0; }
+  constexpr double fineness() const { return m_fraction * 1000.0; }
+  constexpr double karat() const { return m_fraction * 24.0; }
+
+  // Pure (24K) metal in `weight` of this purity, and the reverse
+  constexpr double toFine(double weight) const { return weight * m_fraction; }
+  constexpr double fromFine(double fine) const {
+    return m_fraction > 0 ? fine / m_fraction : 0.0;
+  }
+
+  constexpr bool operator==(const Purity &o) const {
+    return m_fraction == o.m_fraction;
+  }
+
+  // For the *_fineness columns: parse(text).fineness(), NULL when invalid
+  static QVariant finenessOf(const QString &text);
+
+private:
+  constexpr explicit Purity(double fraction) : m_fraction(fraction) {}
+
+  double m_fraction = 0;
+};
+
+namespace Karat {
+
+struct Grade {
+  int karat;
+  double factor; // final purity, as a fraction
+  double loss;   // weight kept after making losses, as a fraction
+};
+
+// Highest karat first, the order the catalog lists them in
+constexpr Grade kGrades[] = {
+    {24, 1.0000, 0.85}, {22, 0.9346, 0.90}, {20, 0.8692, 0.85},
+    {18, 0.8047, 0.85}, {14, 0.6710, 0.83}, {12, 0.6346, 0.82},
+    {10, 0.5963, 0.80}, {9, 0.5766, 0.80},  {6, 0.5234, 0.78},
+    {2, 0.4766, 0.75}};
+constexpr int kGradeCount = int(sizeof(kGrades) / sizeof(kGrades[0]));
+
+constexpr const Grade *grade(int karat) {
+  for (const Grade &g : kGrades) {
+    if (g.karat == karat)
+      return &g;
+  }
+  return nullptr;
+}
+
+// Final purity factor of `karat`; nominal (karat / 24) off the chart
+constexpr double factor(int karat) {
+  const Grade *g = grade(karat);
+  return g ? g->factor : karat / 24.0;
+}
+
+static_assert(factor(24) == 1.0 && factor(18) == 0.8047 &&
+                  factor(16) == 16.0 / 24,
+              "karat chart lookup");
+
+// ---------- Batch kernels ----------
+// Plain loops over arrays, for converting whole columns at once.
+
+// out[i] = fine metal in weights[i] at purities[i] (fractions)
+inline void toFine(const double *weights, const double *fractions, double *out,
+                   int n) {
+  for (int i = 0; i < n; ++i)
+    out[i] = weights[i] * fractions[i];
+}
+
+// out[i] = weight at `purity` holding fine[i]
+inline void fromFine(const double *fine, Purity purity, double *out, int n) {
+  const double f = purity.fraction();
+  const double inv = f > 0 ? 1.0 / f : 0.0;
+  for (int i = 0; i < n; ++i)
+    out[i] = fine[i] * inv;
+}
+
+// out[i] = karat of each fineness[i] (parts per thousand)
+inline void finenessToKarat(const double *fineness, double *out, int n) {
+  for (int i = 0; i < n; ++i)
+    out[i] = fineness[i] * (24.0 / 1000.0);
+}
+
+// `weight` made at `karat`, restated at every chart grade through the
+// final purity factors: out[g] for kGrades[g], kGradeCount values
+inline void toGrades(int karat, double weight, double *out) {
+  const double f = factor(karat);
+  const double base = f > 0 ? weight / f : 0.0;
+  for (int g = 0; g < kGradeCount; ++g)
+    out[g] = base * kGrades[g].factor;
+}
+
+} // namespace Karat
+
+#endif // PURITY_H
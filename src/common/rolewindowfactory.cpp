@@ -1,6 +1,14 @@
 #include "RoleWindowFactory.h"
 #include "common/SessionManager.h"
 
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMdiArea>
+#include <QPointer>
+#include <QTimer>
+
 // Include role-based windows
 #include "dashboards/adminwindow.h"
 #include "dashboards/accountantwindow.h"
@@ -8,6 +16,72 @@
 #include "dashboards/manufacturerwindow.h"
 #include "dashboards/sellerwindow.h"
 
+// ---------- Internal cache state ----------
+namespace {
+struct RoleWindowCache
+{
+    QHash<QString, QPointer<QWidget>> windows; // lower-case role -> window
+    QStringList lru;                           // most recently shown first
+    int limit = -1;                            // -1: not read yet
+    bool quitHooked = false;
+};
+
+RoleWindowCache &cache()
+{
+    static RoleWindowCache c;
+    return c;
+}
+
+QString keyFor(const QString &role)
+{
+    return role.toLower();
+}
+
+void hookQuit()
+{
+    auto &c = cache();
+    if (c.quitHooked || !qApp)
+        return;
+    QObject::connect(qApp, &QCoreApplication::aboutToQuit, qApp, &RoleWindowFactory::clear);
+    c.quitHooked = true;
+}
+
+// Whether the window still has forms open in its MDI area, which may hold
+// unsaved input
+bool hasOpenForms(const QWidget *w)
+{
+    const QList<QMdiArea *> areas = w->findChildren<QMdiArea *>();
+    for (const QMdiArea *area : areas) {
+        if (!area->subWindowList().isEmpty())
+            return true;
+    }
+    return false;
+}
+
+// Drop hidden windows, least recently shown first, until within the limit.
+// A window with open forms is kept over the limit until they are closed.
+void evictOverLimit()
+{
+    auto &c = cache();
+    for (int i = c.lru.size() - 1; i >= 0; --i) {
+        if (c.windows.size() <= RoleWindowFactory::cacheLimit())
+            break;
+
+        const QString key = c.lru.at(i);
+        QPointer<QWidget> w = c.windows.value(key);
+        if (w && w->isVisible())
+            continue; // never the one on screen
+        if (w && hasOpenForms(w))
+            continue;
+
+        c.windows.remove(key);
+        c.lru.removeAt(i);
+        if (w)
+            w->deleteLater();
+    }
+}
+} // namespace
+
 QWidget* RoleWindowFactory::create(const QString &role)
 {
     // Safety check
@@ -32,3 +106,108 @@ QWidget* RoleWindowFactory::create(const QString &role)
 
     return nullptr;
 }
+
+// ---------- Warm window cache ----------
+
+QWidget* RoleWindowFactory::acquire(const QString &role)
+{
+    auto &c = cache();
+    hookQuit();
+
+    const QString key = keyFor(role);
+    QPointer<QWidget> w = c.windows.value(key);
+    if (!w) {
+        w = create(role);
+        if (!w)
+            return nullptr;
+        c.windows.insert(key, w);
+    }
+
+    c.lru.removeAll(key);
+    c.lru.prepend(key);
+    return w;
+}
+
+bool RoleWindowFactory::switchTo(QWidget *current, const QString &role)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const bool wasCached = cache().windows.value(keyFor(role));
+    QWidget *next = acquire(role);
+    if (!next)
+        return false;
+
+    if (next != current) {
+        next->show();
+        next->raise();
+        next->activateWindow();
+
+        // Hidden, not closed: its MDI state is kept for the way back
+        if (current)
+            current->hide();
+    }
+    evictOverLimit();
+
+    qInfo() << "[perf] Switched to" << role << (wasCached ? "(warm)" : "(built)")
+            << "in" << timer.elapsed() << "ms";
+    return true;
+}
+
+void RoleWindowFactory::prewarm(const QStringList &roles)
+{
+    QStringList pending;
+    for (const QString &role : roles) {
+        if (!cache().windows.value(keyFor(role)))
+            pending << role;
+    }
+    if (pending.isEmpty() || !qApp)
+        return;
+
+    // One window per event-loop pass so the visible one stays responsive
+    const QString role = pending.takeFirst();
+    QTimer::singleShot(0, qApp, [role, pending]() {
+        auto &c = cache();
+        const QString key = keyFor(role);
+
+        if (SessionManager::isLoggedIn() && !c.windows.value(key)
+            && c.windows.size() < cacheLimit()) {
+            QElapsedTimer timer;
+            timer.start();
+            if (QWidget *w = create(role)) {
+                hookQuit();
+                c.windows.insert(key, w);
+                c.lru.removeAll(key);
+                c.lru.append(key); // not shown yet: first to go
+                qInfo() << "[perf] Pre-built" << role << "window in" << timer.elapsed() << "ms";
+            }
+        }
+        prewarm(pending);
+    });
+}
+
+void RoleWindowFactory::setCacheLimit(int limit)
+{
+    cache().limit = qMax(1, limit);
+    evictOverLimit();
+}
+
+int RoleWindowFactory::cacheLimit()
+{
+    auto &c = cache();
+    if (c.limit < 0) {
+        bool ok = false;
+        const int fromEnv = qEnvironmentVariableIntValue("LUXEMINE_ROLE_WINDOW_CACHE", &ok);
+        c.limit = ok ? qMax(1, fromEnv) : 3;
+    }
+    return c.limit;
+}
+
+void RoleWindowFactory::clear()
+{
+    auto &c = cache();
+    for (const QPointer<QWidget> &w : std::as_const(c.windows))
+        delete w.data();
+    c.windows.clear();
+    c.lru.clear();
+}
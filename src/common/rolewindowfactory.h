@@ -3,11 +3,34 @@
 
 #include <QWidget>
 #include <QString>
+#include <QStringList>
 
 class RoleWindowFactory
 {
 public:
+    // Always builds a new window
     static QWidget* create(const QString &role);
+
+    // -------- Warm window cache --------
+    // Role windows are kept alive (hidden) after a switch, so their MDI
+    // sub-windows and loaded lists are still there when the user comes back.
+
+    // Cached window for role, built on first use
+    static QWidget* acquire(const QString &role);
+
+    // Show the window for role and hide current (which stays cached)
+    static bool switchTo(QWidget *current, const QString &role);
+
+    // Build the given roles' windows one by one while the app is idle
+    static void prewarm(const QStringList &roles);
+
+    // Maximum number of role windows kept alive, visible one included.
+    // Default 3, or LUXEMINE_ROLE_WINDOW_CACHE; 1 keeps nothing warm.
+    static void setCacheLimit(int limit);
+    static int cacheLimit();
+
+    // Delete every cached window (logout / quit)
+    static void clear();
 };
 
 #endif // ROLEWINDOWFACTORY_H
@@ -0,0 +1,118 @@
+#include "startuppipeline.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QHash>
+#include <QMutexLocker>
+#include <QThread>
+#include <QThreadPool>
+
+#include <functional>
+
+#include "common/sessionmanager.h"
+#include "database/databasemanager.h"
+#include "database/databaseutils.h"
+#include "database/jobsheetcache.h"
+#include "designer/shapesizedelegate.h"
+
+namespace {
+// Job sheets warmed for the top of a manufacturer's jobs list
+constexpr int kPrefetchJobSheets = 3;
+
+void runOnUiThread(std::function<void()> fn) {
+  QMetaObject::invokeMethod(qApp, std::move(fn), Qt::QueuedConnection);
+}
+} // namespace
+
+StartupPipeline &StartupPipeline::instance() {
+  static StartupPipeline pipeline;
+  return pipeline;
+}
+
+void StartupPipeline::begin() { m_clock.start(); }
+
+void StartupPipeline::startBackground() {
+  QThreadPool::globalInstance()->start([this]() {
+    // ---------- 1. Schema (tables, migrations, seeds) ----------
+    const bool ok = stage("schema", []() {
+      return DatabaseManager::instance().ensureSchema();
+    });
+    m_schemaReady = ok;
+    runOnUiThread([this, ok]() { emit schemaReady(ok); });
+    if (!ok)
+      return;
+
+    // ---------- 2. Reference data (diamond / stone shapes and sizes) ----
+    stage("reference-data", []() {
+      for (const QString type : {"diamond", "stone"}) {
+        const QStringList shapes = DatabaseUtils::fetchShapes(type);
+        QHash<QString, QStringList> sizes;
+        for (const QString &shape : shapes)
+          sizes.insert(shape, DatabaseUtils::fetchSizes(type, shape));
+
+        // The shared models are QObjects owned by the GUI thread
+        runOnUiThread([type, shapes, sizes]() {
+          ShapeSizeModels::seed(type, shapes, sizes);
+        });
+      }
+      return true;
+    });
+
+    runOnUiThread([this]() { report(); });
+  });
+}
+
+void StartupPipeline::prefetchForRole(const QString &role) {
+  const QString r = role.toLower();
+  const int userId = SessionManager::currentUser().id;
+
+  // The list widgets still run their own query when opened. Running it
+  // here first pulls the pages into the OS file cache, which is where a
+  // cold start on a slow disk loses its time.
+  QThreadPool::globalInstance()->start([this, r, userId]() {
+    stage("prefetch:" + r, [&]() {
+      if (r == "manufacturer") {
+        const QList<JobListData> jobs = DatabaseUtils::getJobsList();
+        QList<int> ids;
+        for (int i = 0; i < jobs.size() && i < kPrefetchJobSheets; ++i)
+          ids << jobs.at(i).jobId;
+        JobSheetCache::instance().prefetchAround(ids);
+        return jobs.size();
+      }
+      if (r == "designer")
+        return DatabaseUtils::getDesignerOrders().size();
+      if (r == "accountant")
+        return DatabaseUtils::getCastingList().size();
+      if (r == "seller")
+        return DatabaseUtils::getOrdersForSeller(userId).size();
+      if (r == "admin")
+        return DatabaseUtils::getAllOrders().size();
+      return qsizetype(0);
+    });
+    report(); // now including time to the first list
+  });
+}
+
+void StartupPipeline::mark(const QString &name) {
+  record(name, m_clock.elapsed(), 0);
+}
+
+void StartupPipeline::record(const QString &name, qint64 startMs,
+                             qint64 durationMs) {
+  const bool ui = QThread::currentThread() == qApp->thread();
+  QMutexLocker locker(&m_mutex);
+  m_stages.append({name, startMs, durationMs, ui});
+}
+
+void StartupPipeline::report() {
+  QMutexLocker locker(&m_mutex);
+
+  qInfo().noquote() << "[startup] ---- breakdown ----";
+  for (const Stage &s : std::as_const(m_stages)) {
+    qInfo().noquote() << QString("[startup] %1 %2 ms -> %3 ms  %4")
+                             .arg(s.name, -20)
+                             .arg(s.startMs, 6)
+                             .arg(s.startMs + s.durationMs, 6)
+                             .arg(s.onUiThread ? "ui" : "worker");
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef STARTUPPIPELINE_H
+#define STARTUPPIPELINE_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+
+// Staged startup. main() only opens the database and shows the login
+// window; schema checks, reference data and (after login) the user's main
+// list run on the thread pool. Every stage is timed and the breakdown is
+// logged as "[startup] ..." lines.
+class StartupPipeline : public QObject {
+  Q_OBJECT
+
+public:
+  static StartupPipeline &instance();
+
+  // t = 0 for every timing; call first thing in main()
+  void begin();
+
+  // Schema, then reference data, on a worker thread
+  void startBackground();
+  bool isSchemaReady() const { return m_schemaReady; }
+
+  // Warm the role's main list (and for manufacturers its first job sheets)
+  void prefetchForRole(const QString &role);
+
+  // Run fn as a named stage and record how long it took (any thread)
+  template <typename Fn> auto stage(const QString &name, Fn &&fn) {
+    const qint64 start = m_clock.elapsed();
+    QElapsedTimer timer;
+    timer.start();
+    auto result = fn();
+    record(name, start, timer.elapsed());
+    return result;
+  }
+
+  // Zero-length milestone, e.g. "login-shown"
+  void mark(const QString &name);
+
+  // Log every stage recorded so far
+  void report();
+
+signals:
+  // Emitted on the GUI thread once the schema stage is done
+  void schemaReady(bool ok);
+
+private:
+  StartupPipeline() = default;
+
+  struct Stage {
+    QString name;
+    qint64 startMs;
+    qint64 durationMs;
+    bool onUiThread;
+  };
+
+  void record(const QString &name, qint64 startMs, qint64 durationMs);
+
+  QElapsedTimer m_clock;
+  QMutex m_mutex;
+  QList<Stage> m_stages;
+  std::atomic_bool m_schemaReady{false};
+};
+
+#endif // STARTUPPIPELINE_H
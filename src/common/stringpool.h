@@ -0,0 +1,37 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QSet>
+#include <QString>
+
+// One shared copy of each distinct string seen during a list load.
+//
+// Every QSqlQuery::value().toString() is a fresh allocation, so 100k jobs
+// made at three metals and five purities held 100k copies of "Gold" and
+// "18K". QString is implicitly shared: handing out the pooled copy drops
+// the fresh one and leaves a reference count. Use one pool per load, on
+// the loading thread; the rows keep the strings after the pool is gone.
+class StringPool {
+public:
+  // The pooled copy of `s`, added on first sight. Empty stays null.
+  QString intern(const QString &s) {
+    if (s.isEmpty())
+      return QString();
+    auto it = m_strings.constFind(s);
+    if (it == m_strings.cend())
+      it = m_strings.insert(s);
+    return *it;
+  }
+
+  // For generic code walking a row's members: strings are pooled, other
+  // members are left alone
+  void internMember(QString &s) { s = intern(s); }
+  template <typename T> void internMember(T &) {}
+
+  qsizetype size() const { return m_strings.size(); }
+
+private:
+  QSet<QString> m_strings;
+};
+
+#endif // STRINGPOOL_H
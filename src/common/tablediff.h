@@ -0,0 +1,143 @@
+#ifndef TABLEDIFF_H
+#define TABLEDIFF_H
+
+#include <QHash>
+#include <QList>
+#include <QTableWidget>
+
+#include "common/listrows.h"
+
+// Keyed refresh for the QTableWidget lists. Instead of setRowCount(0) and a
+// rebuild, rows are matched by key (ListRow<Row>::key) and the table gets
+// only removeRow / insertRow for rows that went or came, and a render call
+// for rows whose data changed. Untouched rows keep their items, so scroll
+// position, selection and write-behind decorations survive a refresh.
+//
+// Every row carries its key as Qt::UserRole on column 0 (render() must set
+// it). Rows without one, such as a totals row, are removed.
+namespace TableDiff {
+
+constexpr int kKeyRole = Qt::UserRole;
+
+struct Stats {
+  int inserted = 0;
+  int removed = 0;
+  int changed = 0;
+  bool rebuilt = false; // keys were not unique; every row was rendered
+};
+
+namespace detail {
+inline bool keyAt(const QTableWidget *table, int row, int &key) {
+  const QTableWidgetItem *item = table->item(row, 0);
+  if (!item)
+    return false;
+  bool ok = false;
+  key = item->data(kKeyRole).toInt(&ok);
+  return ok;
+}
+} // namespace detail
+
+// Bring `table` from showing `before` to showing `after`.
+// render(int row, const Row &data) fills one row, creating missing items.
+// With sorting enabled new rows are appended and the table re-sorts them;
+// otherwise rows end up in the order of `after`.
+template <typename Row, typename Render>
+Stats apply(QTableWidget *table, const QList<Row> &before,
+            const QList<Row> &after, Render &&render) {
+  Stats stats;
+
+  const bool wasBlocked = table->blockSignals(true);
+  const bool sorting = table->isSortingEnabled();
+  table->setSortingEnabled(false); // sorting would move rows under our feet
+
+  QHash<int, int> beforeAt; // key -> index in `before`
+  for (int i = 0; i < before.size(); ++i)
+    beforeAt.insert(ListRow<Row>::key(before.at(i)), i);
+
+  QHash<int, int> afterAt; // key -> index in `after`
+  for (int i = 0; i < after.size(); ++i)
+    afterAt.insert(ListRow<Row>::key(after.at(i)), i);
+
+  if (afterAt.size() != after.size()) {
+    // Duplicate keys (e.g. two casting entries for one job): rebuild
+    table->setRowCount(0);
+    table->setRowCount(after.size());
+    for (int i = 0; i < after.size(); ++i)
+      render(i, after.at(i));
+    stats.rebuilt = true;
+  } else {
+    // ---------- 1. Remove rows whose key is gone (or repeats) ----------
+    QList<int> current; // keys in table order
+    QHash<int, bool> present;
+    for (int row = table->rowCount() - 1; row >= 0; --row) {
+      int key = 0;
+      if (!detail::keyAt(table, row, key) || !afterAt.contains(key) ||
+          present.contains(key)) {
+        table->removeRow(row);
+        ++stats.removed;
+      } else {
+        current.prepend(key);
+        present.insert(key, true);
+      }
+    }
+
+    // Re-render a kept row only when its data differs
+    auto refresh = [&](int row, int key) {
+      const auto it = beforeAt.constFind(key);
+      const Row &data = after.at(afterAt.value(key));
+      if (it != beforeAt.constEnd() && sameListRow(before.at(*it), data))
+        return;
+      render(row, data);
+      ++stats.changed;
+    };
+
+    if (sorting) {
+      // ---------- 2a. Update in place, append the new ones ----------
+      QHash<int, int> rowOf;
+      for (int row = 0; row < current.size(); ++row)
+        rowOf.insert(current.at(row), row);
+      for (const Row &r : after) {
+        const int key = ListRow<Row>::key(r);
+        const auto it = rowOf.constFind(key);
+        if (it != rowOf.constEnd()) {
+          refresh(*it, key);
+        } else {
+          const int row = table->rowCount();
+          table->insertRow(row);
+          render(row, r);
+          ++stats.inserted;
+        }
+      }
+    } else {
+      // ---------- 2b. Walk `after`, inserting and moving as needed --------
+      for (int i = 0; i < after.size(); ++i) {
+        const int key = ListRow<Row>::key(after.at(i));
+        if (i < current.size() && current.at(i) == key) {
+          refresh(i, key);
+          continue;
+        }
+
+        if (present.contains(key)) {
+          // Moved up (e.g. a new delivery date); rare, so a linear find
+          const int from = current.indexOf(key, i + 1);
+          table->removeRow(from);
+          current.removeAt(from);
+          ++stats.removed;
+        }
+        table->insertRow(i);
+        current.insert(i, key);
+        present.insert(key, true);
+        render(i, after.at(i));
+        ++stats.inserted;
+      }
+    }
+  }
+
+  table->setSortingEnabled(sorting);
+  table->blockSignals(wasBlocked);
+  return stats;
+}
+
+} // namespace TableDiff
+
+#endif // TABLEDIFF_H
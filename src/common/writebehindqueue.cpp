@@ -0,0 +1,206 @@
+#include "writebehindqueue.h"
+
+#include <QApplication>
+#include <QColor>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QMessageBox>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTableWidget>
+
+#include "database/databasemanager.h"
+#include "database/writetransaction.h"
+
+namespace {
+// Pause in typing before the batch is written
+constexpr int kDebounceMs = 600;
+
+// Automatic retries of a failed row (1 s, 2 s, 4 s), then it waits for the
+// next flush
+constexpr int kMaxAutoRetries = 3;
+} // namespace
+
+WriteBehindQueue::WriteBehindQueue(QWidget *scope, QObject *parent)
+    : QObject(parent), m_scope(scope) {
+  m_debounce.setSingleShot(true);
+  m_debounce.setInterval(kDebounceMs);
+  connect(&m_debounce, &QTimer::timeout, this, &WriteBehindQueue::flush);
+
+  m_retry.setSingleShot(true);
+  connect(&m_retry, &QTimer::timeout, this, &WriteBehindQueue::flush);
+
+  if (m_scope)
+    m_scope->installEventFilter(this);
+  connect(qApp, &QApplication::focusChanged, this,
+          &WriteBehindQueue::onFocusChanged);
+  connect(qApp, &QCoreApplication::aboutToQuit, this,
+          &WriteBehindQueue::flushFinal);
+}
+
+WriteBehindQueue::~WriteBehindQueue() {
+  // The grid is going away; write what is left without telling it
+  blockSignals(true);
+  flushFinal();
+}
+
+void WriteBehindQueue::enqueue(const QString &row, const QString &field,
+                               Write write) {
+  Row &r = m_rows[row];
+  r.fields.insert(field, std::move(write));
+  r.attempts = 0; // a fresh edit gets a fresh set of retries
+
+  emit stateChanged(row, field, State::Pending);
+  m_debounce.start();
+}
+
+void WriteBehindQueue::flush() {
+  m_debounce.stop();
+  m_retry.stop();
+  if (m_rows.isEmpty() || m_flushing)
+    return;
+  m_flushing = true;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  QMap<QString, Row> batch;
+  batch.swap(m_rows);
+
+  QSqlDatabase db = DatabaseManager::instance().database();
+  WriteTransaction tx(db, "WriteBehindQueue");
+  const bool inTransaction = tx.begin();
+
+  // ---------- Write each row under its own savepoint ----------
+  QStringList written, failed;
+  QSqlQuery sp(db);
+  for (auto it = batch.begin(); it != batch.end(); ++it) {
+    bool ok = inTransaction && sp.exec("SAVEPOINT write_behind_row");
+    for (auto f = it->fields.cbegin(); ok && f != it->fields.cend(); ++f)
+      ok = f.value()();
+
+    if (ok) {
+      sp.exec("RELEASE write_behind_row");
+      written << it.key();
+    } else {
+      if (inTransaction) {
+        sp.exec("ROLLBACK TO write_behind_row");
+        sp.exec("RELEASE write_behind_row");
+      }
+      failed << it.key();
+    }
+  }
+
+  if (inTransaction && !tx.commit()) {
+    failed << written;
+    written.clear();
+  }
+
+  qInfo() << "[perf] Write-behind flushed" << written.size() << "rows,"
+          << failed.size() << "failed, in" << timer.elapsed() << "ms";
+
+  // ---------- Report; failed rows go back on the queue ----------
+  m_flushing = false;
+  for (const QString &key : std::as_const(written)) {
+    for (auto f = batch[key].fields.cbegin(); f != batch[key].fields.cend();
+         ++f)
+      emit stateChanged(key, f.key(), State::Saved);
+  }
+
+  int nextAttempt = kMaxAutoRetries + 1;
+  for (const QString &key : std::as_const(failed)) {
+    Row r = batch.take(key);
+    r.attempts += 1;
+    nextAttempt = qMin(nextAttempt, r.attempts);
+    for (auto f = r.fields.cbegin(); f != r.fields.cend(); ++f)
+      emit stateChanged(key, f.key(), State::Failed);
+    m_rows.insert(key, r);
+  }
+
+  if (nextAttempt <= kMaxAutoRetries)
+    m_retry.start(1000 << (nextAttempt - 1));
+}
+
+bool WriteBehindQueue::confirmClose(QWidget *parent) {
+  for (;;) {
+    flush();
+    if (m_rows.isEmpty())
+      return true;
+
+    const auto choice = QMessageBox::warning(
+        parent, "Edits not saved",
+        QString("These edits could not be saved:\n\n%1\n\nRetry now, or "
+                "discard them and close?")
+            .arg(pendingRows().join("\n")),
+        QMessageBox::Retry | QMessageBox::Discard | QMessageBox::Cancel,
+        QMessageBox::Retry);
+    if (choice == QMessageBox::Cancel)
+      return false;
+    if (choice == QMessageBox::Discard) {
+      qCritical() << "Write-behind: unsaved edits discarded:" << pendingRows();
+      m_rows.clear();
+      m_retry.stop();
+      return true;
+    }
+  }
+}
+
+void WriteBehindQueue::flushFinal() {
+  flush();
+  if (m_rows.isEmpty())
+    return;
+
+  // No later flush will come for these
+  qCritical() << "Write-behind: unsaved edits dropped:" << pendingRows();
+  m_rows.clear();
+  m_retry.stop();
+}
+
+QStringList WriteBehindQueue::pendingRows() const {
+  QStringList rows;
+  for (auto it = m_rows.cbegin(); it != m_rows.cend(); ++it)
+    rows << QString("%1: %2").arg(it.key(), it->fields.keys().join(", "));
+  return rows;
+}
+
+void WriteBehindQueue::decorate(QTableWidgetItem *item, State state) {
+  if (!item)
+    return;
+
+  const QSignalBlocker blocker(item->tableWidget());
+  switch (state) {
+  case State::Pending:
+    item->setData(Qt::BackgroundRole, QColor(255, 193, 7, 60));
+    item->setToolTip("Saving...");
+    break;
+  case State::Failed:
+    item->setData(Qt::BackgroundRole, QColor(220, 53, 69, 90));
+    item->setToolTip("Not saved yet, will retry. Edit the cell again or "
+                     "move focus away to retry now.");
+    break;
+  case State::Saved:
+    item->setData(Qt::BackgroundRole, QVariant());
+    item->setToolTip(QString());
+    break;
+  }
+}
+
+bool WriteBehindQueue::eventFilter(QObject *watched, QEvent *event) {
+  if (watched == m_scope && event->type() == QEvent::Hide)
+    flush();
+  return QObject::eventFilter(watched, event);
+}
+
+void WriteBehindQueue::onFocusChanged(QWidget *old, QWidget *now) {
+  if (!m_scope || m_rows.isEmpty() || !old)
+    return;
+
+  auto inScope = [this](QWidget *w) {
+    return w && (w == m_scope || m_scope->isAncestorOf(w));
+  };
+  // The cell editor is a child of the grid, so editing does not count
+  if (inScope(old) && !inScope(now))
+    flush();
+}
@@ -0,0 +1,80 @@
+#ifndef WRITEBEHINDQUEUE_H
+#define WRITEBEHINDQUEUE_H
+
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+class QTableWidgetItem;
+class QWidget;
+
+// Write-behind buffer for editable grids. Cell edits are queued per row
+// and field, a newer edit of the same cell replacing the older one, and
+// are written together in one transaction once typing pauses, focus
+// leaves the grid, the grid is hidden or a reload is about to discard the
+// cells. Each row is its own savepoint so one bad row does not lose the
+// rest; failed rows stay queued and are retried with backoff. The owning
+// widget calls confirmClose() from its closeEvent, which lists rows still
+// failing and offers a retry; rows left when the queue goes away or the
+// app quits are logged, not dropped silently.
+class WriteBehindQueue : public QObject {
+  Q_OBJECT
+
+public:
+  enum class State { Pending, Saved, Failed };
+  Q_ENUM(State)
+
+  // Runs on the GUI thread inside the flush transaction; false = failed
+  using Write = std::function<bool()>;
+
+  // `scope` is the grid whose focus and visibility trigger a flush
+  explicit WriteBehindQueue(QWidget *scope, QObject *parent = nullptr);
+  ~WriteBehindQueue() override;
+
+  void enqueue(const QString &row, const QString &field, Write write);
+
+  // Write everything queued now
+  void flush();
+
+  bool hasPending() const { return !m_rows.isEmpty(); }
+
+  // Flush before the owner closes. Rows still failing are listed with
+  // Retry, Discard and Cancel; false on Cancel, the owner stays open.
+  bool confirmClose(QWidget *parent);
+
+  // Tint and tooltip for a cell in the given state (signals blocked, so
+  // the grid's own itemChanged handler does not see it as an edit)
+  static void decorate(QTableWidgetItem *item, State state);
+
+signals:
+  void stateChanged(const QString &row, const QString &field,
+                    WriteBehindQueue::State state);
+
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+  struct Row {
+    QMap<QString, Write> fields;
+    int attempts = 0;
+  };
+
+  void onFocusChanged(QWidget *old, QWidget *now);
+  // Last flush: anything still failing is logged and dropped. Nothing
+  // modal, the owner may be half torn down or the app quitting.
+  void flushFinal();
+  // "row: field, field" for each queued row
+  QStringList pendingRows() const;
+
+  QPointer<QWidget> m_scope;
+  QTimer m_debounce;
+  QTimer m_retry;
+  QMap<QString, Row> m_rows; // ordered, so batches write in a stable order
+  bool m_flushing = false;
+};
+
+#endif // WRITEBEHINDQUEUE_H
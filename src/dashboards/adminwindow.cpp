@@ -105,15 +105,9 @@ void AdminWindow::changeRole() {
   // 4️⃣ Update session
   SessionManager::setActiveRole(newRole);
 
-  // 5️⃣ Open new role window
-  QWidget *nextWindow = RoleWindowFactory::create(newRole);
-  if (!nextWindow)
-    return;
-
-  nextWindow->show();
-
-  // 6️⃣ Close current window
-  this->close();
+  // 5️⃣ Show the new role's window; this one is hidden but kept
+  // warm so switching back restores it as it was
+  RoleWindowFactory::switchTo(this, newRole);
 }
 
 void AdminWindow::openOrderList() {
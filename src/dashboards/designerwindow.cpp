@@ -59,13 +59,9 @@ void DesignerWindow::changeRole() {
 
   // 4 Update session
   SessionManager::setActiveRole(newRole);
-  // 5 Open new role window
-  QWidget *nextWindow = RoleWindowFactory::create(newRole);
-  if (!nextWindow)
-    return;
-  nextWindow->show();
-  // 6 Close current window
-  this->close();
+  // 5 Show the new role's window; this one is hidden but kept
+  // warm so switching back restores it as it was
+  RoleWindowFactory::switchTo(this, newRole);
 }
 
 void DesignerWindow::openAddCatalog() {
@@ -0,0 +1,22 @@
+#include "changenotifier.h"
+#include "querycache.h"
+
+#include <QCoreApplication>
+
+ChangeNotifier &ChangeNotifier::instance() {
+  // May first be reached from a worker; receivers expect the GUI thread
+  static ChangeNotifier *notifier = []() {
+    auto *n = new ChangeNotifier;
+    n->moveToThread(qApp->thread());
+    return n;
+  }();
+  return *notifier;
+}
+
+void ChangeNotifier::notify(const QString &table, int id,
+                            const QStringList &columns) {
+  if (columns.isEmpty())
+    return;
+  QueryCache::instance().bump(table);
+  emit instance().rowChanged(table, id, columns);
+}
@@ -0,0 +1,29 @@
+#ifndef CHANGENOTIFIER_H
+#define CHANGENOTIFIER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+// Row-level change notifications from the repository. DatabaseUtils emits
+// rowChanged() after a successful partial UPDATE with the columns it
+// actually wrote, so an open list only reloads when something it shows
+// has changed. Lives on the GUI thread; emits from workers are queued.
+class ChangeNotifier : public QObject {
+  Q_OBJECT
+
+public:
+  static ChangeNotifier &instance();
+
+  // Emit rowChanged() (any thread) and bump the table's QueryCache
+  // version; nothing happens for an empty list
+  static void notify(const QString &table, int id, const QStringList &columns);
+
+signals:
+  void rowChanged(const QString &table, int id, const QStringList &columns);
+
+private:
+  ChangeNotifier() = default;
+};
+
+#endif // CHANGENOTIFIER_H
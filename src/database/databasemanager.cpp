@@ -1,10 +1,21 @@
 #include "DatabaseManager.h"
+#include "common/dates.h"
+#include "common/purity.h"
+#include "databaseutils.h"
+#include "sqlfunctions.h"
+#include "writetransaction.h"
 
 #include <QCryptographicHash>
 #include <QDebug>
 #include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QStringList>
+#include <QThread>
+#include <QVersionNumber>
 
 DatabaseManager &DatabaseManager::instance() {
   static DatabaseManager instance;
@@ -19,13 +30,17 @@ DatabaseManager::~DatabaseManager() {
   }
 }
 
-bool DatabaseManager::initialize() {
+bool DatabaseManager::initialize() { return open() && ensureSchema(); }
+
+bool DatabaseManager::open() {
   if (QSqlDatabase::contains("LuxeMineConnection")) {
     m_db = QSqlDatabase::database("LuxeMineConnection");
+    m_ownerThread = QThread::currentThread();
     return true;
   }
 
   m_db = QSqlDatabase::addDatabase("QSQLITE", "LuxeMineConnection");
+  m_ownerThread = QThread::currentThread();
 
   // Create data directory if not exists
   QDir dir(QDir::currentPath());
@@ -37,18 +52,71 @@ bool DatabaseManager::initialize() {
   QString dbPath = dir.filePath("data/luxemine.db");
   m_db.setDatabaseName(dbPath);
 
+  // Startup and prefetch work reads on worker connections while the UI
+  // writes, and other workstations write to the same file; wait for the
+  // lock instead of failing with SQLITE_BUSY. Worker clones inherit this.
+  // LUXEMINE_BUSY_TIMEOUT_MS overrides the default for slow shared drives.
+  bool ok = false;
+  int busyTimeoutMs = qEnvironmentVariableIntValue("LUXEMINE_BUSY_TIMEOUT_MS",
+                                                   &ok);
+  if (!ok || busyTimeoutMs < 0)
+    busyTimeoutMs = 5000;
+  m_db.setConnectOptions(
+      QString("QSQLITE_BUSY_TIMEOUT=%1").arg(busyTimeoutMs));
+
   if (!m_db.open()) {
     qCritical() << "Database open failed:" << m_db.lastError().text();
     return false;
   }
 
-  return createTables();
+  // fine_wt(), gross_loss() and friends for report queries
+  SqlFunctions::install(m_db);
+  return true;
+}
+
+bool DatabaseManager::ensureSchema() {
+  QSqlDatabase db = database();
+
+  // One transaction: a first run creates everything with a single sync
+  // instead of one per statement
+  WriteTransaction tx(db, "ensureSchema");
+  if (!tx.begin())
+    return false;
+  if (!createTables(db)) {
+    tx.rollback();
+    return false;
+  }
+  return tx.commit();
 }
 
-QSqlDatabase DatabaseManager::database() const { return m_db; }
+QSqlDatabase DatabaseManager::database() const {
+  QThread *current = QThread::currentThread();
+  if (!m_db.isValid() || current == m_ownerThread)
+    return m_db;
+
+  // QSqlDatabase connections are bound to the thread that created them.
+  // Background loaders get a lazily created clone of the main connection,
+  // dropped again when their thread finishes.
+  const QString name = QStringLiteral("LuxeMineConnection_%1")
+                           .arg(reinterpret_cast<quintptr>(current), 0, 16);
+  if (QSqlDatabase::contains(name))
+    return QSqlDatabase::database(name);
+
+  QSqlDatabase db = QSqlDatabase::cloneDatabase(m_db.connectionName(), name);
+  if (!db.open()) {
+    qCritical() << "Worker database open failed:" << db.lastError().text();
+  } else {
+    SqlFunctions::install(db); // registered per connection
+  }
 
-bool DatabaseManager::createTables() {
-  QSqlQuery query(m_db);
+  QObject::connect(current, &QThread::finished, current,
+                   [name]() { QSqlDatabase::removeDatabase(name); },
+                   Qt::DirectConnection);
+  return db;
+}
+
+bool DatabaseManager::createTables(QSqlDatabase db) {
+  QSqlQuery query(db);
 
   // -----------------------------
   // USERS (login only)
@@ -377,10 +445,10 @@ bool DatabaseManager::createTables() {
   // (simple way) or just try blindly (ignoring specific error). Safest way
   // without complex pragma parsing: try to select it, if fails, add it.
   {
-    QSqlQuery check(m_db);
+    QSqlQuery check(db);
     if (!check.exec("SELECT dia_price FROM casting_entry LIMIT 1")) {
       // Column likely missing
-      QSqlQuery addCol(m_db);
+      QSqlQuery addCol(db);
       if (!addCol.exec("ALTER TABLE casting_entry ADD COLUMN dia_price REAL "
                        "DEFAULT 0")) {
         qWarning()
@@ -394,11 +462,11 @@ bool DatabaseManager::createTables() {
 
   // Migration for new columns (Stone + Diamond Category)
   {
-    QSqlQuery check(m_db);
+    QSqlQuery check(db);
     // Check if one of the new columns exists
     if (!check.exec(
             "SELECT issue_diamond_category FROM casting_entry LIMIT 1")) {
-      QSqlQuery add(m_db);
+      QSqlQuery add(db);
       bool ok = true;
       ok &= add.exec(
           "ALTER TABLE casting_entry ADD COLUMN issue_diamond_category TEXT");
@@ -460,6 +528,49 @@ bool DatabaseManager::createTables() {
   query.exec("ALTER TABLE jobsheet_detail ADD COLUMN office_gold_receive TEXT");
   query.exec(
       "ALTER TABLE jobsheet_detail ADD COLUMN manufacturer_mfg_receive TEXT");
+  // office_receive used to be added by getJobsList() on every list load
+  query.exec("ALTER TABLE jobsheet_detail ADD COLUMN office_receive REAL "
+             "DEFAULT 0");
+
+  // The single weights of a job sheet, written as text ("12.345"), also
+  // kept as whole milligrams (<column>_mg) that sum exactly. Triggers
+  // derive them from the text on every insert and update, so writers,
+  // older builds sharing the file included, only write the text. Existing
+  // values are converted when the column is added.
+  const QString toMg = "CASE WHEN TRIM(COALESCE(NEW.%1, '')) <> '' "
+                       "THEN CAST(ROUND(CAST(NEW.%1 AS REAL) * 1000) "
+                       "AS INTEGER) END";
+  QStringList insertMg;
+  for (const char *column : DatabaseUtils::kJobSheetWeightColumns) {
+    if (query.exec(QString("ALTER TABLE jobsheet_detail ADD COLUMN %1_mg "
+                           "INTEGER")
+                       .arg(column))) {
+      query.exec(QString("UPDATE jobsheet_detail SET %1_mg = "
+                         "CAST(ROUND(CAST(%1 AS REAL) * 1000) AS INTEGER) "
+                         "WHERE TRIM(COALESCE(%1, '')) <> ''")
+                     .arg(column));
+    }
+    insertMg << QString("%1_mg = %2").arg(column, toMg.arg(column));
+    if (!query.exec(QString("CREATE TRIGGER IF NOT EXISTS "
+                            "trg_jobsheet_%1_mg AFTER UPDATE OF %1 "
+                            "ON jobsheet_detail BEGIN "
+                            "UPDATE jobsheet_detail SET %1_mg = %2 "
+                            "WHERE rowid = NEW.rowid; END")
+                        .arg(column, toMg.arg(column)))) {
+      qCritical() << "jobsheet_detail milligram trigger error:" << column
+                  << query.lastError();
+      return false;
+    }
+  }
+  if (!query.exec(QString("CREATE TRIGGER IF NOT EXISTS trg_jobsheet_mg_ins "
+                          "AFTER INSERT ON jobsheet_detail BEGIN "
+                          "UPDATE jobsheet_detail SET %1 "
+                          "WHERE rowid = NEW.rowid; END")
+                      .arg(insertMg.join(", ")))) {
+    qCritical() << "jobsheet_detail milligram trigger error:"
+                << query.lastError();
+    return false;
+  }
 
   // -----------------------------
   // METAL PURCHASE (Accountant)
@@ -509,36 +620,88 @@ bool DatabaseManager::createTables() {
     return false;
   }
 
+  // -----------------------------
+  // LEDGER FORMULAS (per-shop overrides, see LedgerFormulas)
+  // -----------------------------
+  if (!query.exec(R"(
+        CREATE TABLE IF NOT EXISTS ledger_formulas (
+            ledger TEXT NOT NULL,
+            name TEXT NOT NULL,
+            expression TEXT NOT NULL,
+            PRIMARY KEY (ledger, name)
+        );
+    )")) {
+    qCritical() << "ledger_formulas table error:" << query.lastError();
+    return false;
+  }
+
+  // -----------------------------
+  // ROW VERSIONS (optimistic concurrency)
+  // -----------------------------
+  // Bumped by every update; edits write "WHERE id = ? AND row_version = ?"
+  // so a save over someone else's newer row is detected, not lost.
+  // Fails harmlessly once the column exists.
+  for (const char *table :
+       {"order_book_detail", "casting_entry", "jobsheet_detail"}) {
+    query.exec(QString("ALTER TABLE %1 ADD COLUMN row_version INTEGER NOT "
+                       "NULL DEFAULT 0")
+                   .arg(table));
+  }
+
+  // -----------------------------
+  // NUMERIC PURITY
+  // -----------------------------
+  // The purity texts ("18K (75%)") as a fineness in parts per thousand, so
+  // lists and loss formulas read a number instead of parsing text per row.
+  // New writes fill them through RowMapper::derived().
+  if (!addFinenessColumn(db, "order_book_detail", "metalPurity",
+                         "metalFineness") ||
+      !addFinenessColumn(db, "casting_entry", "issue_metal_purity",
+                         "issue_metal_fineness"))
+    return false;
+
+  // -----------------------------
+  // ISO DATES + DATE INDEXES
+  // -----------------------------
+  if (!normalizeDates(db))
+    return false;
+
+  // -----------------------------
+  // UNIQUE KEYS FOR UPSERTS
+  // -----------------------------
+  if (!createUpsertKeys(db))
+    return false;
+
+  // -----------------------------
+  // INDEXED LOSS COLUMNS
+  // -----------------------------
+  // Net weight, gross loss and loss % kept in SQL, so sorting and filtering
+  // by them is an index scan (DatabaseUtils::getJobsByTotal)
+  if (!createLossColumns(db))
+    return false;
+
   // -----------------------------
   // SEED ROLES (SAFE)
   // -----------------------------
-  QStringList defaultRoles = {"admin", "seller", "designer", "manufacturer",
-                              "accountant"};
-
-  for (const QString &role : defaultRoles) {
-    QSqlQuery check(m_db);
-    check.prepare("SELECT COUNT(*) FROM roles WHERE name = ?");
-    check.addBindValue(role);
-    check.exec();
-    check.next();
-
-    if (check.value(0).toInt() == 0) {
-      QSqlQuery insert(m_db);
-      insert.prepare("INSERT INTO roles (name) VALUES (?)");
-      insert.addBindValue(role);
-      insert.exec();
-    }
+  // roles.name is UNIQUE, so one statement replaces the per-role
+  // SELECT COUNT / INSERT round trips
+  if (!query.exec(R"(
+        INSERT OR IGNORE INTO roles (name) VALUES
+            ('admin'), ('seller'), ('designer'), ('manufacturer'), ('accountant');
+    )")) {
+    qCritical() << "roles seed error:" << query.lastError();
+    return false;
   }
 
   // -----------------------------
   // DEFAULT ADMIN (DEV ONLY)
   // -----------------------------
-  QSqlQuery adminCheck(m_db);
+  QSqlQuery adminCheck(db);
   adminCheck.exec("SELECT COUNT(*) FROM users WHERE username='admin'");
   adminCheck.next();
 
   if (adminCheck.value(0).toInt() == 0) {
-    QSqlQuery insertAdmin(m_db);
+    QSqlQuery insertAdmin(db);
     insertAdmin.prepare(R"(
         INSERT INTO users (username, password_hash, is_active)
         VALUES ('admin', :pass, 1)
@@ -554,13 +717,13 @@ bool DatabaseManager::createTables() {
     int adminUserId = insertAdmin.lastInsertId().toInt();
 
     // Assign admin role
-    QSqlQuery roleQuery(m_db);
+    QSqlQuery roleQuery(db);
     roleQuery.exec("SELECT id FROM roles WHERE name='admin'");
     roleQuery.next();
 
     int adminRoleId = roleQuery.value(0).toInt();
 
-    QSqlQuery map(m_db);
+    QSqlQuery map(db);
     map.prepare("INSERT INTO user_roles (user_id, role_id) VALUES (?, ?)");
     map.addBindValue(adminUserId);
     map.addBindValue(adminRoleId);
@@ -569,3 +732,386 @@ bool DatabaseManager::createTables() {
 
   return true;
 }
+
+bool DatabaseManager::createUpsertKeys(QSqlDatabase db) {
+  QSqlQuery query(db);
+
+  auto hasObject = [&db](const QString &type, const QString &name) {
+    QSqlQuery q(db);
+    q.prepare("SELECT 1 FROM sqlite_master WHERE type = ? AND name = ?");
+    q.addBindValue(type);
+    q.addBindValue(name);
+    return q.exec() && q.next();
+  };
+
+  // jobsheet_detail: one row per job. The old UPDATE-then-INSERT code could
+  // leave duplicates; readers always took the lowest id, so keep that one.
+  if (!hasObject("index", "idx_jobsheet_detail_job_no")) {
+    if (!query.exec(R"(
+            DELETE FROM jobsheet_detail
+            WHERE id NOT IN (SELECT MIN(id) FROM jobsheet_detail GROUP BY job_no)
+        )") ||
+        !query.exec("CREATE UNIQUE INDEX idx_jobsheet_detail_job_no "
+                    "ON jobsheet_detail(job_no)")) {
+      qCritical() << "jobsheet_detail unique key error:" << query.lastError();
+      return false;
+    }
+  }
+
+  // image_data (catalog, created by the designer tooling): one live row per
+  // design number, soft-deleted rows excluded. `revision` lets an upsert
+  // report whether it inserted (0) or updated.
+  if (hasObject("table", "image_data") &&
+      !hasObject("index", "idx_image_data_live_design_no")) {
+    query.exec("ALTER TABLE image_data ADD COLUMN revision INTEGER NOT NULL "
+               "DEFAULT 0");
+    if (!query.exec(R"(
+            UPDATE image_data SET "delete" = 1
+            WHERE "delete" = 0
+              AND rowid NOT IN (SELECT MIN(rowid) FROM image_data
+                                WHERE "delete" = 0 GROUP BY design_no)
+        )") ||
+        !query.exec(R"(
+            CREATE UNIQUE INDEX idx_image_data_live_design_no
+            ON image_data(design_no) WHERE "delete" = 0
+        )")) {
+      qCritical() << "image_data unique key error:" << query.lastError();
+      return false;
+    }
+  }
+
+  // employee_payments (employee_id, month, year), seller_order_counter
+  // (seller_id) and roles (name) are already unique in their CREATE TABLE
+  return true;
+}
+
+bool DatabaseManager::addFinenessColumn(QSqlDatabase db, const QString &table,
+                                        const QString &textColumn,
+                                        const QString &column) {
+  QSqlQuery query(db);
+  if (query.exec(QString("SELECT %1 FROM %2 LIMIT 1").arg(column, table)))
+    return true; // already there
+
+  if (!query.exec(
+          QString("ALTER TABLE %1 ADD COLUMN %2 REAL").arg(table, column))) {
+    qCritical() << "Migration: could not add" << table << column
+                << query.lastError();
+    return false;
+  }
+
+  // Existing rows: each distinct text is parsed once
+  QStringList texts;
+  query.exec(QString("SELECT DISTINCT %1 FROM %2 WHERE %1 IS NOT NULL")
+                 .arg(textColumn, table));
+  while (query.next())
+    texts << query.value(0).toString();
+
+  QSqlQuery update(db);
+  update.prepare(QString("UPDATE %1 SET %2 = ? WHERE %3 = ?")
+                     .arg(table, column, textColumn));
+  for (const QString &text : texts) {
+    update.bindValue(0, Purity::finenessOf(text));
+    update.bindValue(1, text);
+    if (!update.exec()) {
+      qCritical() << "Migration: could not fill" << table << column
+                  << update.lastError();
+      return false;
+    }
+  }
+  qInfo() << "Migration: added" << column << "to" << table << "from"
+          << texts.size() << "purity texts";
+  return true;
+}
+
+bool DatabaseManager::normalizeDates(QSqlDatabase db) {
+  // Dates once came from widget display text, so some rows hold
+  // "05-03-2024" and sort wrong. Only values that do not already start
+  // like "2024-03-05" are read back, so after the first run this finds
+  // nothing.
+  static const struct {
+    const char *table;
+    const char *column;
+  } kDateColumns[] = {
+      {"order_book_detail", "orderDate"},
+      {"order_book_detail", "deliveryDate"},
+      {"casting_entry", "casting_date"},
+      {"metal_purchase_entry", "entry_date"},
+      {"stocks", "date"},
+  };
+
+  QSqlQuery query(db);
+  for (const auto &c : kDateColumns) {
+    const QString table = QLatin1String(c.table);
+    const QString column = QLatin1String(c.column);
+
+    QStringList odd;
+    query.exec(QString(R"(
+            SELECT DISTINCT "%1" FROM %2
+            WHERE "%1" <> ''
+              AND "%1" NOT GLOB '[0-9][0-9][0-9][0-9]-[0-9][0-9]-[0-9][0-9]*'
+        )")
+                   .arg(column, table));
+    while (query.next())
+      odd << query.value(0).toString();
+
+    QSqlQuery update(db);
+    update.prepare(QString("UPDATE %1 SET \"%2\" = ? WHERE \"%2\" = ?")
+                       .arg(table, column));
+    for (const QString &text : odd) {
+      const QString iso = Dates::normalized(text);
+      if (iso.isEmpty()) {
+        qWarning() << "Migration: unreadable date in" << table << column
+                   << text;
+        continue;
+      }
+      update.bindValue(0, iso);
+      update.bindValue(1, text);
+      if (!update.exec()) {
+        qCritical() << "Migration: could not rewrite dates in" << table
+                    << column << update.lastError();
+        return false;
+      }
+    }
+    if (!odd.isEmpty())
+      qInfo() << "Migration:" << odd.size() << "date forms rewritten in"
+              << table << column;
+
+    // "due this week", "purchases in March" and ORDER BY date use these
+    if (!query.exec(
+            QString("CREATE INDEX IF NOT EXISTS idx_%1_%2 ON %1(\"%2\")")
+                .arg(table, column))) {
+      qCritical() << "Date index error:" << table << column
+                  << query.lastError();
+      return false;
+    }
+  }
+
+  // Gold history entries in the job sheet carried "dd-MM-yyyy HH:mm:ss"
+  for (const char *c : {"filling_issue", "filling_return", "filling_dust"}) {
+    const QString column = QLatin1String(c);
+    QList<QPair<int, QString>> rows;
+    query.exec(QString(R"(
+            SELECT id, "%1" FROM jobsheet_detail
+            WHERE "%1" LIKE '%"date_time":"__-__-____%'
+        )")
+                   .arg(column));
+    while (query.next())
+      rows.append({query.value(0).toInt(), query.value(1).toString()});
+
+    QSqlQuery update(db);
+    update.prepare(QString("UPDATE jobsheet_detail SET \"%1\" = ?, "
+                           "row_version = row_version + 1 WHERE id = ?")
+                       .arg(column));
+    for (const auto &row : rows) {
+      const QJsonDocument doc = QJsonDocument::fromJson(row.second.toUtf8());
+      if (!doc.isArray())
+        continue;
+      QJsonArray entries = doc.array();
+      bool changed = false;
+      for (int i = 0; i < entries.size(); ++i) {
+        QJsonObject entry = entries.at(i).toObject();
+        const QString dateTime = entry["date_time"].toString();
+        const QString iso = Dates::normalized(dateTime);
+        if (!iso.isEmpty() && iso != dateTime) {
+          entry["date_time"] = iso;
+          entries[i] = entry;
+          changed = true;
+        }
+      }
+      // Unreadable dates still match the LIKE; rewriting those rows would
+      // bump row_version on every start and look like another user's edit
+      if (!changed)
+        continue;
+      update.bindValue(0, QString::fromUtf8(QJsonDocument(entries).toJson(
+                              QJsonDocument::Compact)));
+      update.bindValue(1, row.first);
+      if (!update.exec()) {
+        qCritical() << "Migration: could not rewrite history dates in"
+                    << column << update.lastError();
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool DatabaseManager::createLossColumns(QSqlDatabase db) {
+  QSqlQuery query(db);
+
+  // Generated columns need SQLite 3.31 and the sums JSON support; with an
+  // older library the lists still work, only the indexed sorts do not
+  if (!query.exec("SELECT sqlite_version(), json_valid('[]')") ||
+      !query.next() ||
+      QVersionNumber::fromString(query.value(0).toString()) <
+          QVersionNumber(3, 31)) {
+    qWarning() << "Loss columns need SQLite 3.31 with JSON; skipped";
+    return true;
+  }
+
+  // ---------- Casting: a virtual column, computed when read ----------
+  // The casting ledger's default gross_loss (see LedgerFormulas)
+  if (!query.exec("SELECT gross_loss FROM casting_entry LIMIT 1") &&
+      !query.exec(R"(
+            ALTER TABLE casting_entry ADD COLUMN gross_loss REAL
+            GENERATED ALWAYS AS (
+                COALESCE(receive_runner_wt, 0)
+                + COALESCE(receive_product_wt, 0)
+                - COALESCE(issue_diamond_wt, 0) / 5
+                - COALESCE(issue_metal_wt, 0)
+            ) VIRTUAL
+        )")) {
+    qCritical() << "casting_entry gross_loss error:" << query.lastError();
+    return false;
+  }
+
+  // ---------- Jobs: totals kept by triggers ----------
+  // A job's weights come from casting_entry, overridden by its job sheet
+  // (JSON histories) once that has entries, as in loadJobsList(). The
+  // totals are kept per job in job_totals; net weight and losses are
+  // stored generated columns over them, with the jobs ledger's default
+  // formulas.
+  const bool isNew = !query.exec("SELECT 1 FROM job_totals LIMIT 1");
+  if (!query.exec(R"(
+        CREATE TABLE IF NOT EXISTS job_totals (
+            job_id INTEGER PRIMARY KEY,
+            issue_wt REAL NOT NULL DEFAULT 0,
+            gross_wt REAL NOT NULL DEFAULT 0,
+            receive_dia_wt REAL NOT NULL DEFAULT 0,
+            receive_stone_wt REAL NOT NULL DEFAULT 0,
+            office_gold_receive REAL NOT NULL DEFAULT 0,
+
+            net_wt REAL GENERATED ALWAYS AS
+                (gross_wt - receive_dia_wt - receive_stone_wt) STORED,
+            gross_loss REAL GENERATED ALWAYS AS
+                (issue_wt - (net_wt + office_gold_receive)) STORED,
+            loss_pct REAL GENERATED ALWAYS AS
+                (CASE WHEN issue_wt > 0 THEN gross_loss / issue_wt * 100
+                      ELSE 0 END) STORED
+        );
+    )")) {
+    qCritical() << "job_totals table error:" << query.lastError();
+    return false;
+  }
+
+  // Sorts and "loss above x" filters, plus the job lookups the triggers do
+  for (const char *index :
+       {"idx_job_totals_net_wt ON job_totals(net_wt)",
+        "idx_job_totals_gross_loss ON job_totals(gross_loss)",
+        "idx_job_totals_loss_pct ON job_totals(loss_pct)",
+        "idx_casting_entry_gross_loss ON casting_entry(gross_loss)",
+        "idx_casting_entry_job_id ON casting_entry(job_id)",
+        "idx_order_book_detail_job_id ON order_book_detail(job_id)"}) {
+    if (!query.exec(QString("CREATE INDEX IF NOT EXISTS %1")
+                        .arg(QLatin1String(index)))) {
+      qCritical() << "Loss index error:" << index << query.lastError();
+      return false;
+    }
+  }
+
+  // Sum of one weight over the entries of a job sheet JSON column, each
+  // rounded to the milligram; malformed JSON counts as no entries
+  auto jsonSum = [](const char *column, const char *weight) {
+    return QString("(CASE WHEN json_valid(jd.%1) THEN (SELECT "
+                   "ROUND(TOTAL(ROUND(%2, 3)), 3) FROM json_each(jd.%1) "
+                   "WHERE type = 'object') ELSE 0 END)")
+        .arg(QLatin1String(column), QLatin1String(weight));
+  };
+  const char *gold = "CAST(json_extract(value, '$.weight') AS REAL)";
+  const char *stones =
+      "COALESCE(NULLIF(CAST(json_extract(value, '$.wt') AS REAL), 0), "
+      "CAST(json_extract(value, '$.weight') AS REAL))";
+  const QString sheet = "(COALESCE(jd.filling_issue, '') <> '' OR "
+                        "COALESCE(jd.filling_return, '') <> '' OR "
+                        "COALESCE(jd.diamond_issue, '') <> '' OR "
+                        "COALESCE(jd.office_gold_receive, '') <> '')";
+
+  const QString sourceSql =
+      QString(R"(CREATE VIEW job_totals_source AS
+        SELECT
+            od.job_id AS job_id,
+            CASE WHEN %1 AND COALESCE(jd.filling_issue, '') <> ''
+                 THEN %2 ELSE COALESCE(c.issue_metal_wt, 0) END AS issue_wt,
+            CASE WHEN %1 AND COALESCE(jd.filling_return, '') <> ''
+                 THEN %3 ELSE COALESCE(c.receive_product_wt, 0) END AS gross_wt,
+            CASE WHEN %1 THEN %4 ELSE COALESCE(c.receive_diamond_wt, 0) END
+                AS receive_dia_wt,
+            CASE WHEN %1 THEN %5 ELSE COALESCE(c.receive_stone_wt, 0) END
+                AS receive_stone_wt,
+            CASE WHEN %1 AND COALESCE(jd.office_gold_receive, '') <> ''
+                 THEN COALESCE(jd.office_gold_receive_mg / 1000.0,
+                               CAST(jd.office_gold_receive AS REAL))
+                 ELSE COALESCE(c.receive_runner_wt, 0) END
+                AS office_gold_receive
+        FROM order_book_detail od
+        LEFT JOIN casting_entry c ON c.job_id = od.job_id
+        LEFT JOIN jobsheet_detail jd ON jd.job_no = CAST(od.job_id AS TEXT))")
+          .arg(sheet, jsonSum("filling_issue", gold),
+               jsonSum("filling_return", gold),
+               jsonSum("diamond_return", stones),
+               jsonSum("stone_return", stones));
+
+  // The view is replaced, and every job recomputed, only when its text
+  // changes (or the table is new)
+  query.exec("SELECT sql FROM sqlite_master WHERE type = 'view' "
+             "AND name = 'job_totals_source'");
+  const bool rebuild =
+      isNew || !query.next() || query.value(0).toString() != sourceSql;
+
+  const QString refresh =
+      "INSERT OR REPLACE INTO job_totals (job_id, issue_wt, gross_wt, "
+      "receive_dia_wt, receive_stone_wt, office_gold_receive) "
+      "SELECT job_id, issue_wt, gross_wt, receive_dia_wt, receive_stone_wt, "
+      "office_gold_receive FROM job_totals_source";
+
+  if (rebuild && (!query.exec("DROP VIEW IF EXISTS job_totals_source") ||
+                  !query.exec(sourceSql) || !query.exec(refresh))) {
+    qCritical() << "job_totals source error:" << query.lastError();
+    return false;
+  }
+
+  // Triggers refresh one job's row when a weight it reads is written. They
+  // insert from the view, so they are recreated along with it.
+  const QString forJob = refresh + " WHERE job_id = %1;";
+  const struct {
+    const char *name;
+    const char *event;
+    QString body;
+  } kTriggers[] = {
+      {"trg_job_totals_order_ins", "AFTER INSERT ON order_book_detail",
+       forJob.arg("NEW.job_id")},
+      {"trg_job_totals_order_del", "AFTER DELETE ON order_book_detail",
+       "DELETE FROM job_totals WHERE job_id = OLD.job_id;"},
+      {"trg_job_totals_casting_ins", "AFTER INSERT ON casting_entry",
+       forJob.arg("NEW.job_id")},
+      {"trg_job_totals_casting_upd",
+       "AFTER UPDATE OF job_id, issue_metal_wt, receive_product_wt, "
+       "receive_diamond_wt, receive_stone_wt, receive_runner_wt "
+       "ON casting_entry",
+       forJob.arg("OLD.job_id") + forJob.arg("NEW.job_id")},
+      {"trg_job_totals_casting_del", "AFTER DELETE ON casting_entry",
+       forJob.arg("OLD.job_id")},
+      {"trg_job_totals_sheet_ins", "AFTER INSERT ON jobsheet_detail",
+       forJob.arg("CAST(NEW.job_no AS INTEGER)")},
+      {"trg_job_totals_sheet_upd",
+       "AFTER UPDATE OF job_no, filling_issue, filling_return, "
+       "diamond_issue, diamond_return, stone_return, office_gold_receive, "
+       "office_gold_receive_mg ON jobsheet_detail",
+       forJob.arg("CAST(OLD.job_no AS INTEGER)") +
+           forJob.arg("CAST(NEW.job_no AS INTEGER)")},
+      {"trg_job_totals_sheet_del", "AFTER DELETE ON jobsheet_detail",
+       forJob.arg("CAST(OLD.job_no AS INTEGER)")},
+  };
+  for (const auto &t : kTriggers) {
+    if ((rebuild && !query.exec(QString("DROP TRIGGER IF EXISTS %1")
+                                    .arg(QLatin1String(t.name)))) ||
+        !query.exec(QString("CREATE TRIGGER IF NOT EXISTS %1 %2 BEGIN %3 END")
+                        .arg(QLatin1String(t.name), QLatin1String(t.event),
+                             t.body))) {
+      qCritical() << "job_totals trigger error:" << t.name
+                  << query.lastError();
+      return false;
+    }
+  }
+
+  return true;
+}
@@ -3,6 +3,8 @@
 
 #include <QSqlDatabase>
 
+class QThread;
+
 class DatabaseManager
 {
 public:
@@ -12,7 +14,12 @@ public:
     // Initialize database (open + create tables)
     bool initialize();
 
-    // Get active database connection
+    // Staged startup: open() is cheap and runs before the first window,
+    // ensureSchema() (tables, migrations, seeds) may run on a worker thread.
+    bool open();
+    bool ensureSchema();
+
+    // Get active database connection (per-thread clone off the main thread)
     QSqlDatabase database() const;
 
 private:
@@ -23,10 +30,26 @@ private:
     DatabaseManager(const DatabaseManager&) = delete;
     DatabaseManager& operator=(const DatabaseManager&) = delete;
 
-    bool createTables();
+    bool createTables(QSqlDatabase db);
+
+    // Unique indexes the ON CONFLICT upserts in DatabaseUtils rely on
+    bool createUpsertKeys(QSqlDatabase db);
+
+    // Date columns (and job sheet history stamps) rewritten to ISO where
+    // they are not, and indexed for range queries
+    bool normalizeDates(QSqlDatabase db);
+
+    // job_totals (trigger-maintained, generated net weight and losses) and
+    // casting_entry.gross_loss, indexed
+    bool createLossColumns(QSqlDatabase db);
+
+    // Numeric copy of a purity text column, filled once for existing rows
+    bool addFinenessColumn(QSqlDatabase db, const QString &table,
+                           const QString &textColumn, const QString &column);
 
 private:
     QSqlDatabase m_db;
+    QThread *m_ownerThread = nullptr;
 };
 
 #endif // DATABASEMANAGER_H
@@ -1,5 +1,17 @@
 #include "DatabaseUtils.h"
+#include "changenotifier.h"
 #include "databasemanager.h"
+#include "jobsheetcache.h"
+#include "querycache.h"
+#include "rowmappings.h"
+#include "sqlfunctions.h"
+#include "writetransaction.h"
+#include "common/fixedpoint.h"
+#include "common/imageingest.h"
+#include "common/ledgerformulas.h"
+#include "common/lossengine.h"
+#include "common/purity.h"
+#include "common/stringpool.h"
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
@@ -13,6 +25,127 @@
 #include <QSqlQuery>
 #include <QUuid>
 
+namespace {
+// UPDATE <table> SET <changed columns only> WHERE id = ? AND the row is
+// still at before.rowVersion; the write bumps row_version. Nothing is sent
+// when no column differs. The written column names go to `written`.
+template <typename S>
+DatabaseUtils::CasResult
+updateChangedColumns(const char *caller, const QString &table, int id,
+                     const S &before, S &after, QStringList &written) {
+  using CasResult = DatabaseUtils::CasResult;
+
+  const auto &cols = RowMapper::columnsOf<S>();
+  const RowMapper::ColumnMask mask = RowMapper::diff(before, after, cols);
+  written = RowMapper::names(cols, mask);
+  after.rowVersion = before.rowVersion;
+  if (!mask)
+    return CasResult::Saved;
+
+  QSqlDatabase db = DatabaseManager::instance().database();
+  if (!db.isOpen() && !db.open()) {
+    qCritical() << "Database not open in" << caller;
+    return CasResult::Failed;
+  }
+  QSqlQuery q(db);
+
+  q.prepare(QString("UPDATE %1 SET %2, row_version = row_version + 1 "
+                    "WHERE id = ? AND row_version = ?")
+                .arg(table, RowMapper::assignments(cols, mask)));
+  const int next = RowMapper::bind(q, after, cols, mask);
+  q.bindValue(next, id); // WHERE clause
+  q.bindValue(next + 1, before.rowVersion);
+
+  if (!q.exec()) {
+    qCritical() << caller << "failed:" << q.lastError();
+    return CasResult::Failed;
+  }
+  if (q.numRowsAffected() == 0) {
+    // Someone else saved (or deleted) the row since it was read
+    qWarning() << caller << ": row" << id << "of" << table
+               << "changed since version" << before.rowVersion;
+    written.clear();
+    return CasResult::Conflict;
+  }
+
+  after.rowVersion = before.rowVersion + 1;
+  return CasResult::Saved;
+}
+
+// jobsheet_detail holds one row per job (unique job_no): set some columns,
+// creating the row on the first write, in a single statement
+bool upsertJobSheetFields(const QString &jobNo, const QStringList &columns,
+                          const QVariantList &values) {
+  QSqlDatabase db = DatabaseManager::instance().database();
+  if (!db.isOpen() && !db.open())
+    return false;
+
+  QStringList quoted, updates;
+  for (const QString &column : columns) {
+    quoted << QString("\"%1\"").arg(column);
+    updates << QString("\"%1\" = excluded.\"%1\"").arg(column);
+  }
+
+  QSqlQuery q(db);
+  q.prepare(QString(R"(
+        INSERT INTO jobsheet_detail (job_no, %1) VALUES (?%2)
+        ON CONFLICT(job_no) DO UPDATE SET %3,
+            row_version = row_version + 1
+    )")
+                .arg(quoted.join(", "), QString(", ?").repeated(values.size()),
+                     updates.join(", ")));
+  q.addBindValue(jobNo);
+  for (const QVariant &value : values)
+    q.addBindValue(value);
+
+  if (!q.exec()) {
+    qCritical() << "Failed to upsert jobsheet_detail." << columns << ":"
+                << q.lastError();
+    return false;
+  }
+  // Dropped only once committed, so a prefetch cannot re-cache the old row
+  WriteTransaction::afterCommit(
+      [jobNo]() { JobSheetCache::instance().invalidate(jobNo); });
+  QueryCache::instance().bump("jobsheet_detail");
+  return true;
+}
+
+// One of DatabaseUtils::kJobSheetWeightColumns, written as text; its exact
+// milligram copy <column>_mg follows by trigger (createTables)
+bool upsertJobSheetWeight(const QString &jobNo, const QString &column,
+                          double weight) {
+  return upsertJobSheetFields(jobNo, {column},
+                              {Milligrams::fromDouble(weight).toString()});
+}
+
+// A weight read back: the milligram column when set, else the text
+double jobSheetWeight(const QVariant &mg, const QVariant &text) {
+  return !mg.isNull() ? Milligrams::fromRaw(mg.toLongLong()).toDouble()
+                      : Milligrams::parse(text.toString()).toDouble();
+}
+
+// " AND col >= :from AND col < :to" for a valid range, else nothing;
+// bindRange() fills the values
+QString rangeClause(const QString &column, const Dates::Range &range) {
+  return range.isValid()
+             ? QString(" AND %1 >= :from AND %1 < :to").arg(column)
+             : QString();
+}
+
+void bindRange(QSqlQuery &q, const Dates::Range &range) {
+  if (!range.isValid())
+    return;
+  q.bindValue(":from", Dates::toStored(range.from));
+  q.bindValue(":to", Dates::toStored(range.to));
+}
+
+// A weight in the job sheet JSON, stored as "12.345" or as a number
+Milligrams weightOf(const QJsonValue &v) {
+  return v.isString() ? Milligrams::parse(v.toString())
+                      : Milligrams::fromDouble(v.toDouble());
+}
+} // namespace
+
 bool DatabaseUtils::createOrder(const OrderData &o, int &outJobId,
                                 int &outSellerSeq) {
   QSqlDatabase db = DatabaseManager::instance().database();
@@ -22,62 +155,37 @@ bool DatabaseUtils::createOrder(const OrderData &o, int &outJobId,
   }
   QSqlQuery q(db);
 
-  if (!db.transaction()) {
-    qCritical() << "Transaction start failed";
+  // Takes the write lock up front; busy PCs are retried, not failed
+  WriteTransaction tx(db, "createOrder");
+  if (!tx.begin())
     return false;
-  }
 
   // ---------- 1️⃣ jobs ----------
   if (!q.exec("INSERT INTO jobs DEFAULT VALUES")) {
     qCritical() << q.lastError() << "11111";
-    db.rollback();
+    tx.rollback();
     return false;
   }
   int jobId = q.lastInsertId().toInt();
 
   // ---------- 2️⃣ seller_order_counter ----------
-  // 1️⃣ Ensure seller counter row exists (SAFE, no race condition)
-  q.prepare(R"(
-    INSERT OR IGNORE INTO seller_order_counter (seller_id, last_order_no)
-    VALUES (:sid, 0)
-)");
-  q.bindValue(":sid", o.sellerId);
-
-  if (!q.exec()) {
-    qCritical() << "Insert seller counter failed:" << q.lastError();
-    db.rollback();
-    return false;
-  }
-
-  // 2️⃣ Increment counter
+  // Create-or-increment and read back in one statement
   q.prepare(R"(
-    UPDATE seller_order_counter
-    SET last_order_no = last_order_no + 1
-    WHERE seller_id = :sid
+    INSERT INTO seller_order_counter (seller_id, last_order_no)
+    VALUES (:sid, 1)
+    ON CONFLICT(seller_id) DO UPDATE SET last_order_no = last_order_no + 1
+    RETURNING last_order_no
 )");
   q.bindValue(":sid", o.sellerId);
 
-  if (!q.exec() || q.numRowsAffected() == 0) {
-    qCritical() << "Update seller counter failed:" << q.lastError();
-    db.rollback();
-    return false;
-  }
-
-  // 3️⃣ Fetch updated value
-  q.prepare(R"(
-        SELECT last_order_no
-        FROM seller_order_counter
-        WHERE seller_id = :sid
-    )");
-  q.bindValue(":sid", o.sellerId);
-
   if (!q.exec() || !q.next()) {
-    qCritical() << "Select seller counter failed:" << q.lastError();
-    db.rollback();
+    qCritical() << "Seller counter upsert failed:" << q.lastError();
+    tx.rollback();
     return false;
   }
 
   int sellerSeq = q.value(0).toInt();
+  q.finish();
 
   // ---------- 3️⃣ orders ----------
   q.prepare(R"(
@@ -90,149 +198,28 @@ bool DatabaseUtils::createOrder(const OrderData &o, int &outJobId,
 
   if (!q.exec()) {
     qCritical() << q.lastError();
-    db.rollback();
+    tx.rollback();
     return false;
   }
 
   int orderId = q.lastInsertId().toInt();
 
   // ---------- 4️⃣ order_book_detail ----------
-  q.prepare(R"(
-        INSERT INTO order_book_detail (
-            order_id, job_id,
-            sellerName, sellerId,
-            partyId, partyName,
-            clientId, agencyId, shopId, reteillerId, starId,
-            address, city, state, country,
-            orderDate, deliveryDate,
-            productName, productPis,
-            approxProductWt, approxDiamondWt,
-            metalPrice, metalName, metalPurity, metalColor,
-            sizeNo, sizeMM, length, width, height,
-            diaPacific, diaPurity, diaColor, diaPrice,
-            stPacific, stPurity, stColor, stPrice,
-            designNo, image1Path, image2Path,
-            metalCertiName, metalCertiType,
-            diaCertiName, diaCertiType,
-            pesSaki, chainLock, polish, settingLebour, metalStemp,
-            paymentMethod, totalAmount, advance, remaining,
-            note, extraDetail, isSaved
-        ) VALUES (
-            :order_id, :job_id,
-            :sellerName, :sellerId,
-            :partyId, :partyName,
-            :clientId, :agencyId, :shopId, :reteillerId, :starId,
-            :address, :city, :state, :country,
-            :orderDate, :deliveryDate,
-            :productName, :productPis,
-            :approxProductWt, :approxDiamondWt,
-            :metalPrice, :metalName, :metalPurity, :metalColor,
-            :sizeNo, :sizeMM, :length, :width, :height,
-            :diaPacific, :diaPurity, :diaColor, :diaPrice,
-            :stPacific, :stPurity, :stColor, :stPrice,
-            :designNo, :image1Path, :image2Path,
-            :metalCertiName, :metalCertiType,
-            :diaCertiName, :diaCertiType,
-            :pesSaki, :chainLock, :polish, :settingLebour, :metalStemp,
-            :paymentMethod, :totalAmount, :advance, :remaining,
-            :note, :extraDetail, 1
-        )
-    )");
-
-  // 🔁 Bind everything EXACTLY as before
-
-  // -------- IDs (NEW SYSTEM) --------
-  q.bindValue(":order_id", orderId);
-  q.bindValue(":job_id", jobId);
-
-  // Seller & party
-  q.bindValue(":sellerName", o.sellerName);
-  q.bindValue(":sellerId", o.sellerId);
-  q.bindValue(":partyId", o.partyId);
-  q.bindValue(":partyName", o.partyName);
-
-  // Client hierarchy
-  q.bindValue(":clientId", o.clientId);
-  q.bindValue(":agencyId", o.agencyId);
-  q.bindValue(":shopId", o.shopId);
-  q.bindValue(":retaillerId", o.retaillerId);
-  q.bindValue(":starId", o.starId);
-
-  // Address
-  q.bindValue(":address", o.address);
-  q.bindValue(":city", o.city);
-  q.bindValue(":state", o.state);
-  q.bindValue(":country", o.country);
-
-  // Dates
-  q.bindValue(":orderDate", o.orderDate);
-  q.bindValue(":deliveryDate", o.deliveryDate);
-
-  // Product
-  q.bindValue(":productName", o.productName);
-  q.bindValue(":productPis", o.productPis);
-  q.bindValue(":approxProductWt", o.approxProductWt);
-  q.bindValue(":approxDiamondWt", o.approxDiamondWt);
-
-  // Metal
-  q.bindValue(":metalPrice", o.metalPrice);
-  q.bindValue(":metalName", o.metalName);
-  q.bindValue(":metalPurity", o.metalPurity);
-  q.bindValue(":metalColor", o.metalColor);
-
-  // Size
-  q.bindValue(":sizeNo", o.sizeNo);
-  q.bindValue(":sizeMM", o.sizeMM);
-  q.bindValue(":length", o.length);
-  q.bindValue(":width", o.width);
-  q.bindValue(":height", o.height);
-
-  // Diamond
-  q.bindValue(":diaPacific", o.diaPacific);
-  q.bindValue(":diaPurity", o.diaPurity);
-  q.bindValue(":diaColor", o.diaColor);
-  q.bindValue(":diaPrice", o.diaPrice);
-
-  // Stone
-  q.bindValue(":stPacific", o.stPacific);
-  q.bindValue(":stPurity", o.stPurity);
-  q.bindValue(":stColor", o.stColor);
-  q.bindValue(":stPrice", o.stPrice);
-
-  // Design & images
-  q.bindValue(":designNo", o.designNo);
-  // q.bindValue(":designNo2", o.designNo2);
-  q.bindValue(":image1Path", o.image1Path);
-  q.bindValue(":image2Path", o.image2Path);
-
-  // Certificates
-  q.bindValue(":metalCertiName", o.metalCertiName);
-  q.bindValue(":metalCertiType", o.metalCertiType);
-  q.bindValue(":diaCertiName", o.diaCertiName);
-  q.bindValue(":diaCertiType", o.diaCertiType);
-
-  // Manufacturing
-  q.bindValue(":pesSaki", o.pesSaki);
-  q.bindValue(":chainLock", o.chainLock);
-  q.bindValue(":polish", o.polish);
-  q.bindValue(":settingLebour", o.settingLebour);
-  q.bindValue(":metalStemp", o.metalStemp);
-
-  // Payment
-  q.bindValue(":paymentMethod", o.paymentMethod);
-  q.bindValue(":totalAmount", o.totalAmount);
-  q.bindValue(":advance", o.advance);
-  q.bindValue(":remaining", o.remaining);
-
-  // Notes
-  q.bindValue(":note", o.note);
-  q.bindValue(":extraDetail", o.extraDetail);
-
-  q.bindValue(":isSaved", o.isSaved);
+  // Column list and binds both come from RowMapper::Table<OrderData>
+  static const QString insertDetailSql =
+      QString("INSERT INTO order_book_detail (order_id, job_id, %1, isSaved) "
+              "VALUES (?, ?, %2, 1)")
+          .arg(RowMapper::columnList(RowMapper::columnsOf<OrderData>()),
+               RowMapper::placeholders(RowMapper::columnsOf<OrderData>()));
+
+  q.prepare(insertDetailSql);
+  q.bindValue(0, orderId);
+  q.bindValue(1, jobId);
+  RowMapper::bind(q, o, RowMapper::columnsOf<OrderData>(), 2);
 
   if (!q.exec()) {
     qCritical() << "order_book_detail insert error:" << q.lastError();
-    db.rollback();
+    tx.rollback();
     return false;
   }
 
@@ -242,119 +229,132 @@ bool DatabaseUtils::createOrder(const OrderData &o, int &outJobId,
 
   if (!q.exec()) {
     qCritical() << q.lastError();
-    db.rollback();
+    tx.rollback();
     return false;
   }
 
-  if (!db.commit()) {
-    qCritical() << "Commit failed";
+  if (!tx.commit())
     return false;
-  }
+
+  for (const char *table : {"jobs", "seller_order_counter", "orders",
+                            "order_book_detail", "order_status"})
+    QueryCache::instance().bump(table);
 
   outJobId = jobId;
   outSellerSeq = sellerSeq;
   return true;
 }
 
-QList<OrderData> DatabaseUtils::getOrdersForSeller(int sellerId) {
-  QList<OrderData> list;
+QList<OrderListRow>
+DatabaseUtils::getOrdersForSeller(int sellerId, const Dates::Range &due) {
+  QList<OrderListRow> list;
   QSqlDatabase db = DatabaseManager::instance().database();
   if (!db.isOpen() && !db.open()) {
     qCritical() << "Database not open in getOrdersForSeller";
     return list;
   }
   QSqlQuery q(db);
-
-  q.prepare(R"(
-        SELECT
-            o.order_id,
-            o.job_id,
-            o.seller_order_seq,
-            od.partyName,
-            od.sellerName,
-            od.productPis,
-            od.metalName,
-            od.metalPurity,
-            od.designNo,
-            od.orderDate,
-            od.deliveryDate,
-            od.extraDetail
+  q.setForwardOnly(true);
+
+  static constexpr auto cols = RowMapper::columns(
+      RowMapper::column("o.order_id", &OrderListRow::orderId),
+      RowMapper::column("o.job_id", &OrderListRow::jobId),
+      RowMapper::column("o.seller_order_seq", &OrderListRow::sellerOrderSeq),
+      RowMapper::column("od.partyName", &OrderListRow::partyName),
+      RowMapper::column("od.sellerName", &OrderListRow::sellerName),
+      RowMapper::column("od.productPis", &OrderListRow::productPis),
+      RowMapper::column("od.metalName", &OrderListRow::metalName),
+      RowMapper::column("od.metalPurity", &OrderListRow::metalPurity),
+      RowMapper::column("od.designNo", &OrderListRow::designNo),
+      RowMapper::column("od.orderDate", &OrderListRow::orderDate),
+      RowMapper::column("od.deliveryDate", &OrderListRow::deliveryDate),
+      RowMapper::column("od.extraDetail", &OrderListRow::extraDetail));
+
+  q.prepare(QString(R"(
+        SELECT %1
         FROM orders o
         JOIN order_book_detail od
             ON o.order_id = od.order_id
-        WHERE o.seller_id = :sid
-        ORDER BY o.order_id DESC
-    )");
+        WHERE o.seller_id = :sid%2
+        ORDER BY %3
+    )")
+                .arg(RowMapper::columnList(cols),
+                     rangeClause("od.deliveryDate", due),
+                     QString(due.isValid() ? "od.deliveryDate ASC"
+                                           : "o.order_id DESC")));
 
   q.bindValue(":sid", sellerId);
+  bindRange(q, due);
 
   if (!q.exec()) {
     qCritical() << "getOrdersForSeller failed:" << q.lastError();
     return list;
   }
 
+  StringPool pool;
   while (q.next()) {
-    OrderData o;
-
-    o.orderId = q.value("order_id").toInt();
-    o.sellerOrderSeq = q.value("seller_order_seq").toInt();
-    o.jobId = q.value("job_id").toInt();
-    o.partyName = q.value("partyName").toString();
-    o.sellerName = q.value("sellerName").toString();
-    o.productPis = q.value("productPis").toInt();
-    o.metalName = q.value("metalName").toString();
-    o.metalPurity = q.value("metalPurity").toString();
-    o.designNo = q.value("designNo").toString();
-    o.orderDate = q.value("orderDate").toString();
-    o.deliveryDate = q.value("deliveryDate").toString();
-    o.extraDetail = q.value("extraDetail").toString();
-
+    OrderListRow o;
+    RowMapper::read(q, o, cols);
+    o.partyName = pool.intern(o.partyName);
+    o.sellerName = pool.intern(o.sellerName);
+    o.metalName = pool.intern(o.metalName);
+    o.metalPurity = pool.intern(o.metalPurity);
+    o.orderDate = pool.intern(o.orderDate);
+    o.deliveryDate = pool.intern(o.deliveryDate);
     list.append(o);
   }
 
   return list;
 }
 
-QList<OrderData> DatabaseUtils::getAllOrders() {
-  QList<OrderData> list;
+QList<OrderListRow> DatabaseUtils::getAllOrders(const Dates::Range &due) {
+  QList<OrderListRow> list;
   QSqlDatabase db = DatabaseManager::instance().database();
   if (!db.isOpen() && !db.open()) {
     qCritical() << "Database not open in getAllOrders";
     return list;
   }
   QSqlQuery q(db);
-
-  q.prepare(R"(
-        SELECT
-            o.order_id,
-            o.job_id,
-            o.seller_order_seq,
-            od.partyName,
-            od.sellerName,
-            od.orderDate,
-            od.deliveryDate
+  q.setForwardOnly(true);
+
+  static constexpr auto cols = RowMapper::columns(
+      RowMapper::column("o.order_id", &OrderListRow::orderId),
+      RowMapper::column("o.job_id", &OrderListRow::jobId),
+      RowMapper::column("o.seller_order_seq", &OrderListRow::sellerOrderSeq),
+      RowMapper::column("od.partyName", &OrderListRow::partyName),
+      RowMapper::column("od.sellerName", &OrderListRow::sellerName),
+      RowMapper::column("od.orderDate", &OrderListRow::orderDate),
+      RowMapper::column("od.deliveryDate", &OrderListRow::deliveryDate));
+
+  q.prepare(QString(R"(
+        SELECT %1
         FROM orders o
         JOIN order_book_detail od
             ON o.order_id = od.order_id
-        ORDER BY o.order_id DESC
-    )");
+        WHERE 1%2
+        ORDER BY %3
+    )")
+                .arg(RowMapper::columnList(cols),
+                     rangeClause("od.deliveryDate", due),
+                     QString(due.isValid() ? "od.deliveryDate ASC"
+                                           : "o.order_id DESC")));
+  bindRange(q, due);
 
   if (!q.exec()) {
     qCritical() << "getAllOrders failed:" << q.lastError();
     return list;
   }
 
+  StringPool pool;
   while (q.next()) {
-    OrderData o;
-
-    o.orderId = q.value("order_id").toInt();
-    o.sellerOrderSeq = q.value("seller_order_seq").toInt();
-    o.jobId = q.value("job_id").toInt();
-    o.partyName = q.value("partyName").toString();
-    o.sellerName = q.value("sellerName").toString();
-    o.orderDate = q.value("orderDate").toString();
-    o.deliveryDate = q.value("deliveryDate").toString();
-
+    OrderListRow o;
+    RowMapper::read(q, o, cols);
+    o.partyName = pool.intern(o.partyName);
+    o.sellerName = pool.intern(o.sellerName);
+    o.metalName = pool.intern(o.metalName);
+    o.metalPurity = pool.intern(o.metalPurity);
+    o.orderDate = pool.intern(o.orderDate);
+    o.deliveryDate = pool.intern(o.deliveryDate);
     list.append(o);
   }
 
@@ -368,35 +368,24 @@ bool DatabaseUtils::getOrderById(int orderId, OrderData &o) {
     return false;
   }
   QSqlQuery q(db);
+  q.setForwardOnly(true);
 
-  q.prepare(R"(
+  static const QString sql =
+      QString(R"(
         SELECT
             o.order_id,
             o.job_id,
             o.seller_order_seq,
-            od.sellerName, od.sellerId,
-            od.partyId, od.partyName,
-            od.clientId, od.agencyId, od.shopId, od.reteillerId, od.starId,
-            od.address, od.city, od.state, od.country,
-            od.orderDate, od.deliveryDate,
-            od.productName, od.productPis,
-            od.approxProductWt, od.approxDiamondWt,
-            od.metalPrice, od.metalName, od.metalPurity, od.metalColor,
-            od.sizeNo, od.sizeMM, od.length, od.width, od.height,
-            od.diaPacific, od.diaPurity, od.diaColor, od.diaPrice,
-            od.stPacific, od.stPurity, od.stColor, od.stPrice,
-            od.designNo, od.image1Path, od.image2Path,
-            od.metalCertiName, od.metalCertiType,
-            od.diaCertiName, od.diaCertiType,
-            od.pesSaki, od.chainLock, od.polish, od.settingLebour, od.metalStemp,
-            od.paymentMethod, od.totalAmount, od.advance, od.remaining,
-            od.note, od.extraDetail
+            od.row_version,
+            %1
         FROM orders o
         JOIN order_book_detail od
             ON o.order_id = od.order_id
         WHERE o.order_id = :id
-    )");
+    )")
+          .arg(RowMapper::columnList(RowMapper::columnsOf<OrderData>(), "od."));
 
+  q.prepare(sql);
   q.bindValue(":id", orderId);
 
   if (!q.exec() || !q.next()) {
@@ -406,91 +395,13 @@ bool DatabaseUtils::getOrderById(int orderId, OrderData &o) {
 
   // Primary
   o.id = orderId;
-  o.orderId = q.value("order_id").toInt();
-  o.jobId = q.value("job_id").toInt();
-  o.sellerOrderSeq = q.value("seller_order_seq").toInt();
-
-  // Seller & Party
-  o.sellerName = q.value("sellerName").toString();
-  o.sellerId = q.value("sellerId").toInt();
-  o.partyId = q.value("partyId").toString();
-  o.partyName = q.value("partyName").toString();
-
-  // Client hierarchy
-  o.clientId = q.value("clientId").toString();
-  o.agencyId = q.value("agencyId").toString();
-  o.shopId = q.value("shopId").toString();
-  o.retaillerId = q.value("reteillerId").toString();
-  o.starId = q.value("starId").toString();
-
-  // Address
-  o.address = q.value("address").toString();
-  o.city = q.value("city").toString();
-  o.state = q.value("state").toString();
-  o.country = q.value("country").toString();
-
-  // Dates
-  o.orderDate = q.value("orderDate").toString();
-  o.deliveryDate = q.value("deliveryDate").toString();
-
-  // Product
-  o.productName = q.value("productName").toString();
-  o.productPis = q.value("productPis").toInt();
-  o.approxProductWt = q.value("approxProductWt").toDouble();
-  o.approxDiamondWt = q.value("approxDiamondWt").toDouble();
-
-  // Metal
-  o.metalPrice = q.value("metalPrice").toDouble();
-  o.metalName = q.value("metalName").toString();
-  o.metalPurity = q.value("metalPurity").toString();
-  o.metalColor = q.value("metalColor").toString();
-
-  // Size & dimensions
-  o.sizeNo = q.value("sizeNo").toDouble();
-  o.sizeMM = q.value("sizeMM").toDouble();
-  o.length = q.value("length").toDouble();
-  o.width = q.value("width").toDouble();
-  o.height = q.value("height").toDouble();
-
-  // Diamond
-  o.diaPacific = q.value("diaPacific").toString();
-  o.diaPurity = q.value("diaPurity").toString();
-  o.diaColor = q.value("diaColor").toString();
-  o.diaPrice = q.value("diaPrice").toDouble();
-
-  // Stone
-  o.stPacific = q.value("stPacific").toString();
-  o.stPurity = q.value("stPurity").toString();
-  o.stColor = q.value("stColor").toString();
-  o.stPrice = q.value("stPrice").toDouble();
-
-  // Design
-  o.designNo = q.value("designNo").toString();
-  o.image1Path = q.value("image1Path").toString();
-  o.image2Path = q.value("image2Path").toString();
-
-  // Certification
-  o.metalCertiName = q.value("metalCertiName").toString();
-  o.metalCertiType = q.value("metalCertiType").toString();
-  o.diaCertiName = q.value("diaCertiName").toString();
-  o.diaCertiType = q.value("diaCertiType").toString();
-
-  // Manufacturing options
-  o.pesSaki = q.value("pesSaki").toString();
-  o.chainLock = q.value("chainLock").toString();
-  o.polish = q.value("polish").toString();
-  o.settingLebour = q.value("settingLebour").toString();
-  o.metalStemp = q.value("metalStemp").toString();
-
-  // Payment
-  o.paymentMethod = q.value("paymentMethod").toString();
-  o.totalAmount = q.value("totalAmount").toDouble();
-  o.advance = q.value("advance").toDouble();
-  o.remaining = q.value("remaining").toDouble();
-
-  // Notes
-  o.note = q.value("note").toString();
-  o.extraDetail = q.value("extraDetail").toString();
+  o.orderId = q.value(0).toInt();
+  o.jobId = q.value(1).toInt();
+  o.sellerOrderSeq = q.value(2).toInt();
+  o.rowVersion = q.value(3).toInt();
+
+  // Everything else, in Table<OrderData> order
+  RowMapper::read(q, o, RowMapper::columnsOf<OrderData>(), 4);
 
   o.isSaved = 1;
   return true;
@@ -504,189 +415,54 @@ bool DatabaseUtils::updateOrder(int orderId, const OrderData &o) {
   }
   QSqlQuery q(db);
 
-  q.prepare(R"(
-        UPDATE order_book_detail SET
-
-            sellerName = :sellerName,
-            sellerId   = :sellerId,
-
-            partyId   = :partyId,
-            partyName = :partyName,
-
-            clientId    = :clientId,
-            agencyId    = :agencyId,
-            shopId      = :shopId,
-            reteillerId = :reteillerId,
-            starId      = :starId,
-
-            address = :address,
-            city    = :city,
-            state   = :state,
-            country = :country,
-
-            orderDate    = :orderDate,
-            deliveryDate = :deliveryDate,
-
-            productName     = :productName,
-            productPis      = :productPis,
-            approxProductWt = :approxProductWt,
-            approxDiamondWt = :approxDiamondWt,
-
-            metalPrice  = :metalPrice,
-            metalName   = :metalName,
-            metalPurity = :metalPurity,
-            metalColor  = :metalColor,
-
-            sizeNo = :sizeNo,
-            sizeMM = :sizeMM,
-            length = :length,
-            width  = :width,
-            height = :height,
-
-            diaPacific = :diaPacific,
-            diaPurity  = :diaPurity,
-            diaColor   = :diaColor,
-            diaPrice   = :diaPrice,
-
-            stPacific = :stPacific,
-            stPurity  = :stPurity,
-            stColor   = :stColor,
-            stPrice   = :stPrice,
-
-            designNo   = :designNo,
-            image1Path = :image1Path,
-            image2Path = :image2Path,
-
-            metalCertiName = :metalCertiName,
-            metalCertiType = :metalCertiType,
-            diaCertiName   = :diaCertiName,
-            diaCertiType   = :diaCertiType,
-
-            pesSaki       = :pesSaki,
-            chainLock     = :chainLock,
-            polish        = :polish,
-            settingLebour = :settingLebour,
-            metalStemp    = :metalStemp,
-
-            paymentMethod = :paymentMethod,
-            totalAmount   = :totalAmount,
-            advance       = :advance,
-            remaining     = :remaining,
-
-            note        = :note,
-            extraDetail = :extraDetail,
-            isSaved     = :isSaved
-
-        WHERE id = :order_id
-    )");
+  static const QString sql =
+      QString("UPDATE order_book_detail SET %1, isSaved = ?, "
+              "row_version = row_version + 1 WHERE id = ?")
+          .arg(RowMapper::assignments(RowMapper::columnsOf<OrderData>()));
+  constexpr int n = RowMapper::count(RowMapper::columnsOf<OrderData>());
 
-  // -------- IDs (NEW SYSTEM) --------
-  // q.bindValue(":order_id", orderId);
-  // q.bindValue(":job_id", jobId);
-
-  // Seller & party
-  q.bindValue(":sellerName", o.sellerName);
-  q.bindValue(":sellerId", o.sellerId);
-  q.bindValue(":partyId", o.partyId);
-  q.bindValue(":partyName", o.partyName);
-
-  // Client hierarchy
-  q.bindValue(":clientId", o.clientId);
-  q.bindValue(":agencyId", o.agencyId);
-  q.bindValue(":shopId", o.shopId);
-  q.bindValue(":retaillerId", o.retaillerId);
-  q.bindValue(":starId", o.starId);
-
-  // Address
-  q.bindValue(":address", o.address);
-  q.bindValue(":city", o.city);
-  q.bindValue(":state", o.state);
-  q.bindValue(":country", o.country);
-
-  // Dates
-  q.bindValue(":orderDate", o.orderDate);
-  q.bindValue(":deliveryDate", o.deliveryDate);
-
-  // Product
-  q.bindValue(":productName", o.productName);
-  q.bindValue(":productPis", o.productPis);
-  q.bindValue(":approxProductWt", o.approxProductWt);
-  q.bindValue(":approxDiamondWt", o.approxDiamondWt);
-
-  // Metal
-  q.bindValue(":metalPrice", o.metalPrice);
-  q.bindValue(":metalName", o.metalName);
-  q.bindValue(":metalPurity", o.metalPurity);
-  q.bindValue(":metalColor", o.metalColor);
-
-  // Size
-  q.bindValue(":sizeNo", o.sizeNo);
-  q.bindValue(":sizeMM", o.sizeMM);
-  q.bindValue(":length", o.length);
-  q.bindValue(":width", o.width);
-  q.bindValue(":height", o.height);
-
-  // Diamond
-  q.bindValue(":diaPacific", o.diaPacific);
-  q.bindValue(":diaPurity", o.diaPurity);
-  q.bindValue(":diaColor", o.diaColor);
-  q.bindValue(":diaPrice", o.diaPrice);
-
-  // Stone
-  q.bindValue(":stPacific", o.stPacific);
-  q.bindValue(":stPurity", o.stPurity);
-  q.bindValue(":stColor", o.stColor);
-  q.bindValue(":stPrice", o.stPrice);
-
-  // Design & images
-  q.bindValue(":designNo", o.designNo);
-  // q.bindValue(":designNo2", o.designNo2);
-  q.bindValue(":image1Path", o.image1Path);
-  q.bindValue(":image2Path", o.image2Path);
-
-  // Certificates
-  q.bindValue(":metalCertiName", o.metalCertiName);
-  q.bindValue(":metalCertiType", o.metalCertiType);
-  q.bindValue(":diaCertiName", o.diaCertiName);
-  q.bindValue(":diaCertiType", o.diaCertiType);
-
-  // Manufacturing
-  q.bindValue(":pesSaki", o.pesSaki);
-  q.bindValue(":chainLock", o.chainLock);
-  q.bindValue(":polish", o.polish);
-  q.bindValue(":settingLebour", o.settingLebour);
-  q.bindValue(":metalStemp", o.metalStemp);
-
-  // Payment
-  q.bindValue(":paymentMethod", o.paymentMethod);
-  q.bindValue(":totalAmount", o.totalAmount);
-  q.bindValue(":advance", o.advance);
-  q.bindValue(":remaining", o.remaining);
-
-  // Notes
-  q.bindValue(":note", o.note);
-  q.bindValue(":extraDetail", o.extraDetail);
-
-  q.bindValue(":isSaved", o.isSaved);
-
-  // WHERE clause
-  q.bindValue(":order_id", orderId);
+  q.prepare(sql);
+  RowMapper::bind(q, o, RowMapper::columnsOf<OrderData>());
+  q.bindValue(n, o.isSaved);
+  q.bindValue(n + 1, orderId); // WHERE clause
 
   if (!q.exec()) {
     qCritical() << "Update failed:" << q.lastError();
     return false;
   }
 
+  // Keyed by order id here, not job id; drop all cached job sheets
+  JobSheetCache::instance().clear();
+  QueryCache::instance().bump("order_book_detail");
   return true;
 }
 
-QList<CastingListRow> DatabaseUtils::getCastingList() {
-  QList<CastingListRow> list;
+DatabaseUtils::CasResult
+DatabaseUtils::updateOrderChanges(int orderId, const OrderData &before,
+                                  OrderData &after) {
+  QStringList written;
+  const CasResult result = updateChangedColumns(
+      "updateOrderChanges", "order_book_detail", orderId, before, after,
+      written);
+  if (written.isEmpty())
+    return result;
+
+  if (after.jobId > 0)
+    JobSheetCache::instance().invalidate(after.jobId);
+  else
+    JobSheetCache::instance().clear();
+
+  ChangeNotifier::notify("order_book_detail", orderId, written);
+  return result;
+}
 
+namespace {
+// Uncached; see DatabaseUtils::getCastingList()
+bool loadCastingList(QList<CastingListRow> &list) {
   QSqlDatabase db = DatabaseManager::instance().database();
   if (!db.isOpen() && !db.open()) {
     qCritical() << "Database not open in getCastingList";
-    return list;
+    return false;
   }
   QSqlQuery q(db);
 
@@ -714,7 +490,8 @@ QList<CastingListRow> DatabaseUtils::getCastingList() {
             c.receive_diamond_wt,
 
             c.status,
-            c.dia_price
+            c.dia_price,
+            c.issue_metal_fineness
         FROM order_book_detail o
         LEFT JOIN casting_entry c ON c.job_id = o.job_id
         ORDER BY o.deliveryDate ASC
@@ -722,21 +499,24 @@ QList<CastingListRow> DatabaseUtils::getCastingList() {
 
   if (!q.exec()) {
     qCritical() << "Failed to fetch casting list:" << q.lastError();
-    return list;
+    return false;
   }
 
+  // Vendors, metals, purities, statuses and dates repeat down the list
+  static const QString kPending = QStringLiteral("PENDING");
+  StringPool pool;
   while (q.next()) {
     CastingListRow r;
 
     r.jobId = q.value(0).toInt();
-    r.deliveryDate = q.value(1).toString();
+    r.deliveryDate = pool.intern(q.value(1).toString());
 
-    r.castingDate = q.value(2).toString();
-    r.vendorName = q.value(3).toString();
+    r.castingDate = pool.intern(q.value(2).toString());
+    r.vendorName = pool.intern(q.value(3).toString());
     r.pcs = q.value(4).toInt();
 
-    r.issueMetal = q.value(5).toString();
-    r.purity = q.value(6).toString();
+    r.issueMetal = pool.intern(q.value(5).toString());
+    r.purity = pool.intern(q.value(6).toString());
     r.issueMetalWt = q.value(7).toDouble();
     r.issueDiaPcs = q.value(8).toInt();
     r.issueDiaWt = q.value(9).toDouble();
@@ -746,16 +526,24 @@ QList<CastingListRow> DatabaseUtils::getCastingList() {
     r.receiveDiaPcs = q.value(12).toInt();
     r.receiveDiaWt = q.value(13).toDouble();
 
-    r.status = q.value(16).toString();
+    r.status = pool.intern(q.value(16).toString());
     if (r.status.isEmpty())
-      r.status = "PENDING"; // no casting yet
+      r.status = kPending; // no casting yet
 
     r.diaPrice = q.value(17).toDouble();
+    r.fineness = q.value(18).toDouble();
 
     list.append(r);
   }
 
-  return list;
+  return true;
+}
+} // namespace
+
+QList<CastingListRow> DatabaseUtils::getCastingList() {
+  return QueryCache::instance().get<QList<CastingListRow>>(
+      "getCastingList", {"order_book_detail", "casting_entry"},
+      loadCastingList);
 }
 
 int DatabaseUtils::getCastingIdByJob(int jobId) {
@@ -784,53 +572,32 @@ bool DatabaseUtils::insertCasting(const CastingData &c) {
   }
   QSqlQuery q(db);
 
-  if (!db.transaction())
+  WriteTransaction tx(db, "insertCasting");
+  if (!tx.begin())
     return false;
 
-  q.prepare(R"(
-        INSERT INTO casting_entry (
-            job_id, casting_date, casting_name, pcs,
-            issue_metal_name, issue_metal_purity, issue_metal_wt,
-            issue_diamond_pcs, issue_diamond_wt,
-            receive_runner_wt, receive_product_wt,
-            receive_diamond_pcs, receive_diamond_wt,
-            accountant_id, status
-        ) VALUES (
-            :job, :date, :name, :pcs,
-            :metal, :purity, :metalWt,
-            :diaPcs, :diaWt,
-            :runner, :product,
-            :recvDiaPcs, :recvDiaWt,
-            :acc, :status
-        )
-    )");
-
-  q.bindValue(":job", c.jobId);
-  q.bindValue(":date", c.castingDate);
-  q.bindValue(":name", c.castingName);
-  q.bindValue(":pcs", c.pcs);
-
-  q.bindValue(":metal", c.issueMetalName);
-  q.bindValue(":purity", c.issueMetalPurity);
-  q.bindValue(":metalWt", c.issueMetalWt);
-  q.bindValue(":diaPcs", c.issueDiamondPcs);
-  q.bindValue(":diaWt", c.issueDiamondWt);
+  static const QString sql =
+      QString("INSERT INTO casting_entry (job_id, %1, accountant_id) "
+              "VALUES (?, %2, ?)")
+          .arg(RowMapper::columnList(RowMapper::columnsOf<CastingData>()),
+               RowMapper::placeholders(RowMapper::columnsOf<CastingData>()));
+  constexpr int n = RowMapper::count(RowMapper::columnsOf<CastingData>());
 
-  q.bindValue(":runner", c.receiveRunnerWt);
-  q.bindValue(":product", c.receiveProductWt);
-  q.bindValue(":recvDiaPcs", c.receiveDiamondPcs);
-  q.bindValue(":recvDiaWt", c.receiveDiamondWt);
-
-  q.bindValue(":acc", c.accountantId);
-  q.bindValue(":status", c.status);
+  q.prepare(sql);
+  q.bindValue(0, c.jobId);
+  RowMapper::bind(q, c, RowMapper::columnsOf<CastingData>(), 1);
+  q.bindValue(n + 1, c.accountantId);
 
   if (!q.exec()) {
-    db.rollback();
+    tx.rollback();
     qCritical() << q.lastError();
     return false;
   }
 
-  return db.commit();
+  if (!tx.commit())
+    return false;
+  QueryCache::instance().bump("casting_entry");
+  return true;
 }
 
 bool DatabaseUtils::updateCastingDiaPrice(int jobId, double price) {
@@ -840,7 +607,8 @@ bool DatabaseUtils::updateCastingDiaPrice(int jobId, double price) {
     return false;
   }
   QSqlQuery q(db);
-  q.prepare("UPDATE casting_entry SET dia_price = :p WHERE job_id = :id");
+  q.prepare("UPDATE casting_entry SET dia_price = :p, "
+            "row_version = row_version + 1 WHERE job_id = :id");
   q.bindValue(":p", price);
   q.bindValue(":id", jobId);
 
@@ -848,6 +616,7 @@ bool DatabaseUtils::updateCastingDiaPrice(int jobId, double price) {
     qCritical() << "Failed to update dia_price:" << q.lastError();
     return false;
   }
+  QueryCache::instance().bump("casting_entry");
   return true;
 }
 
@@ -858,46 +627,33 @@ bool DatabaseUtils::updateCasting(int castingId, const CastingData &c) {
     return false;
   }
   QSqlQuery q(db);
-  q.prepare(R"(
-        UPDATE casting_entry SET
-            casting_date = :date,
-            casting_name = :name,
-            pcs = :pcs,
-
-            issue_metal_name = :metal,
-            issue_metal_purity = :purity,
-            issue_metal_wt = :metalWt,
-            issue_diamond_pcs = :diaPcs,
-            issue_diamond_wt = :diaWt,
-
-            receive_runner_wt = :runner,
-            receive_product_wt = :product,
-            receive_diamond_pcs = :recvDiaPcs,
-            receive_diamond_wt = :recvDiaWt,
-
-            status = :status
-        WHERE id = :id
-    )");
 
-  q.bindValue(":id", castingId);
-  q.bindValue(":date", c.castingDate);
-  q.bindValue(":name", c.castingName);
-  q.bindValue(":pcs", c.pcs);
+  static const QString sql =
+      QString("UPDATE casting_entry SET %1, row_version = row_version + 1 "
+              "WHERE id = ?")
+          .arg(RowMapper::assignments(RowMapper::columnsOf<CastingData>()));
+  constexpr int n = RowMapper::count(RowMapper::columnsOf<CastingData>());
 
-  q.bindValue(":metal", c.issueMetalName);
-  q.bindValue(":purity", c.issueMetalPurity);
-  q.bindValue(":metalWt", c.issueMetalWt);
-  q.bindValue(":diaPcs", c.issueDiamondPcs);
-  q.bindValue(":diaWt", c.issueDiamondWt);
+  q.prepare(sql);
+  RowMapper::bind(q, c, RowMapper::columnsOf<CastingData>());
+  q.bindValue(n, castingId);
 
-  q.bindValue(":runner", c.receiveRunnerWt);
-  q.bindValue(":product", c.receiveProductWt);
-  q.bindValue(":recvDiaPcs", c.receiveDiamondPcs);
-  q.bindValue(":recvDiaWt", c.receiveDiamondWt);
+  if (!q.exec())
+    return false;
+  QueryCache::instance().bump("casting_entry");
+  return true;
+}
 
-  q.bindValue(":status", c.status);
+DatabaseUtils::CasResult
+DatabaseUtils::updateCastingChanges(int castingId, const CastingData &before,
+                                    CastingData &after) {
+  QStringList written;
+  const CasResult result = updateChangedColumns(
+      "updateCastingChanges", "casting_entry", castingId, before, after,
+      written);
 
-  return q.exec();
+  ChangeNotifier::notify("casting_entry", castingId, written);
+  return result;
 }
 
 bool DatabaseUtils::getCastingDataByJob(int jobId, CastingData &c) {
@@ -907,27 +663,14 @@ bool DatabaseUtils::getCastingDataByJob(int jobId, CastingData &c) {
     return false;
   }
   QSqlQuery q(db);
+  q.setForwardOnly(true);
 
-  q.prepare(R"(
-        SELECT
-            id,
-            casting_date,
-            casting_name,
-            pcs,
-            issue_metal_name,
-            issue_metal_purity,
-            issue_metal_wt,
-            issue_diamond_pcs,
-            issue_diamond_wt,
-            receive_runner_wt,
-            receive_product_wt,
-            receive_diamond_pcs,
-            receive_diamond_wt,
-            status
-        FROM casting_entry
-        WHERE job_id = :job
-    )");
+  static const QString sql =
+      QString("SELECT id, row_version, %1 FROM casting_entry "
+              "WHERE job_id = :job")
+          .arg(RowMapper::columnList(RowMapper::columnsOf<CastingData>()));
 
+  q.prepare(sql);
   q.bindValue(":job", jobId);
 
   if (!q.exec()) {
@@ -940,22 +683,8 @@ bool DatabaseUtils::getCastingDataByJob(int jobId, CastingData &c) {
 
   c.id = q.value(0).toInt();
   c.jobId = jobId;
-  c.castingDate = q.value(1).toString();
-  c.castingName = q.value(2).toString();
-  c.pcs = q.value(3).toInt();
-
-  c.issueMetalName = q.value(4).toString();
-  c.issueMetalPurity = q.value(5).toString();
-  c.issueMetalWt = q.value(6).toDouble();
-  c.issueDiamondPcs = q.value(7).toInt();
-  c.issueDiamondWt = q.value(8).toDouble();
-
-  c.receiveRunnerWt = q.value(9).toDouble();
-  c.receiveProductWt = q.value(10).toDouble();
-  c.receiveDiamondPcs = q.value(11).toInt();
-  c.receiveDiamondWt = q.value(12).toDouble();
-
-  c.status = q.value(13).toString();
+  c.rowVersion = q.value(1).toInt();
+  RowMapper::read(q, c, RowMapper::columnsOf<CastingData>(), 2);
 
   return true;
 }
@@ -966,7 +695,7 @@ std::optional<JobSheetData> DatabaseUtils::fetchJobSheetData(int jobId) {
   {
     QSqlDatabase db = DatabaseManager::instance().database();
 
-    if (!db.open()) {
+    if (!db.isOpen() && !db.open()) {
       qWarning() << "[ERROR] Failed to open DB in fetchJobSheetData:"
                  << db.lastError().text();
       return std::nullopt;
@@ -1025,7 +754,7 @@ DatabaseUtils::fetchDiamondAndStoneJson(const QString &designNo) {
   {
     QSqlDatabase db = DatabaseManager::instance().database();
 
-    if (!db.open()) {
+    if (!db.isOpen() && !db.open()) {
       qWarning() << "[ERROR] Failed to open DB in fetchDiamondAndStoneJson:"
                  << db.lastError().text();
       return {};
@@ -1119,7 +848,7 @@ QString DatabaseUtils::fetchImagePathForDesign(const QString &designNo) {
   {
     QSqlDatabase db = DatabaseManager::instance().database();
 
-    if (db.open()) {
+    if (db.isOpen() || db.open()) {
       QSqlQuery query(db);
       query.prepare(
           "SELECT image_path FROM image_data WHERE design_no = :designNo");
@@ -1188,11 +917,12 @@ bool DatabaseUtils::updateDesignNoAndImagePath(int jobId,
   {
     QSqlDatabase db = DatabaseManager::instance().database();
 
-    if (db.open()) {
+    if (db.isOpen() || db.open()) {
       QSqlQuery query(db);
       query.prepare(R"(
                 UPDATE order_book_detail
-                SET designNo = :designNo, image1path = :imagePath
+                SET designNo = :designNo, image1path = :imagePath,
+                    row_version = row_version + 1
                 WHERE job_id = :jobId
             )");
       query.bindValue(":designNo", designNo);
@@ -1202,6 +932,8 @@ bool DatabaseUtils::updateDesignNoAndImagePath(int jobId,
       if (query.exec()) {
         qDebug() << "[+] Design number and image path updated for jobId:"
                  << jobId;
+        JobSheetCache::instance().invalidate(jobId);
+        QueryCache::instance().bump("order_book_detail");
         success = true;
       } else {
         qWarning() << "[ERROR] Failed to update order_book_detail:"
@@ -1261,47 +993,27 @@ QString DatabaseUtils::insertCatalogData(
     QJsonDocument diamondDoc(diamondArray);
     QJsonDocument stoneDoc(stoneArray);
 
-    // --- Check if designNo exists ---
-    bool exists = false;
-    {
-      QSqlQuery checkQuery(db);
-      checkQuery.prepare("SELECT COUNT(*) FROM image_data WHERE design_no = "
-                         ":design_no AND \"delete\" = 0");
-      checkQuery.bindValue(":design_no", designNo);
-
-      if (checkQuery.exec() && checkQuery.next()) {
-        exists = (checkQuery.value(0).toInt() > 0);
-      } else {
-        qDebug() << "Check designNo failed:" << checkQuery.lastError().text();
-      }
-    }
-
+    // --- Insert, or update the live design with this number ---
+    // One statement against the partial unique index on live design_no
+    // rows; `revision` is 0 only for a row this statement created
     QSqlQuery query(db);
-    if (exists) {
-      // --- UPDATE existing record ---
-      success = "modify";
-      query.prepare(R"(
-                UPDATE image_data SET
-                    image_path = :image_path,
-                    image_type = :image_type,
-                    company_name = :company_name,
-                    gold_weight = :gold_weight,
-                    diamond = :diamond,
-                    stone = :stone,
-                    time = :time,
-                    note = :note
-                WHERE design_no = :design_no
-            )");
-    } else {
-      // --- INSERT new record ---
-      success = "insert";
-      query.prepare(R"(
-                INSERT INTO image_data
-                    (image_path, image_type, design_no, company_name, gold_weight, diamond, stone, time, note)
-                VALUES
-                    (:image_path, :image_type, :design_no, :company_name, :gold_weight, :diamond, :stone, :time, :note)
-            )");
-    }
+    query.prepare(R"(
+            INSERT INTO image_data
+                (image_path, image_type, design_no, company_name, gold_weight, diamond, stone, time, note)
+            VALUES
+                (:image_path, :image_type, :design_no, :company_name, :gold_weight, :diamond, :stone, :time, :note)
+            ON CONFLICT(design_no) WHERE "delete" = 0 DO UPDATE SET
+                image_path = excluded.image_path,
+                image_type = excluded.image_type,
+                company_name = excluded.company_name,
+                gold_weight = excluded.gold_weight,
+                diamond = excluded.diamond,
+                stone = excluded.stone,
+                time = excluded.time,
+                note = excluded.note,
+                revision = revision + 1
+            RETURNING revision
+        )");
 
     query.bindValue(":image_path", imagePath);
     query.bindValue(":image_type", imageType);
@@ -1314,49 +1026,62 @@ QString DatabaseUtils::insertCatalogData(
                     QDateTime::currentDateTime().toString(Qt::ISODate));
     query.bindValue(":note", note);
 
-    if (!query.exec()) {
-      qDebug() << (exists ? "Update failed:" : "Insert failed:")
-               << query.lastError().text();
+    if (!query.exec() || !query.next()) {
+      qDebug() << "Catalog upsert failed:" << query.lastError().text();
       success = "error";
+    } else if (query.value(0).toInt() == 0) {
+      success = "insert";
+      QueryCache::instance().bump("image_data");
+    } else {
+      success = "modify";
+      QueryCache::instance().bump("image_data");
+      // Cached job sheets embed this design's stone list
+      JobSheetCache::instance().clear();
     }
   }
 
   return success;
 }
 
-QString DatabaseUtils::saveImage(const QString &imagePath) {
+QString DatabaseUtils::saveImage(const QString &imagePath,
+                                 const std::function<void(int)> &progress) {
   QFileInfo sourceInfo(imagePath);
   if (!sourceInfo.exists()) {
     qWarning() << "Source image does not exist:" << imagePath;
     return {};
   }
 
-  // 1. Get the file extension (e.g., "jpg", "png")
-  QString extension = sourceInfo.suffix();
+  QString targetDir =
+      QDir(QCoreApplication::applicationDirPath()).filePath("images");
 
-  // 2. Generate a new, unique filename using a UUID
+  // Already ingested (e.g. ModifyCatalog saving without a new photo):
+  // re-encoding it again would only lose quality
+  if (sourceInfo.absoluteDir() == QDir(targetDir)) {
+    if (progress)
+      progress(100);
+    return "images/" + sourceInfo.fileName();
+  }
+
+  // 1. Generate a new, unique base name using a UUID; the extension is
+  // chosen by the ingest step
   // Example result: "date_67c9a2e65a5c4c6d979953a1a632b70d.jpg"
-  QString uniqueName = QDate::currentDate().toString("'MM_dd_yyyy'_") +
-                       QUuid::createUuid().toString(QUuid::WithoutBraces) +
-                       "." + extension;
+  QString uniqueBase = QDate::currentDate().toString("'MM_dd_yyyy'_") +
+                       QUuid::createUuid().toString(QUuid::WithoutBraces);
 
-  // 3. Construct the full destination path where the file will be saved
-  QString targetDir =
-      QDir(QCoreApplication::applicationDirPath()).filePath("images");
+  // 2. Construct the destination where the master will be saved
   QDir().mkpath(targetDir); // Ensure the directory exists
-  QString newImagePath = QDir(targetDir).filePath(uniqueName);
 
-  // 4. Perform the copy operation
-  if (!QFile::copy(imagePath, newImagePath)) {
-    qWarning() << "Failed to copy image from" << imagePath << "to"
-               << newImagePath;
+  // 3. Orient, downsize and re-encode instead of copying verbatim
+  QString masterPath = ImageIngest::ingest(
+      imagePath, QDir(targetDir).filePath(uniqueBase), progress);
+  if (masterPath.isEmpty()) {
+    qWarning() << "Failed to ingest image from" << imagePath << "into"
+               << targetDir;
     return {};
   }
 
-  // 5. MODIFIED: Return the relative path in the exact format
-  // "images/filename.type" The filename here is our new unique filename.
-
-  return "images/" + uniqueName;
+  // 4. Return the relative path in the exact format "images/filename.type"
+  return "images/" + QFileInfo(masterPath).fileName();
 }
 
 bool DatabaseUtils::excelBulkInsertCatalog(const QString &filePath) {
@@ -1437,13 +1162,15 @@ bool DatabaseUtils::excelBulkInsertCatalog(const QString &filePath) {
   // 4. Insert All Into DB
   QSqlDatabase db = DatabaseManager::instance().database();
 
-  if (!db.open()) {
+  if (!db.isOpen() && !db.open()) {
     qWarning() << "DB open failed";
     return false;
   }
 
   QSqlQuery query(db);
-  db.transaction(); // bulk insert = faster
+  WriteTransaction tx(db, "excelBulkInsertCatalog");
+  if (!tx.begin()) // bulk insert = faster
+    return false;
 
   for (auto it = catalogMap.begin(); it != catalogMap.end(); ++it) {
     const QJsonObject &catalog = it.value();
@@ -1459,46 +1186,26 @@ bool DatabaseUtils::excelBulkInsertCatalog(const QString &filePath) {
 
     QString designNo = catalog["designNo"].toString();
 
-    // Check if design already exists
-
-    QSqlQuery checkQuery(db);
-    checkQuery.prepare(
-        "SELECT COUNT(*) FROM image_data WHERE design_no = :design_no");
-    checkQuery.bindValue(":design_no", designNo);
-
-    if (!checkQuery.exec()) {
-      qWarning() << "Check query failed: " << checkQuery.lastError().text();
-      continue;
-    }
-
-    checkQuery.next();
-    bool designNoExists = checkQuery.value(0).toInt() > 0;
-    if (designNoExists) {
-      // Update design values
-      query.prepare(R"(
-                UPDATE image_data
-                SET image_path = :image_path,
-                    image_type = :image_type,
-                    company_name = :company_name,
-                    gold_weight = :gold_weight,
-                    diamond = :diamond,
-                    stone = :stone,
-                    note = :note,
-                    time = :time
-                WHERE design_no = :design_no
-            )");
-    } else {
-      // Insert new design
-      query.prepare(R"(
+    // Insert, or update the live design with this number
+    query.prepare(R"(
                 INSERT INTO image_data
                 (image_path, image_type, design_no, company_name, gold_weight, diamond, stone, time, note)
                 VALUES (:image_path, :image_type, :design_no, :company_name, :gold_weight, :diamond, :stone, :time, :note)
+                ON CONFLICT(design_no) WHERE "delete" = 0 DO UPDATE SET
+                    image_path = excluded.image_path,
+                    image_type = excluded.image_type,
+                    company_name = excluded.company_name,
+                    gold_weight = excluded.gold_weight,
+                    diamond = excluded.diamond,
+                    stone = excluded.stone,
+                    note = excluded.note,
+                    time = excluded.time,
+                    revision = revision + 1
             )");
-    }
 
     query.bindValue(":image_path", catalog["imagePath"].toString());
     query.bindValue(":image_type", catalog["type"].toString());
-    query.bindValue(":design_no", catalog["designNo"].toString());
+    query.bindValue(":design_no", designNo);
     query.bindValue(":company_name", catalog["companyName"].toString());
     query.bindValue(":gold_weight", goldDoc.toJson(QJsonDocument::Compact));
     query.bindValue(":diamond", diamondDoc.toJson(QJsonDocument::Compact));
@@ -1508,27 +1215,25 @@ bool DatabaseUtils::excelBulkInsertCatalog(const QString &filePath) {
     query.bindValue(":note", catalog["note"].toString());
 
     if (!query.exec()) {
-      if (designNoExists) {
-        qWarning() << "[ERROR] Bulk update failed for design "
-                   << catalog["designNo"].toString() << ":"
-                   << query.lastError().text();
-        ;
-      } else {
-        qWarning() << "[ERROR] Bulk insert failed for design "
-                   << catalog["designNo"].toString() << ":"
-                   << query.lastError().text();
-      }
+      qWarning() << "[ERROR] Bulk upsert failed for design "
+                 << catalog["designNo"].toString() << ":"
+                 << query.lastError().text();
     }
   }
 
-  db.commit();
-
+  if (!tx.commit())
+    return false;
+  QueryCache::instance().bump("image_data");
   return true;
 }
 
 // JobSheet History Logic
 QJsonArray DatabaseUtils::fetchJobSheetHistory(const QString &jobNo,
-                                               const QString &colName) {
+                                               const QString &colName,
+                                               int *rowVersion) {
+  if (rowVersion)
+    *rowVersion = 0;
+
   QSqlDatabase db = DatabaseManager::instance().database();
   if (!db.isOpen() && !db.open()) {
     qCritical() << "Database not open in fetchJobSheetHistory";
@@ -1538,11 +1243,14 @@ QJsonArray DatabaseUtils::fetchJobSheetHistory(const QString &jobNo,
   QSqlQuery q(db);
   // Use quote for colName to prevent syntax error if colName has weird chars,
   // though it should be safe (diamond_issue etc.)
-  q.prepare(QString("SELECT \"%1\" FROM jobsheet_detail WHERE job_no = :jobNo")
+  q.prepare(QString("SELECT \"%1\", row_version FROM jobsheet_detail "
+                    "WHERE job_no = :jobNo")
                 .arg(colName));
   q.bindValue(":jobNo", jobNo);
 
   if (q.exec() && q.next()) {
+    if (rowVersion)
+      *rowVersion = q.value(1).toInt();
     QString jsonStr = q.value(0).toString();
     if (!jsonStr.isEmpty()) {
       QJsonDocument doc = QJsonDocument::fromJson(jsonStr.toUtf8());
@@ -1556,7 +1264,10 @@ QJsonArray DatabaseUtils::fetchJobSheetHistory(const QString &jobNo,
 
 bool DatabaseUtils::addJobSheetHistoryEntry(const QString &jobNo,
                                             const QString &colName,
-                                            const QJsonObject &entry) {
+                                            const QJsonObject &entry,
+                                            int *rowVersion, bool *conflict) {
+  if (conflict)
+    *conflict = false;
   QSqlDatabase db = DatabaseManager::instance().database();
   if (!db.isOpen() && !db.open()) {
     qCritical() << "Database not open in addJobSheetHistoryEntry";
@@ -1565,53 +1276,74 @@ bool DatabaseUtils::addJobSheetHistoryEntry(const QString &jobNo,
 
   // 1. Ensure row exists for this jobNo
   {
-    QSqlQuery check(db);
-    check.prepare("SELECT COUNT(*) FROM jobsheet_detail WHERE job_no = :jobNo");
-    check.bindValue(":jobNo", jobNo);
-    if (check.exec() && check.next() && check.value(0).toInt() == 0) {
-      QSqlQuery insert(db);
-      insert.prepare("INSERT INTO jobsheet_detail (job_no) VALUES (:jobNo)");
-      insert.bindValue(":jobNo", jobNo);
-      if (!insert.exec()) {
-        qCritical() << "Failed to create jobsheet_detail row:"
-                    << insert.lastError().text();
-        return false;
-      }
+    QSqlQuery insert(db);
+    insert.prepare("INSERT INTO jobsheet_detail (job_no) VALUES (:jobNo) "
+                   "ON CONFLICT(job_no) DO NOTHING");
+    insert.bindValue(":jobNo", jobNo);
+    if (!insert.exec()) {
+      qCritical() << "Failed to create jobsheet_detail row:"
+                  << insert.lastError().text();
+      return false;
     }
   }
 
-  // 2. Fetch existing
-  QJsonArray arr = fetchJobSheetHistory(jobNo, colName);
+  // 2-4. Read, append, compare-and-swap on row_version: first on the
+  // version the caller showed, then on the one just read. Losing the race
+  // to another workstation means its entry is already in the row: read
+  // again and append on top, so neither entry is lost.
+  const int shown = rowVersion ? *rowVersion : -1;
+  constexpr int kAttempts = 5;
+  for (int attempt = 0; attempt < kAttempts; ++attempt) {
+    int version = 0;
+    QJsonArray arr = fetchJobSheetHistory(jobNo, colName, &version);
+    const bool againstShown = attempt == 0 && shown >= 0;
+    if (againstShown)
+      version = shown;
 
-  // 3. Append
-  arr.append(entry);
-  QString jsonStr =
-      QString::fromUtf8(QJsonDocument(arr).toJson(QJsonDocument::Compact));
+    arr.append(entry);
+    QString jsonStr =
+        QString::fromUtf8(QJsonDocument(arr).toJson(QJsonDocument::Compact));
 
-  // 4. Update
-  QSqlQuery q(db);
-  q.prepare(
-      QString("UPDATE jobsheet_detail SET \"%1\" = :val WHERE job_no = :jobNo")
-          .arg(colName));
-  q.bindValue(":val", jsonStr);
-  q.bindValue(":jobNo", jobNo);
+    QSqlQuery q(db);
+    q.prepare(QString("UPDATE jobsheet_detail SET \"%1\" = :val, "
+                      "row_version = row_version + 1 "
+                      "WHERE job_no = :jobNo AND row_version = :version")
+                  .arg(colName));
+    q.bindValue(":val", jsonStr);
+    q.bindValue(":jobNo", jobNo);
+    q.bindValue(":version", version);
 
-  if (!q.exec()) {
-    qCritical() << "Failed to update jobsheet history:" << q.lastError().text();
-    return false;
+    if (!q.exec()) {
+      qCritical() << "Failed to update jobsheet history:"
+                  << q.lastError().text();
+      return false;
+    }
+    if (q.numRowsAffected() == 0) {
+      if (againstShown && conflict)
+        *conflict = true;
+      continue;
+    }
+
+    if (rowVersion)
+      *rowVersion = version + 1;
+    JobSheetCache::instance().invalidate(jobNo);
+    ChangeNotifier::notify("jobsheet_detail", jobNo.toInt(), {colName});
+    return true;
   }
-  return true;
+
+  qWarning() << "addJobSheetHistoryEntry: job" << jobNo << "kept changing,"
+             << "gave up after" << kAttempts << "attempts";
+  return false;
 }
 
 // AddCatalog Logic
 QStringList DatabaseUtils::fetchShapes(const QString &tableType) {
   QStringList shapes;
 
-  // Use ad-hoc connection for strictly reference data (legacy file)
   {
     QSqlDatabase db = DatabaseManager::instance().database();
 
-    if (db.open()) {
+    if (db.isOpen() || db.open()) {
       QSqlQuery query(db);
       QString queryStr = (tableType == "diamond")
                              ? "SELECT DISTINCT shape FROM Fancy_diamond UNION "
@@ -1625,11 +1357,9 @@ QStringList DatabaseUtils::fetchShapes(const QString &tableType) {
       } else {
         qWarning() << "fetchShapes query failed:" << query.lastError().text();
       }
-      db.close();
     } else {
       qWarning() << "Failed to open reference DB:" << db.lastError().text();
     }
-    QSqlDatabase::removeDatabase("ref_data_conn_shapes");
   }
   return shapes;
 }
@@ -1642,7 +1372,7 @@ QStringList DatabaseUtils::fetchSizes(const QString &tableType,
     QSqlDatabase db = DatabaseManager::instance().database();
     // db.setDatabaseName(dbPath);
 
-    if (db.open()) {
+    if (db.isOpen() || db.open()) {
       QSqlQuery query(db);
 
       if (tableType == "diamond") {
@@ -1666,49 +1396,22 @@ QStringList DatabaseUtils::fetchSizes(const QString &tableType,
           sizes.append(query.value(0).toString());
         }
       }
-      db.close();
     }
-    QSqlDatabase::removeDatabase("ref_data_conn_sizes");
   }
 
   return sizes;
 }
 
-QList<JobListData> DatabaseUtils::getJobsList() {
-  QList<JobListData> list;
+namespace {
+// Uncached; see DatabaseUtils::getJobsList()
+bool loadJobsList(QList<JobListData> &list) {
   QSqlDatabase db = DatabaseManager::instance().database();
   if (!db.isOpen() && !db.open()) {
     qCritical() << "Database not open in getJobsList";
-    return list;
+    return false;
   }
   QSqlQuery q(db);
 
-  // Check if office_receive column exists before querying, add if missing
-  {
-    QSqlQuery check(db);
-    check.prepare("PRAGMA table_info(jobsheet_detail)");
-    bool hasCol = false;
-    if (check.exec()) {
-      while (check.next()) {
-        if (check.value("name").toString() == "office_receive") {
-          hasCol = true;
-          break;
-        }
-      }
-    }
-
-    if (!hasCol) {
-      qDebug()
-          << "Column 'office_receive' missing in jobsheet_detail, adding it.";
-      QSqlQuery addCol(db);
-      if (!addCol.exec("ALTER TABLE jobsheet_detail ADD COLUMN office_receive "
-                       "REAL DEFAULT 0")) {
-        qCritical() << "Failed to add office_receive column:"
-                    << addCol.lastError();
-      }
-    }
-  }
-
   if (!q.prepare(R"(
         SELECT 
             od.job_id,
@@ -1717,6 +1420,7 @@ QList<JobListData> DatabaseUtils::getJobsList() {
             od.productPis,
             od.metalName, 
             od.metalPurity,
+            od.metalFineness,
             
             c.status,
             c.casting_date, 
@@ -1744,7 +1448,10 @@ QList<JobListData> DatabaseUtils::getJobsList() {
             jd.stone_return,
             jd.office_gold_receive,
             jd.office_receive,
-            jd.manufacturer_mfg_receive
+            jd.manufacturer_mfg_receive,
+            jd.office_gold_receive_mg,
+            jd.office_receive_mg,
+            jd.manufacturer_mfg_receive_mg
             
         FROM order_book_detail od
         LEFT JOIN casting_entry c ON od.job_id = c.job_id
@@ -1753,20 +1460,20 @@ QList<JobListData> DatabaseUtils::getJobsList() {
         ORDER BY od.deliveryDate ASC
     )")) {
     qCritical() << "Failed to prepare jobs list query:" << q.lastError();
-    return list;
+    return false;
   }
 
   if (!q.exec()) {
     qCritical() << "Failed to fetch jobs list:" << q.lastError()
                 << " Driver Text:" << q.lastError().databaseText()
                 << " Driver Code:" << q.lastError().nativeErrorCode();
-    return list;
+    return false;
   }
 
   // Helper to parse JSON for Pcs/Wt
   auto parseJson = [](const QString &json) -> QPair<int, double> {
     int tPcs = 0;
-    double tWt = 0.0;
+    Milligrams tWt; // summed exactly
     if (json.isEmpty())
       return {0, 0.0};
     QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
@@ -1784,53 +1491,49 @@ QList<JobListData> DatabaseUtils::getJobsList() {
                                          : obj["quantity"].toInt();
         }
 
-        double w = obj["wt"].isString() ? obj["wt"].toString().toDouble()
-                                        : obj["wt"].toDouble();
-        if (w == 0.0 && obj.contains("weight")) {
-          w = obj["weight"].isString() ? obj["weight"].toString().toDouble()
-                                       : obj["weight"].toDouble();
-        }
+        Milligrams w = weightOf(obj["wt"]);
+        if (w == Milligrams() && obj.contains("weight"))
+          w = weightOf(obj["weight"]);
         tPcs += p;
         tWt += w;
       }
     }
-    return {tPcs, tWt};
+    return {tPcs, tWt.toDouble()};
   };
 
   // Helper for gold weight only
   auto parseGoldJson = [](const QString &json) -> double {
-    double tWt = 0.0;
+    Milligrams tWt;
     if (json.isEmpty())
       return 0.0;
     QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
     if (doc.isArray()) {
       for (const QJsonValue &v : doc.array()) {
-        if (v.isObject()) {
-          QJsonObject obj = v.toObject();
-          double w = obj["weight"].isString()
-                         ? obj["weight"].toString().toDouble()
-                         : obj["weight"].toDouble();
-          tWt += w;
-        }
+        if (v.isObject())
+          tWt += weightOf(v.toObject()["weight"]);
       }
     }
-    return tWt;
+    return tWt.toDouble();
   };
 
+  // Metals, purities, statuses, categories and dates repeat down the list
+  static const QString kPending = QStringLiteral("PENDING");
+  StringPool pool;
   while (q.next()) {
-    JobListData d;
+    JobListData d{};
     d.jobId = q.value("job_id").toInt(); // od.job_id
     d.designNo = q.value("designNo").toString();
-    d.deliveryDate = q.value("deliveryDate").toString();
+    d.deliveryDate = pool.intern(q.value("deliveryDate").toString());
     d.pcs = q.value("productPis").toInt();
-    d.metal = q.value("metalName").toString();
-    d.purity = q.value("metalPurity").toString();
+    d.metal = pool.intern(q.value("metalName").toString());
+    d.purity = pool.intern(q.value("metalPurity").toString());
+    d.fineness = q.value("metalFineness").toDouble();
 
-    d.status = q.value("status").toString();
+    d.status = pool.intern(q.value("status").toString());
     if (d.status.isEmpty())
-      d.status = "PENDING";
+      d.status = kPending;
 
-    d.mfgIssueDate = q.value("casting_date").toString();
+    d.mfgIssueDate = pool.intern(q.value("casting_date").toString());
 
     // Default from casting_entry
     d.issueWt = q.value("issue_metal_wt").toDouble();
@@ -1838,7 +1541,8 @@ QList<JobListData> DatabaseUtils::getJobsList() {
     d.issueDiaWt = q.value("issue_diamond_wt").toDouble();
     d.issueStonePcs = q.value("issue_stone_pcs").toInt();
     d.issueStoneWt = q.value("issue_stone_wt").toDouble();
-    d.issueDiaCategory = q.value("issue_diamond_category").toString();
+    d.issueDiaCategory =
+        pool.intern(q.value("issue_diamond_category").toString());
 
     d.grossWt = q.value("receive_product_wt").toDouble();
     d.receiveDiaPcs = q.value("receive_diamond_pcs").toInt();
@@ -1871,11 +1575,13 @@ QList<JobListData> DatabaseUtils::getJobsList() {
       if (!fillingReturn.isEmpty())
         d.grossWt = parseGoldJson(fillingReturn);
       if (!offGold.isEmpty())
-        d.officeGoldReceive = offGold.toDouble();
+        d.officeGoldReceive =
+            jobSheetWeight(q.value("office_gold_receive_mg"), offGold);
       if (!offRec.isEmpty())
-        d.officeReceive = offRec.toDouble();
+        d.officeReceive = jobSheetWeight(q.value("office_receive_mg"), offRec);
       if (!mfgRec.isEmpty())
-        d.manufacturerMfgReceive = mfgRec.toDouble();
+        d.manufacturerMfgReceive =
+            jobSheetWeight(q.value("manufacturer_mfg_receive_mg"), mfgRec);
 
       // Diamonds
       auto di = parseJson(diaIssue);
@@ -1898,56 +1604,86 @@ QList<JobListData> DatabaseUtils::getJobsList() {
 
     d.materialIssueWt = d.issueWt;
 
-    // Calculations
-    // Net Wt = Gross Wt (Product) - Receive Dia Wt - Receive Stone Wt
-    d.netWt = d.grossWt - d.receiveDiaWt - d.receiveStoneWt;
-
-    // Gross Loss = Issue Wt - (Net Wt + Office Gold Rec/Runner)
-    // Using simple logic: Issue - (Gross + Runner)?
-    // Usually: Issue = Gross + Loss (ignoring runner). If runner exists, Issue
-    // = Gross + Runner + Loss. So Loss = Issue - (Gross + Runner). Note:
-    // 'd.officeGoldReceive' corresponds to 'receive_runner_wt'.
-    d.grossLoss =
-        d.issueWt -
-        (d.grossWt +
-         d.officeGoldReceive); // Using grossWt (product) instead of netWt
-                               // based on usual manuf logic? Actually code
-                               // used (netWt + officeGold). Let's stick to
-                               // previous logical equivalent if grossWt
-                               // includes stones? Usually Gross Wt in
-                               // manufacturing = Gold + Stones. Net Wt =
-                               // Gold only. Loss is on Gold. So Loss = Issue
-                               // Gold - (Receive Gold + Runner). Receive
-                               // Gold = Net Wt. So Loss = Issue - (NetWt +
-                               // Runner). Matches previous code: d.issueWt -
-                               // (d.netWt + d.officeGoldReceive).
-    d.grossLoss = d.issueWt - (d.netWt + d.officeGoldReceive);
-
-    d.fineLoss = 0; // TODO logic
-
-    d.percentage = 0;
-    if (d.issueWt > 0)
-      d.percentage = (d.grossLoss / d.issueWt) * 100.0;
-
-    d.diaLoss = d.issueDiaWt - d.receiveDiaWt;
-    d.stoneLoss = d.receiveStoneWt - d.issueStoneWt;
-
-    d.remark = "";
+    d.remark = QString();
     d.dbJobId = d.jobId;
     d.jobNo = QString::number(d.jobId);
 
     list.append(d);
   }
 
+  // Net weight and losses for the whole list in one pass
+  LossEngine::apply(LedgerFormulas::forLedger("jobs"), list);
+
+  return true;
+}
+} // namespace
+
+QList<JobListData> DatabaseUtils::getJobsList() {
+  return QueryCache::instance().get<QList<JobListData>>(
+      "getJobsList",
+      {"order_book_detail", "casting_entry", "jobs", "jobsheet_detail",
+       "ledger_formulas"},
+      loadJobsList);
+}
+
+QList<JobTotalsRow> DatabaseUtils::getJobsByTotal(const QString &column,
+                                                  int limit,
+                                                  const Dates::Range &due,
+                                                  double minimum) {
+  QList<JobTotalsRow> list;
+  // Spliced into the SQL, so only the indexed columns
+  static const QStringList kColumns = {"net_wt", "gross_loss", "loss_pct"};
+  if (!kColumns.contains(column)) {
+    qWarning() << "getJobsByTotal: not a job_totals column:" << column;
+    return list;
+  }
+  QSqlDatabase db = DatabaseManager::instance().database();
+  if (!db.isOpen() && !db.open()) {
+    qCritical() << "Database not open in getJobsByTotal";
+    return list;
+  }
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+
+  q.prepare(QString(R"(
+        SELECT t.job_id, od.designNo, od.deliveryDate,
+               t.net_wt, t.gross_loss, t.loss_pct
+        FROM job_totals t
+        JOIN order_book_detail od ON od.job_id = t.job_id
+        WHERE t.%1 >= :minimum%2
+        ORDER BY t.%1 DESC
+        LIMIT :limit
+    )")
+                .arg(column, rangeClause("od.deliveryDate", due)));
+  q.bindValue(":minimum", minimum);
+  q.bindValue(":limit", limit);
+  bindRange(q, due);
+
+  if (!q.exec()) {
+    qCritical() << "getJobsByTotal failed:" << q.lastError();
+    return list;
+  }
+
+  while (q.next()) {
+    JobTotalsRow r;
+    r.jobId = q.value(0).toInt();
+    r.designNo = q.value(1).toString();
+    r.deliveryDate = q.value(2).toString();
+    r.netWt = q.value(3).toDouble();
+    r.grossLoss = q.value(4).toDouble();
+    r.lossPct = q.value(5).toDouble();
+    list.append(r);
+  }
   return list;
 }
 
-QList<DesignerOrderData> DatabaseUtils::getDesignerOrders() {
-  QList<DesignerOrderData> list;
+namespace {
+// Uncached; see DatabaseUtils::getDesignerOrders()
+bool loadDesignerOrders(QList<DesignerOrderData> &list) {
   QSqlDatabase db = DatabaseManager::instance().database();
   if (!db.isOpen() && !db.open()) {
     qCritical() << "Database not open in getDesignerOrders";
-    return list;
+    return false;
   }
   QSqlQuery q(db);
 
@@ -1975,7 +1711,7 @@ QList<DesignerOrderData> DatabaseUtils::getDesignerOrders() {
 
   if (!q.exec()) {
     qCritical() << "getDesignerOrders failed:" << q.lastError();
-    return list;
+    return false;
   }
 
   while (q.next()) {
@@ -1996,7 +1732,14 @@ QList<DesignerOrderData> DatabaseUtils::getDesignerOrders() {
     list.append(d);
   }
 
-  return list;
+  return true;
+}
+} // namespace
+
+QList<DesignerOrderData> DatabaseUtils::getDesignerOrders() {
+  return QueryCache::instance().get<QList<DesignerOrderData>>(
+      "getDesignerOrders", {"order_book_detail", "order_status", "jobs"},
+      loadDesignerOrders);
 }
 
 QMap<QString, QPair<int, double>>
@@ -2081,58 +1824,64 @@ GoldTotals DatabaseUtils::fetchGoldTotals(const QString &jobNo) {
   QSqlQuery query(db);
   // jobNo is TEXT, so no conversion needed
 
-  query.prepare(R"(
+  // With the SQL functions SQLite sums the issue and return arrays
+  // (json_weight_sum); otherwise they are parsed here the same way
+  const bool sqlSums = SqlFunctions::available(db);
+  query.prepare(QString(R"(
         SELECT filling_issue, filling_dust, filling_return,
-               buffing_return, free_polish_return, setting_return, final_polish_return
-        FROM jobsheet_detail WHERE job_no = ?
-    )");
+               buffing_return, free_polish_return, setting_return, final_polish_return,
+               buffing_return_mg, free_polish_return_mg, setting_return_mg,
+               final_polish_return_mg, %1
+        FROM jobsheet_detail WHERE job_no = ?%2
+    )")
+                    .arg(sqlSums ? QString("json_weight_sum(filling_issue), "
+                                           "json_weight_sum(filling_return)")
+                                 : QString("NULL, NULL"),
+                         sqlSums ? QString(" GROUP BY job_no") : QString()));
   query.addBindValue(jobNo);
 
   if (query.exec() && query.next()) {
-    // Issue
-    QString issueJson = query.value(0).toString();
-    if (!issueJson.isEmpty()) {
-      QJsonDocument doc = QJsonDocument::fromJson(issueJson.toUtf8());
-      if (doc.isArray()) {
-        for (const QJsonValue &val : doc.array())
-          if (val.isObject())
-            totals.totalIssue += val.toObject()["weight"].toString().toDouble();
+    // Sum of the "weight" (or "wt") entries of a JSON array, in exact
+    // milligrams, as json_weight_sum() does
+    auto sumWeights = [](const QString &json) {
+      Milligrams sum;
+      const QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+      for (const QJsonValue &val : doc.array()) {
+        const QJsonObject entry = val.toObject();
+        sum += weightOf(entry.contains("weight") ? entry["weight"]
+                                                 : entry["wt"]);
       }
-    }
+      return sum.toDouble();
+    };
 
-    // Dust
+    // Issue
+    totals.totalIssue = sqlSums ? query.value(11).toDouble()
+                                : sumWeights(query.value(0).toString());
+
+    // Dust: a JSON array, or a plain weight on older rows
     QString dustJson = query.value(1).toString();
     if (!dustJson.isEmpty()) {
       QJsonDocument doc = QJsonDocument::fromJson(dustJson.toUtf8());
       if (doc.isArray()) {
-        for (const QJsonValue &val : doc.array())
-          if (val.isObject())
-            totals.dustWeight += val.toObject()["weight"].toString().toDouble();
+        totals.dustWeight = sumWeights(dustJson);
       } else {
         bool ok = false;
-        double plainDust = dustJson.toDouble(&ok);
+        const Milligrams plainDust = Milligrams::parse(dustJson, &ok);
         if (ok)
-          totals.dustWeight = plainDust;
+          totals.dustWeight = plainDust.toDouble();
       }
     }
 
     // Return (Grand)
     totals.returnJson = query.value(2).toString();
-    if (!totals.returnJson.isEmpty()) {
-      QJsonDocument doc = QJsonDocument::fromJson(totals.returnJson.toUtf8());
-      if (doc.isArray()) {
-        for (const QJsonValue &val : doc.array())
-          if (val.isObject())
-            totals.totalReturn +=
-                val.toObject()["weight"].toString().toDouble();
-      }
-    }
+    totals.totalReturn = sqlSums ? query.value(12).toDouble()
+                                 : sumWeights(totals.returnJson);
 
     // Stage returns
-    totals.buffingReturn = query.value(3).toDouble();
-    totals.freePolishReturn = query.value(4).toDouble();
-    totals.settingReturn = query.value(5).toDouble();
-    totals.finalPolishReturn = query.value(6).toDouble();
+    totals.buffingReturn = jobSheetWeight(query.value(7), query.value(3));
+    totals.freePolishReturn = jobSheetWeight(query.value(8), query.value(4));
+    totals.settingReturn = jobSheetWeight(query.value(9), query.value(5));
+    totals.finalPolishReturn = jobSheetWeight(query.value(10), query.value(6));
   }
 
   return totals;
@@ -2140,29 +1889,7 @@ GoldTotals DatabaseUtils::fetchGoldTotals(const QString &jobNo) {
 
 bool DatabaseUtils::saveGoldStageReturn(const QString &jobNo,
                                         const QString &column, double value) {
-  QSqlDatabase db = DatabaseManager::instance().database();
-  if (!db.isOpen() && !db.open())
-    return false;
-
-  QString formatted = QString::number(value, 'f', 3);
-
-  // Check lock logic if needed, but simple update is fine for now based on
-  // snippet
-  QSqlQuery q(db);
-  q.prepare("UPDATE jobsheet_detail SET " + column + " = ? WHERE job_no = ?");
-  q.addBindValue(formatted);
-  q.addBindValue(jobNo);
-
-  if (!q.exec() || q.numRowsAffected() == 0) {
-    // Fallback using job_no as key if jobsheet_detail uses job_no?
-    // Actually jobsheet_detail usually linked by job_no string
-    q.prepare("INSERT INTO jobsheet_detail (job_no, " + column +
-              ") VALUES (?, ?)");
-    q.addBindValue(jobNo);
-    q.addBindValue(formatted);
-    return q.exec();
-  }
-  return true;
+  return upsertJobSheetWeight(jobNo, column, value);
 }
 
 bool DatabaseUtils::addStock(const StockData &data) {
@@ -2170,31 +1897,20 @@ bool DatabaseUtils::addStock(const StockData &data) {
   if (!db.isOpen() && !db.open())
     return false;
 
+  static const QString sql =
+      QString("INSERT INTO stocks (%1) VALUES (%2)")
+          .arg(RowMapper::columnList(RowMapper::columnsOf<StockData>()),
+               RowMapper::placeholders(RowMapper::columnsOf<StockData>()));
+
   QSqlQuery q(db);
-  q.prepare(R"(
-        INSERT INTO stocks (
-            date, metal, detail, note, voucher_no,
-            purity, weight, weight_24k, price, amount
-        ) VALUES (
-            :date, :metal, :detail, :note, :voucher,
-            :purity, :weight, :w24k, :price, :amt
-        )
-    )");
-  q.bindValue(":date", data.date);
-  q.bindValue(":metal", data.metal);
-  q.bindValue(":detail", data.detail);
-  q.bindValue(":note", data.note);
-  q.bindValue(":voucher", data.voucherNo);
-  q.bindValue(":purity", data.purity);
-  q.bindValue(":weight", data.weight);
-  q.bindValue(":w24k", data.weight24k);
-  q.bindValue(":price", data.price);
-  q.bindValue(":amt", data.amount);
+  q.prepare(sql);
+  RowMapper::bind(q, data, RowMapper::columnsOf<StockData>());
 
   if (!q.exec()) {
     qCritical() << "addStock failed:" << q.lastError();
     return false;
   }
+  QueryCache::instance().bump("stocks");
   return true;
 }
 
@@ -2203,62 +1919,45 @@ bool DatabaseUtils::updateStock(const StockData &data) {
   if (!db.isOpen() && !db.open())
     return false;
 
+  static const QString sql =
+      QString("UPDATE stocks SET %1 WHERE id = ?")
+          .arg(RowMapper::assignments(RowMapper::columnsOf<StockData>()));
+  constexpr int n = RowMapper::count(RowMapper::columnsOf<StockData>());
+
   QSqlQuery q(db);
-  q.prepare(R"(
-        UPDATE stocks SET
-            date = :date,
-            metal = :metal,
-            detail = :detail,
-            note = :note,
-            voucher_no = :voucher,
-            purity = :purity,
-            weight = :weight,
-            weight_24k = :w24k,
-            price = :price,
-            amount = :amt
-        WHERE id = :id
-    )");
-  q.bindValue(":date", data.date);
-  q.bindValue(":metal", data.metal);
-  q.bindValue(":detail", data.detail);
-  q.bindValue(":note", data.note);
-  q.bindValue(":voucher", data.voucherNo);
-  q.bindValue(":purity", data.purity);
-  q.bindValue(":weight", data.weight);
-  q.bindValue(":w24k", data.weight24k);
-  q.bindValue(":price", data.price);
-  q.bindValue(":amt", data.amount);
-  q.bindValue(":id", data.id);
+  q.prepare(sql);
+  RowMapper::bind(q, data, RowMapper::columnsOf<StockData>());
+  q.bindValue(n, data.id);
 
   if (!q.exec()) {
     qCritical() << "updateStock failed:" << q.lastError();
     return false;
   }
+  QueryCache::instance().bump("stocks");
   return true;
 }
 
-QList<StockData> DatabaseUtils::getAllStocks() {
+QList<StockData> DatabaseUtils::getAllStocks(const Dates::Range &range) {
   QList<StockData> list;
   QSqlDatabase db = DatabaseManager::instance().database();
   if (!db.isOpen() && !db.open())
     return list;
 
+  const QString sql =
+      QString("SELECT id, %1 FROM stocks WHERE 1%2 ORDER BY %3")
+          .arg(RowMapper::columnList(RowMapper::columnsOf<StockData>()),
+               rangeClause("date", range),
+               QString(range.isValid() ? "date DESC, id DESC" : "id DESC"));
+
   QSqlQuery q(db);
-  q.prepare("SELECT * FROM stocks ORDER BY id DESC");
+  q.setForwardOnly(true);
+  q.prepare(sql);
+  bindRange(q, range);
   if (q.exec()) {
     while (q.next()) {
       StockData s;
-      s.id = q.value("id").toInt();
-      s.date = q.value("date").toString();
-      s.metal = q.value("metal").toString();
-      s.detail = q.value("detail").toString();
-      s.note = q.value("note").toString();
-      s.voucherNo = q.value("voucher_no").toString();
-      s.purity = q.value("purity").toDouble();
-      s.weight = q.value("weight").toDouble();
-      s.weight24k = q.value("weight_24k").toDouble();
-      s.price = q.value("price").toDouble();
-      s.amount = q.value("amount").toDouble();
+      s.id = q.value(0).toInt();
+      RowMapper::read(q, s, RowMapper::columnsOf<StockData>(), 1);
       list.append(s);
     }
   }
@@ -2267,67 +1966,20 @@ QList<StockData> DatabaseUtils::getAllStocks() {
 
 QJsonArray DatabaseUtils::generateGoldWeights(int inputKarat,
                                               double inputWeight) {
-  // Defines from image:
-  // kt | % (factor) | %- (loss_factor)
-  // 24 | 1.0000 | 0.85
-  // 22 | 0.9346 | 0.90
-  // 20 | 0.8692 | 0.85
-  // 18 | 0.8047 | 0.85
-  // 14 | 0.6710 | 0.83
-  // 12 | 0.6346 | 0.82
-  // 10 | 0.5963 | 0.80
-  // 9  | 0.5766 | 0.80
-  // 6  | 0.5234 | 0.78
-  // 2  | 0.4766 | 0.75
-
-  struct KData {
-    int k;
-    double factor; // The '%' column / 100
-    double loss;   // The '%-' column / 100
-  };
-
-  QList<KData> table = {{24, 1.0000, 0.85}, {22, 0.9346, 0.90},
-                        {20, 0.8692, 0.85}, {18, 0.8047, 0.85},
-                        {14, 0.6710, 0.83}, {12, 0.6346, 0.82},
-                        {10, 0.5963, 0.80}, {9, 0.5766, 0.80},
-                        {6, 0.5234, 0.78},  {2, 0.4766, 0.75}};
-
-  // Calculate Base 24k Weight
-  double base24k = 0.0;
-
-  // Find input factor
-  double inputFactor = 0.0;
-  for (const auto &d : table) {
-    if (d.k == inputKarat) {
-      inputFactor = d.factor;
-      break;
-    }
-  }
-
-  if (inputFactor == 0.0) {
-    inputFactor = (double)inputKarat / 24.0;
-  }
-
-  base24k = inputWeight / inputFactor;
+  // The weight at every karat of the chart (Karat::kGrades), through the
+  // final purity factors, and what is left after the making loss
+  double weights[Karat::kGradeCount];
+  Karat::toGrades(inputKarat, inputWeight, weights);
 
   QJsonArray result;
-  for (const auto &d : table) {
+  for (int g = 0; g < Karat::kGradeCount; ++g) {
+    const Karat::Grade &d = Karat::kGrades[g];
     QJsonObject row;
-    row["kt"] = d.k;
+    row["kt"] = d.karat;
     row["percent"] = d.factor * 100.0;
-
-    // Calculate 'wt'
-    // Wt = Base24k * factor
-    double wt = base24k * d.factor;
-    row["wt"] = QString::number(wt, 'f', 3);
-
+    row["wt"] = QString::number(weights[g], 'f', 3);
     row["percent_minus"] = d.loss * 100.0;
-
-    // Calculate 'final wt'
-    // Final = Wt * loss
-    double finalWt = wt * d.loss;
-    row["final_wt"] = QString::number(finalWt, 'f', 3);
-
+    row["final_wt"] = QString::number(weights[g] * d.loss, 'f', 3);
     result.append(row);
   }
   return result;
@@ -2341,45 +1993,26 @@ bool DatabaseUtils::addMetalPurchase(const MetalPurchaseData &data) {
   }
   QSqlQuery q(db);
 
-  q.prepare(R"(
-        INSERT INTO metal_purchase_entry (
-            entry_date, bill_no, party_name, pic,
-            product_name, weight, purity,
-            labour_amount, total_gold,
-            pay_weight, total_pay_amount, costing_per_gm,
-            remark
-        ) VALUES (
-            :date, :bill, :party, :pic,
-            :product, :weight, :purity,
-            :labour, :total_gold,
-            :pay_wt, :total_pay, :costing,
-            :remark
-        )
-    )");
+  static const QString sql =
+      QString("INSERT INTO metal_purchase_entry (%1) VALUES (%2)")
+          .arg(RowMapper::columnList(RowMapper::columnsOf<MetalPurchaseData>()),
+               RowMapper::placeholders(
+                   RowMapper::columnsOf<MetalPurchaseData>()));
 
-  q.bindValue(":date", data.entryDate);
-  q.bindValue(":bill", data.billNo);
-  q.bindValue(":party", data.partyName);
-  q.bindValue(":pic", data.pic);
-  q.bindValue(":product", data.productName);
-  q.bindValue(":weight", data.weight);
-  q.bindValue(":purity", data.purity);
-  q.bindValue(":labour", data.labourAmount);
-  q.bindValue(":total_gold", data.totalGold);
-  q.bindValue(":pay_wt", data.payWeight);
-  q.bindValue(":total_pay", data.totalPayAmount);
-  q.bindValue(":costing", data.costingPerGm);
-  q.bindValue(":remark", data.remark);
+  q.prepare(sql);
+  RowMapper::bind(q, data, RowMapper::columnsOf<MetalPurchaseData>());
 
   if (!q.exec()) {
     qCritical() << "addMetalPurchase failed:" << q.lastError();
     return false;
   }
 
+  QueryCache::instance().bump("metal_purchase_entry");
   return true;
 }
 
-QList<MetalPurchaseData> DatabaseUtils::getAllMetalPurchases() {
+QList<MetalPurchaseData>
+DatabaseUtils::getAllMetalPurchases(const Dates::Range &range) {
   QList<MetalPurchaseData> list;
   QSqlDatabase db = DatabaseManager::instance().database();
   if (!db.isOpen() && !db.open()) {
@@ -2387,17 +2020,17 @@ QList<MetalPurchaseData> DatabaseUtils::getAllMetalPurchases() {
     return list;
   }
   QSqlQuery q(db);
+  q.setForwardOnly(true);
 
-  q.prepare(R"(
-        SELECT
-            id, entry_date, bill_no, party_name, pic,
-            product_name, weight, purity,
-            labour_amount, total_gold,
-            pay_weight, total_pay_amount, costing_per_gm,
-            remark
-        FROM metal_purchase_entry
-        ORDER BY id DESC
-    )");
+  const QString sql =
+      QString("SELECT id, %1 FROM metal_purchase_entry WHERE 1%2 ORDER BY %3")
+          .arg(RowMapper::columnList(RowMapper::columnsOf<MetalPurchaseData>()),
+               rangeClause("entry_date", range),
+               QString(range.isValid() ? "entry_date DESC, id DESC"
+                                       : "id DESC"));
+
+  q.prepare(sql);
+  bindRange(q, range);
 
   if (!q.exec()) {
     qCritical() << "getAllMetalPurchases failed:" << q.lastError();
@@ -2406,110 +2039,95 @@ QList<MetalPurchaseData> DatabaseUtils::getAllMetalPurchases() {
 
   while (q.next()) {
     MetalPurchaseData d;
-    d.id = q.value("id").toInt();
-    d.entryDate = q.value("entry_date").toString();
-    d.billNo = q.value("bill_no").toString();
-    d.partyName = q.value("party_name").toString();
-    d.pic = q.value("pic").toInt();
-    d.productName = q.value("product_name").toString();
-    d.weight = q.value("weight").toDouble();
-    d.purity = q.value("purity").toDouble();
-    d.labourAmount = q.value("labour_amount").toDouble();
-    d.totalGold = q.value("total_gold").toDouble();
-    d.payWeight = q.value("pay_weight").toDouble();
-    d.totalPayAmount = q.value("total_pay_amount").toDouble();
-    d.costingPerGm = q.value("costing_per_gm").toDouble();
-    d.remark = q.value("remark").toString();
-
+    d.id = q.value(0).toInt();
+    RowMapper::read(q, d, RowMapper::columnsOf<MetalPurchaseData>(), 1);
     list.append(d);
   }
 
   return list;
 }
 
-bool DatabaseUtils::updateOfficeGoldReceive(int jobId, double weight) {
+namespace {
+// Uncached; see DatabaseUtils::getLedgerFormulas()
+bool loadLedgerFormulas(const QString &ledger, QMap<QString, QString> &map) {
   QSqlDatabase db = DatabaseManager::instance().database();
-  if (!db.isOpen() && !db.open())
+  if (!db.isOpen() && !db.open()) {
+    qCritical() << "Database not open in getLedgerFormulas";
     return false;
-
+  }
   QSqlQuery q(db);
-  // Using jobsheet_detail table, office_gold_receive column
-  // job_no matches jobId converted to string
-  QString jobNo = QString::number(jobId);
-
-  // First try update
-  q.prepare(
-      "UPDATE jobsheet_detail SET office_gold_receive = ? WHERE job_no = ?");
-  q.addBindValue(QString::number(weight, 'f', 3));
-  q.addBindValue(jobNo);
+  q.setForwardOnly(true);
+  q.prepare("SELECT name, expression FROM ledger_formulas WHERE ledger = ?");
+  q.addBindValue(ledger);
 
-  if (!q.exec() || q.numRowsAffected() == 0) {
-    // If update fails (no row), insert
-    q.prepare("INSERT INTO jobsheet_detail (job_no, office_gold_receive) "
-              "VALUES (?, ?)");
-    q.addBindValue(jobNo);
-    q.addBindValue(QString::number(weight, 'f', 3));
-    if (!q.exec()) {
-      qCritical() << "Failed to update/insert office_gold_receive:"
-                  << q.lastError();
-      return false;
-    }
+  if (!q.exec()) {
+    qCritical() << "getLedgerFormulas failed:" << q.lastError();
+    return false;
   }
+
+  while (q.next())
+    map.insert(q.value(0).toString(), q.value(1).toString());
   return true;
 }
+} // namespace
+
+QMap<QString, QString> DatabaseUtils::getLedgerFormulas(const QString &ledger) {
+  return QueryCache::instance().get<QMap<QString, QString>>(
+      "getLedgerFormulas:" + ledger, {"ledger_formulas"},
+      [&ledger](QMap<QString, QString> &map) {
+        return loadLedgerFormulas(ledger, map);
+      });
+}
 
-bool DatabaseUtils::updateManufacturerMfgReceive(int jobId, double weight) {
+bool DatabaseUtils::setLedgerFormula(const QString &ledger, const QString &name,
+                                     const QString &expression) {
   QSqlDatabase db = DatabaseManager::instance().database();
-  if (!db.isOpen() && !db.open())
+  if (!db.isOpen() && !db.open()) {
+    qCritical() << "Database not open in setLedgerFormula";
     return false;
-
+  }
   QSqlQuery q(db);
-  QString jobNo = QString::number(jobId);
 
-  q.prepare("UPDATE jobsheet_detail SET manufacturer_mfg_receive = ? WHERE "
-            "job_no = ?");
-  q.addBindValue(QString::number(weight, 'f', 3));
-  q.addBindValue(jobNo);
+  if (expression.isEmpty()) {
+    q.prepare("DELETE FROM ledger_formulas WHERE ledger = ? AND name = ?");
+    q.addBindValue(ledger);
+    q.addBindValue(name);
+  } else {
+    q.prepare(R"(
+        INSERT INTO ledger_formulas (ledger, name, expression)
+        VALUES (?, ?, ?)
+        ON CONFLICT(ledger, name) DO UPDATE SET expression = excluded.expression
+    )");
+    q.addBindValue(ledger);
+    q.addBindValue(name);
+    q.addBindValue(expression);
+  }
 
-  if (!q.exec() || q.numRowsAffected() == 0) {
-    q.prepare("INSERT INTO jobsheet_detail (job_no, manufacturer_mfg_receive) "
-              "VALUES (?, ?)");
-    q.addBindValue(jobNo);
-    q.addBindValue(QString::number(weight, 'f', 3));
-    if (!q.exec()) {
-      qCritical() << "Failed to update/insert manufacturer_mfg_receive:"
-                  << q.lastError();
-      return false;
-    }
+  if (!q.exec()) {
+    qCritical() << "setLedgerFormula failed:" << q.lastError();
+    return false;
   }
+
+  QueryCache::instance().bump("ledger_formulas");
   return true;
 }
 
-bool DatabaseUtils::updateOfficeReceive(int jobId, double weight) {
-  QSqlDatabase db = DatabaseManager::instance().database();
-  if (!db.isOpen() && !db.open())
-    return false;
-
-  QSqlQuery q(db);
-  QString jobNo = QString::number(jobId);
+bool DatabaseUtils::updateOfficeGoldReceive(int jobId, double weight) {
+  // jobsheet_detail is keyed by the job number as text
+  return upsertJobSheetWeight(QString::number(jobId), "office_gold_receive",
+                              weight);
+}
 
-  // First try update
-  q.prepare("UPDATE jobsheet_detail SET office_receive = ? WHERE job_no = ?");
-  q.addBindValue(QString::number(weight, 'f', 3));
-  q.addBindValue(jobNo);
+bool DatabaseUtils::updateManufacturerMfgReceive(int jobId, double weight) {
+  // jobsheet_detail is keyed by the job number as text
+  return upsertJobSheetWeight(QString::number(jobId),
+                              "manufacturer_mfg_receive", weight);
+}
 
-  if (!q.exec() || q.numRowsAffected() == 0) {
-    // If update fails (no row), insert
-    q.prepare(
-        "INSERT INTO jobsheet_detail (job_no, office_receive) VALUES (?, ?)");
-    q.addBindValue(jobNo);
-    q.addBindValue(QString::number(weight, 'f', 3));
-    if (!q.exec()) {
-      qCritical() << "Failed to update/insert office_receive:" << q.lastError();
-      return false;
-    }
-  }
-  return true;
+bool DatabaseUtils::updateOfficeReceive(int jobId, double weight) {
+  // jobsheet_detail is keyed by the job number as text
+  return upsertJobSheetWeight(QString::number(jobId), "office_receive",
+                              weight);
 }
 
 QList<QVariantList> DatabaseUtils::fetchCatalogData() {
@@ -2558,7 +2176,7 @@ bool DatabaseUtils::deleteDesign(QString &designNo) {
   }
   QSqlDatabase db = DatabaseManager::instance().database();
 
-  if (!db.open()) {
+  if (!db.isOpen() && !db.open()) {
     // qDebug() << "[ERROR] Could not open database." ;
     return 1;
   }
@@ -2568,6 +2186,7 @@ bool DatabaseUtils::deleteDesign(QString &designNo) {
         R"(UPDATE image_data SET "delete" = 1 WHERE design_no = :design_no)");
     query.bindValue(":design_no", designNo);
     query.exec();
+    QueryCache::instance().bump("image_data");
     return 0;
   } catch (QSqlError *e) {
     qDebug() << e->text();
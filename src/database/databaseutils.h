@@ -9,10 +9,15 @@
 #include <QTableWidget>
 #include <QVariant>
 
+#include <functional>
+#include <limits>
+
+#include "common/dates.h"
 #include "models/CastingData.h"
 #include "models/CastingListRow.h" // Assuming CastingListRow struct is modified in its own header
 #include "models/JobSheetData.h"
 #include "models/OrderData.h"
+#include "models/OrderListRow.h"
 
 #include <xlsxdocument.h>
 #include <xlsxworksheet.h>
@@ -27,6 +32,7 @@ struct JobListData {
   int pcs;
   QString metal;
   QString purity;
+  double fineness; // purity in parts per thousand, parsed when written
 
   // Casting Info (Issue)
   QString status;
@@ -69,6 +75,17 @@ struct JobListData {
   int dbJobId;
 };
 
+// A job's net weight and losses from the job_totals table, for sorting and
+// filtering by them in SQL (see getJobsByTotal())
+struct JobTotalsRow {
+  int jobId = 0;
+  QString designNo;
+  QString deliveryDate;
+  double netWt = 0;
+  double grossLoss = 0;
+  double lossPct = 0;
+};
+
 // ... existing code ...
 
 struct DesignerOrderData {
@@ -124,15 +141,32 @@ struct MetalPurchaseData {
 
 class DatabaseUtils {
 public:
+  // Outcome of a compare-and-swap update on a row_version column
+  enum class CasResult {
+    Saved,
+    Conflict, // someone else saved the row after it was read; nothing written
+    Failed
+  };
+
   static bool createOrder(const OrderData &o, int &outJobId, int &outSellerSeq);
-  static QList<OrderData> getOrdersForSeller(int sellerId);
+  // With a valid `due`, only orders whose delivery date falls in it,
+  // soonest first (an index range scan)
+  static QList<OrderListRow>
+  getOrdersForSeller(int sellerId, const Dates::Range &due = {});
 
-  static QList<OrderData> getAllOrders();
+  static QList<OrderListRow> getAllOrders(const Dates::Range &due = {});
 
   static bool getOrderById(int orderId, OrderData &o);
 
   static bool updateOrder(int orderId, const OrderData &o);
 
+  // Write only the columns that differ between `before` (the row as the
+  // form loaded it) and `after`. No statement when nothing changed.
+  // Conflict if the row is no longer at before.rowVersion; on success
+  // after.rowVersion is the row's new version.
+  static CasResult updateOrderChanges(int orderId, const OrderData &before,
+                                      OrderData &after);
+
   static QList<CastingListRow> getCastingList();
 
   static int getCastingIdByJob(int jobId);
@@ -141,6 +175,11 @@ public:
 
   static bool updateCasting(int castingId, const CastingData &c);
 
+  // As updateOrderChanges(), for casting_entry
+  static CasResult updateCastingChanges(int castingId,
+                                        const CastingData &before,
+                                        CastingData &after);
+
   static bool getCastingDataByJob(int jobId, CastingData &c);
 
   static bool updateCastingDiaPrice(int jobId, double price);
@@ -151,12 +190,30 @@ public:
   fetchDiamondAndStoneJson(const QString &designNo);
 
   // New declarations
+  // rowVersion (optional) receives the row's version alongside the history
   static QJsonArray fetchJobSheetHistory(const QString &jobNo,
-                                         const QString &colName);
+                                         const QString &colName,
+                                         int *rowVersion = nullptr);
+  // Appends on top of whatever is stored now, retrying if another user
+  // appends at the same moment. rowVersion (optional) passes in the
+  // version read with the history on screen (-1 if none) and receives the
+  // new one. The first write is a compare-and-swap on the version passed
+  // in; *conflict is set when it found the row changed since, and the
+  // entry then went on top of the newer history.
   static bool addJobSheetHistoryEntry(const QString &jobNo,
                                       const QString &colName,
-                                      const QJsonObject &entry);
+                                      const QJsonObject &entry,
+                                      int *rowVersion = nullptr,
+                                      bool *conflict = nullptr);
   static QList<JobListData> getJobsList();
+  // At most `limit` jobs by "net_wt", "gross_loss" or "loss_pct", highest
+  // first, those of at least `minimum` only; with a valid `due`, only jobs
+  // due in it. An index scan over job_totals, so computed with the default
+  // ledger formulas rather than the shop's overrides: check
+  // LedgerFormulas::isDefault() first (the jobs list's loss filter does).
+  static QList<JobTotalsRow>
+  getJobsByTotal(const QString &column, int limit, const Dates::Range &due = {},
+                 double minimum = std::numeric_limits<double>::lowest());
   static QStringList fetchShapes(const QString &tableType);
   static QStringList fetchSizes(const QString &tableType, const QString &shape);
 
@@ -176,7 +233,9 @@ public:
                     const QJsonArray &goldArray, const QJsonArray &diamondArray,
                     const QJsonArray &stoneArray, const QString &note);
 
-  static QString saveImage(const QString &imagePath);
+  // Ingests (orients, downsizes, re-encodes) into images/ with a thumbnail
+  static QString saveImage(const QString &imagePath,
+                           const std::function<void(int)> &progress = {});
 
   static bool excelBulkInsertCatalog(const QString &filePath);
 
@@ -184,6 +243,13 @@ public:
 
   static bool deleteDesign(QString &designNo);
 
+  // jobsheet_detail columns holding one weight as text; each has an exact
+  // <column>_mg INTEGER copy, written with it
+  static constexpr const char *kJobSheetWeightColumns[] = {
+      "office_gold_receive", "office_receive",     "manufacturer_mfg_receive",
+      "buffing_return",      "free_polish_return", "setting_return",
+      "final_polish_return"};
+
   static bool saveGoldStageReturn(const QString &jobNo, const QString &column,
                                   double value);
 
@@ -199,10 +265,17 @@ public:
 
   static bool addStock(const StockData &data);
   static bool updateStock(const StockData &data);
-  static QList<StockData> getAllStocks();
+  static QList<StockData> getAllStocks(const Dates::Range &range = {});
 
   static bool addMetalPurchase(const MetalPurchaseData &data);
-  static QList<MetalPurchaseData> getAllMetalPurchases();
+  static QList<MetalPurchaseData>
+  getAllMetalPurchases(const Dates::Range &range = {});
+
+  // Shop overrides of the ledger formulas, name -> expression; use
+  // LedgerFormulas, which checks them. An empty expression deletes.
+  static QMap<QString, QString> getLedgerFormulas(const QString &ledger);
+  static bool setLedgerFormula(const QString &ledger, const QString &name,
+                               const QString &expression);
 
   // static bool deleteDesign(QString &designNo) ;
 
@@ -0,0 +1,181 @@
+#include "jobsheetcache.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QMutexLocker>
+#include <QTableWidget>
+#include <QThreadPool>
+
+#include "common/imageservice.h"
+
+JobSheetCache &JobSheetCache::instance() {
+  static JobSheetCache cache;
+  return cache;
+}
+
+void JobSheetCache::prefetch(int jobId) {
+  if (jobId <= 0)
+    return;
+
+  quint64 generation = 0;
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_entries.contains(jobId) || m_inFlight.contains(jobId))
+      return;
+    m_inFlight.insert(jobId);
+    generation = m_generation.value(jobId);
+  }
+
+  QThreadPool::globalInstance()->start([this, jobId, generation]() {
+    auto snapshot = load(jobId);
+
+    if (snapshot) {
+      store(*snapshot, generation);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_inFlight.remove(jobId);
+  });
+}
+
+void JobSheetCache::prefetchAround(const QList<int> &jobIds) {
+  for (int jobId : jobIds)
+    prefetch(jobId);
+}
+
+void JobSheetCache::prefetchFollowing(QTableWidget *table, int jobIdColumn) {
+  auto aroundRow = [this, table, jobIdColumn](int row) {
+    QList<int> jobIds;
+    for (int r = row - 1; r <= row + 1; ++r) {
+      const QTableWidgetItem *jobItem = table->item(r, jobIdColumn);
+      if (!jobItem)
+        continue;
+      bool ok = false;
+      const int jobId = jobItem->text().toInt(&ok);
+      if (ok)
+        jobIds << jobId;
+    }
+    // Current row first so it is queued ahead of its neighbours
+    if (jobIds.size() == 3)
+      jobIds.swapItemsAt(0, 1);
+    prefetchAround(jobIds);
+  };
+
+  table->setMouseTracking(true);
+  QObject::connect(table, &QTableWidget::cellEntered, table, aroundRow);
+  QObject::connect(table, &QTableWidget::currentCellChanged, table,
+                   aroundRow);
+}
+
+std::optional<JobSheetSnapshot> JobSheetCache::take(int jobId) {
+  quint64 generation = 0;
+  {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(jobId);
+    if (it != m_entries.constEnd()) {
+      JobSheetSnapshot hit = it.value();
+      touch(jobId);
+      return hit;
+    }
+    generation = m_generation.value(jobId);
+  }
+
+  // Miss (or prefetch still running): load on the caller's thread
+  auto snapshot = load(jobId);
+  if (snapshot)
+    store(*snapshot, generation);
+  return snapshot;
+}
+
+void JobSheetCache::invalidate(int jobId) {
+  QMutexLocker locker(&m_mutex);
+  m_entries.remove(jobId);
+  m_lru.removeAll(jobId);
+  // Any load already in flight for this job started before the write and
+  // must not be stored
+  ++m_generation[jobId];
+}
+
+void JobSheetCache::invalidate(const QString &jobNo) {
+  bool ok = false;
+  int jobId = jobNo.trimmed().toInt(&ok);
+  if (ok)
+    invalidate(jobId);
+}
+
+void JobSheetCache::clear() {
+  QMutexLocker locker(&m_mutex);
+  for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+    ++m_generation[it.key()];
+  for (int jobId : std::as_const(m_inFlight))
+    ++m_generation[jobId];
+  m_entries.clear();
+  m_lru.clear();
+}
+
+void JobSheetCache::setCapacity(int capacity) {
+  QMutexLocker locker(&m_mutex);
+  m_capacity = qMax(1, capacity);
+  evict();
+}
+
+int JobSheetCache::capacity() const {
+  QMutexLocker locker(&m_mutex);
+  return m_capacity;
+}
+
+// ---------- private ----------
+
+std::optional<JobSheetSnapshot> JobSheetCache::load(int jobId) {
+  // DatabaseManager hands worker threads their own connection, so the same
+  // DatabaseUtils calls the widget used to make are safe here.
+  auto dataOpt = DatabaseUtils::fetchJobSheetData(jobId);
+  if (!dataOpt)
+    return std::nullopt;
+
+  JobSheetSnapshot s;
+  s.jobId = jobId;
+  s.data = *dataOpt;
+
+  auto [diamondJson, stoneJson] =
+      DatabaseUtils::fetchDiamondAndStoneJson(s.data.designNo);
+  s.diamondJson = diamondJson;
+  s.stoneJson = stoneJson;
+
+  const QString jobNo = QString::number(jobId);
+  s.diamondTotals = DatabaseUtils::fetchDiamondTotals(jobNo);
+  s.goldTotals = DatabaseUtils::fetchGoldTotals(jobNo);
+
+  // Warm the shared image cache; the widget shrinks from this decode
+  // instead of going back to disk
+  if (!s.data.imagePath.isEmpty()) {
+    QString fullPath = QDir::cleanPath(QCoreApplication::applicationDirPath() +
+                                       "/" + s.data.imagePath);
+    ImageService::instance().image(fullPath, QSize(kImageEdge, kImageEdge));
+  }
+
+  return s;
+}
+
+void JobSheetCache::store(const JobSheetSnapshot &snapshot,
+                          quint64 generation) {
+  QMutexLocker locker(&m_mutex);
+  if (m_generation.value(snapshot.jobId) != generation)
+    return; // invalidated while loading
+
+  m_entries.insert(snapshot.jobId, snapshot);
+  touch(snapshot.jobId);
+  evict();
+}
+
+void JobSheetCache::touch(int jobId) {
+  m_lru.removeOne(jobId);
+  m_lru.prepend(jobId);
+}
+
+void JobSheetCache::evict() {
+  while (m_lru.size() > m_capacity) {
+    int oldest = m_lru.takeLast();
+    m_entries.remove(oldest);
+  }
+}
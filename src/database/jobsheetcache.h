@@ -0,0 +1,77 @@
+#ifndef JOBSHEETCACHE_H
+#define JOBSHEETCACHE_H
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QSet>
+#include <QString>
+
+#include "database/databaseutils.h"
+#include "models/JobSheetData.h"
+
+class QTableWidget;
+
+// Everything JobSheetWidget::set_value() needs for one job, loaded off the
+// GUI thread so that opening a job sheet does not block on the database or
+// on image decode.
+struct JobSheetSnapshot {
+  int jobId = 0;
+  JobSheetData data;
+  QString diamondJson;
+  QString stoneJson;
+  QMap<QString, QPair<int, double>> diamondTotals;
+  GoldTotals goldTotals;
+};
+
+// Bounded LRU of job sheet snapshots with background prefetch.
+// List widgets call prefetch() for the row under the cursor and its
+// neighbours; JobSheetWidget calls take() when it opens. Any write to a
+// job's history must call invalidate() so a stale sheet is never shown.
+class JobSheetCache {
+public:
+  static JobSheetCache &instance();
+
+  // Longest edge the product image is pre-decoded at (into ImageService)
+  static constexpr int kImageEdge = 1024;
+
+  // Queue a background load unless the job is already cached or in flight
+  void prefetch(int jobId);
+  void prefetchAround(const QList<int> &jobIds);
+
+  // Prefetch the row under the mouse or cursor of a list and its
+  // neighbours; jobIdColumn holds the job number as text
+  void prefetchFollowing(QTableWidget *table, int jobIdColumn);
+
+  // Cached snapshot if present, otherwise loaded synchronously and cached
+  std::optional<JobSheetSnapshot> take(int jobId);
+
+  void invalidate(int jobId);
+  void invalidate(const QString &jobNo);
+  void clear();
+
+  void setCapacity(int capacity);
+  int capacity() const;
+
+private:
+  JobSheetCache() = default;
+  JobSheetCache(const JobSheetCache &) = delete;
+  JobSheetCache &operator=(const JobSheetCache &) = delete;
+
+  static std::optional<JobSheetSnapshot> load(int jobId);
+
+  void store(const JobSheetSnapshot &snapshot, quint64 generation);
+  void touch(int jobId);
+  void evict();
+
+  mutable QMutex m_mutex;
+  QHash<int, JobSheetSnapshot> m_entries;
+  QList<int> m_lru; // most recently used at the front
+  QSet<int> m_inFlight;
+  QHash<int, quint64> m_generation; // bumped by invalidate()
+  int m_capacity = 32;
+};
+
+#endif // JOBSHEETCACHE_H
@@ -0,0 +1,113 @@
+#include "querycache.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "databasemanager.h"
+#include "writetransaction.h"
+
+QueryCache &QueryCache::instance() {
+  static QueryCache cache;
+  return cache;
+}
+
+QueryCache::QueryCache()
+    : m_enabled(qEnvironmentVariable("LUXEMINE_QUERY_CACHE") != "0") {}
+
+void QueryCache::bump(const QString &table) {
+  // Counted once the write commits: before that, another connection
+  // still reads the old rows and would cache them as the new version
+  WriteTransaction::afterCommit([this, table]() {
+    QMutexLocker locker(&m_mutex);
+    ++m_versions[table];
+  });
+}
+
+void QueryCache::bumpAll() {
+  QMutexLocker locker(&m_mutex);
+  ++m_epoch;
+  m_entries.clear();
+}
+
+bool QueryCache::lookup(const QString &key, std::any &out) {
+  if (!m_enabled)
+    return false;
+
+  checkExternalWrites();
+
+  QMutexLocker locker(&m_mutex);
+  auto it = m_entries.constFind(key);
+  if (it == m_entries.constEnd() || it->epoch != m_epoch) {
+    ++m_misses;
+    return false;
+  }
+  for (auto v = it->versions.cbegin(); v != it->versions.cend(); ++v) {
+    if (m_versions.value(v.key()) != v.value()) {
+      m_entries.erase(it);
+      ++m_misses;
+      return false;
+    }
+  }
+
+  out = it->value;
+  ++m_hits;
+  return true;
+}
+
+QueryCache::Entry QueryCache::snapshot(const QStringList &tables) const {
+  QMutexLocker locker(&m_mutex);
+  Entry entry;
+  entry.epoch = m_epoch;
+  for (const QString &table : tables)
+    entry.versions.insert(table, m_versions.value(table));
+  return entry;
+}
+
+void QueryCache::store(const QString &key, Entry entry) {
+  QMutexLocker locker(&m_mutex);
+  if (entry.epoch != m_epoch)
+    return; // everything was dropped while the query ran
+  m_entries.insert(key, std::move(entry));
+}
+
+void QueryCache::checkExternalWrites() {
+  // data_version changes when any *other* connection commits: another
+  // workstation, or one of our worker-thread connections. Which tables it
+  // wrote is unknown, so everything goes. It reads no table pages.
+  QSqlDatabase db = DatabaseManager::instance().database();
+  if (!db.isOpen())
+    return;
+
+  QSqlQuery q(db);
+  if (!q.exec("PRAGMA data_version") || !q.next())
+    return;
+  const qint64 version = q.value(0).toLongLong();
+
+  bool changed = false;
+  {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_dataVersions.find(db.connectionName());
+    if (it == m_dataVersions.end()) {
+      // First look from this connection (a new worker clone): nothing to
+      // compare with yet, so this is its baseline, not a change
+      m_dataVersions.insert(db.connectionName(), version);
+    } else if (it.value() != version) {
+      it.value() = version;
+      changed = true;
+    }
+  }
+  if (changed)
+    bumpAll();
+}
+
+void QueryCache::logStats() const {
+  QMutexLocker locker(&m_mutex);
+  qInfo().noquote() << QString("[perf] Query cache: %1 hits, %2 misses, %3 "
+                               "entries%4")
+                           .arg(m_hits)
+                           .arg(m_misses)
+                           .arg(m_entries.size())
+                           .arg(m_enabled ? "" : " (disabled)");
+}
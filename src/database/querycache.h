@@ -0,0 +1,83 @@
+#ifndef QUERYCACHE_H
+#define QUERYCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+#include <any>
+
+// Results of the heavy read-only list queries (casting list, designer
+// orders, jobs list, users with payments, shape/size lists), kept until
+// one of the tables they read is written.
+//
+// Every table has a version counter. Writes call bump() for the tables they
+// touch (ChangeNotifier::notify does it for its table); an entry remembers
+// the versions it was built from and is reused only while they all still
+// match. Writes from other workstations are caught through SQLite's
+// PRAGMA data_version, which drops every entry.
+//
+// LUXEMINE_QUERY_CACHE=0 turns the cache off, for comparing timings.
+class QueryCache {
+public:
+  static QueryCache &instance();
+
+  // Cached result for `key` while none of `tables` changed; otherwise runs
+  // load(T &) and caches what it returns, unless it reports failure
+  template <typename T, typename Load>
+  T get(const QString &key, const QStringList &tables, Load &&load);
+
+  // After a write to `table`; inside a WriteTransaction, on commit
+  void bump(const QString &table);
+  // After a rollback, a migration, or a write from elsewhere
+  void bumpAll();
+
+  // "[perf] Query cache: ..." line with hit / miss counts
+  void logStats() const;
+
+private:
+  QueryCache();
+  QueryCache(const QueryCache &) = delete;
+  QueryCache &operator=(const QueryCache &) = delete;
+
+  struct Entry {
+    quint64 epoch = 0;
+    QHash<QString, quint64> versions;
+    std::any value;
+  };
+
+  bool lookup(const QString &key, std::any &out);
+  Entry snapshot(const QStringList &tables) const;
+  void store(const QString &key, Entry entry);
+  void checkExternalWrites();
+
+  const bool m_enabled;
+  mutable QMutex m_mutex;
+  QHash<QString, Entry> m_entries;
+  QHash<QString, quint64> m_versions; // per table, bumped by bump()
+  quint64 m_epoch = 0;                // bumped by bumpAll()
+  QHash<QString, qint64> m_dataVersions; // per connection name
+  quint64 m_hits = 0;
+  quint64 m_misses = 0;
+};
+
+template <typename T, typename Load>
+T QueryCache::get(const QString &key, const QStringList &tables, Load &&load) {
+  std::any hit;
+  if (lookup(key, hit))
+    return std::any_cast<const T &>(hit);
+
+  // Versions are taken before the query runs, so a write that lands while
+  // it runs leaves the new entry already stale
+  Entry entry = snapshot(tables);
+
+  T result;
+  if (load(result) && m_enabled) {
+    entry.value = result;
+    store(key, std::move(entry));
+  }
+  return result;
+}
+
+#endif // QUERYCACHE_H
@@ -0,0 +1,181 @@
+#ifndef ROWMAPPER_H
+#define ROWMAPPER_H
+
+#include <QList>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+// Compile-time column descriptors for the plain row structs.
+//
+// A descriptor pairs an SQL column name with a member pointer, and a table
+// is a constexpr tuple of descriptors (see rowmappings.h). The column list,
+// the "?" placeholders, the "col = ?" assignments, the positional binds and
+// the per-row reads are all generated from that one list, so they cannot
+// drift apart. Values are read by index, never by name. diff() and the
+// ColumnMask overloads build partial UPDATEs that write changed columns only.
+namespace RowMapper {
+
+template <typename S, typename M> struct Column {
+  const char *name;
+  M S::*member;
+  QVariant (*encode)(const M &) = nullptr; // set for derived() columns
+};
+
+template <typename S, typename M>
+constexpr Column<S, M> column(const char *name, M S::*member) {
+  return {name, member, nullptr};
+}
+
+// A column written from another member through `encode`, e.g. a numeric
+// copy of a text column kept for queries. It is bound on writes, flagged by
+// diff() with its member, and skipped by read().
+template <typename S, typename M>
+constexpr Column<S, M> derived(const char *name, M S::*member,
+                               QVariant (*encode)(const M &)) {
+  return {name, member, encode};
+}
+
+template <typename... Cols> constexpr auto columns(Cols... cols) {
+  return std::make_tuple(cols...);
+}
+
+// Specialised per struct in rowmappings.h:
+//   template <> struct Table<X> { static constexpr auto columns = ...; };
+template <typename S> struct Table;
+
+template <typename S> constexpr const auto &columnsOf() {
+  return Table<S>::columns;
+}
+
+template <typename Cols> constexpr int count(const Cols &) {
+  return static_cast<int>(std::tuple_size_v<Cols>);
+}
+
+// One bit per column, bit i = i-th descriptor; the widest table has 55
+using ColumnMask = quint64;
+
+namespace detail {
+inline void assign(const QVariant &v, int &out) { out = v.toInt(); }
+inline void assign(const QVariant &v, double &out) { out = v.toDouble(); }
+inline void assign(const QVariant &v, bool &out) { out = v.toBool(); }
+inline void assign(const QVariant &v, QString &out) { out = v.toString(); }
+
+template <typename S, typename C>
+QVariant valueOf(const S &row, const C &c) {
+  return c.encode ? c.encode(row.*(c.member))
+                  : QVariant::fromValue(row.*(c.member));
+}
+
+template <typename Cols, typename Fn> void forEach(const Cols &cols, Fn &&fn) {
+  std::apply(
+      [&](const auto &...c) {
+        int i = 0;
+        (fn(i++, c), ...);
+      },
+      cols);
+}
+} // namespace detail
+
+// ---------- SQL fragments ----------
+
+// "a, b, c", each name optionally prefixed with a table alias ("od.")
+template <typename Cols>
+QString columnList(const Cols &cols, const QString &prefix = QString()) {
+  QStringList parts;
+  parts.reserve(count(cols));
+  detail::forEach(cols, [&](int, const auto &c) {
+    parts << prefix + QLatin1String(c.name);
+  });
+  return parts.join(", ");
+}
+
+// "?, ?, ?"
+template <typename Cols> QString placeholders(const Cols &cols) {
+  return QStringList(count(cols), QStringLiteral("?")).join(", ");
+}
+
+// "a = ?, b = ?"
+template <typename Cols> QString assignments(const Cols &cols) {
+  QStringList parts;
+  parts.reserve(count(cols));
+  detail::forEach(cols, [&](int, const auto &c) {
+    parts << QLatin1String(c.name) + QStringLiteral(" = ?");
+  });
+  return parts.join(", ");
+}
+
+// "b = ?, d = ?" for the masked columns only
+template <typename Cols>
+QString assignments(const Cols &cols, ColumnMask mask) {
+  static_assert(std::tuple_size_v<Cols> <= 64, "ColumnMask is 64 bits");
+  QStringList parts;
+  detail::forEach(cols, [&](int i, const auto &c) {
+    if (mask & (ColumnMask(1) << i))
+      parts << QLatin1String(c.name) + QStringLiteral(" = ?");
+  });
+  return parts.join(", ");
+}
+
+// Column names of the masked columns, in table order
+template <typename Cols> QStringList names(const Cols &cols, ColumnMask mask) {
+  QStringList out;
+  detail::forEach(cols, [&](int i, const auto &c) {
+    if (mask & (ColumnMask(1) << i))
+      out << QLatin1String(c.name);
+  });
+  return out;
+}
+
+// ---------- Values ----------
+
+// Columns whose member differs between the two rows
+template <typename S, typename Cols>
+ColumnMask diff(const S &before, const S &after, const Cols &cols) {
+  static_assert(std::tuple_size_v<Cols> <= 64, "ColumnMask is 64 bits");
+  ColumnMask mask = 0;
+  detail::forEach(cols, [&](int i, const auto &c) {
+    if (!(before.*(c.member) == after.*(c.member)))
+      mask |= ColumnMask(1) << i;
+  });
+  return mask;
+}
+
+// Bind the members in column order, starting at placeholder `first`
+template <typename S, typename Cols>
+void bind(QSqlQuery &q, const S &row, const Cols &cols, int first = 0) {
+  detail::forEach(cols, [&](int i, const auto &c) {
+    q.bindValue(first + i, detail::valueOf(row, c));
+  });
+}
+
+// Bind only the masked members, in column order; returns the next free
+// placeholder so the caller can bind its WHERE values after them
+template <typename S, typename Cols>
+int bind(QSqlQuery &q, const S &row, const Cols &cols, ColumnMask mask,
+         int first = 0) {
+  int pos = first;
+  detail::forEach(cols, [&](int i, const auto &c) {
+    if (mask & (ColumnMask(1) << i))
+      q.bindValue(pos++, detail::valueOf(row, c));
+  });
+  return pos;
+}
+
+// Read the current record, the columns starting at result index `first`
+template <typename S, typename Cols>
+void read(const QSqlQuery &q, S &row, const Cols &cols, int first = 0) {
+  detail::forEach(cols, [&](int i, const auto &c) {
+    if (!c.encode)
+      detail::assign(q.value(first + i), row.*(c.member));
+  });
+}
+
+} // namespace RowMapper
+
+#endif // ROWMAPPER_H
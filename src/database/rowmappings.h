@@ -0,0 +1,142 @@
+#ifndef ROWMAPPINGS_H
+#define ROWMAPPINGS_H
+
+#include "common/purity.h"
+#include "databaseutils.h"
+#include "rowmapper.h"
+
+// Column descriptors, in table column order. Each list is the set of
+// columns the app writes; keys (id, job_id, order_id, ...) and literals are
+// added around it by the statements in databaseutils.cpp.
+namespace RowMapper {
+
+// order_book_detail
+template <> struct Table<OrderData> {
+  static constexpr auto columns = RowMapper::columns(
+      column("sellerName", &OrderData::sellerName),
+      column("sellerId", &OrderData::sellerId),
+      column("partyId", &OrderData::partyId),
+      column("partyName", &OrderData::partyName),
+
+      column("clientId", &OrderData::clientId),
+      column("agencyId", &OrderData::agencyId),
+      column("shopId", &OrderData::shopId),
+      column("reteillerId", &OrderData::retaillerId), // sic, schema spelling
+      column("starId", &OrderData::starId),
+
+      column("address", &OrderData::address),
+      column("city", &OrderData::city),
+      column("state", &OrderData::state),
+      column("country", &OrderData::country),
+
+      column("orderDate", &OrderData::orderDate),
+      column("deliveryDate", &OrderData::deliveryDate),
+
+      column("productName", &OrderData::productName),
+      column("productPis", &OrderData::productPis),
+      column("approxProductWt", &OrderData::approxProductWt),
+      column("approxDiamondWt", &OrderData::approxDiamondWt),
+
+      column("metalPrice", &OrderData::metalPrice),
+      column("metalName", &OrderData::metalName),
+      column("metalPurity", &OrderData::metalPurity),
+      derived("metalFineness", &OrderData::metalPurity, &Purity::finenessOf),
+      column("metalColor", &OrderData::metalColor),
+
+      column("sizeNo", &OrderData::sizeNo),
+      column("sizeMM", &OrderData::sizeMM),
+      column("length", &OrderData::length),
+      column("width", &OrderData::width),
+      column("height", &OrderData::height),
+
+      column("diaPacific", &OrderData::diaPacific),
+      column("diaPurity", &OrderData::diaPurity),
+      column("diaColor", &OrderData::diaColor),
+      column("diaPrice", &OrderData::diaPrice),
+
+      column("stPacific", &OrderData::stPacific),
+      column("stPurity", &OrderData::stPurity),
+      column("stColor", &OrderData::stColor),
+      column("stPrice", &OrderData::stPrice),
+
+      column("designNo", &OrderData::designNo),
+      column("image1Path", &OrderData::image1Path),
+      column("image2Path", &OrderData::image2Path),
+
+      column("metalCertiName", &OrderData::metalCertiName),
+      column("metalCertiType", &OrderData::metalCertiType),
+      column("diaCertiName", &OrderData::diaCertiName),
+      column("diaCertiType", &OrderData::diaCertiType),
+
+      column("pesSaki", &OrderData::pesSaki),
+      column("chainLock", &OrderData::chainLock),
+      column("polish", &OrderData::polish),
+      column("settingLebour", &OrderData::settingLebour),
+      column("metalStemp", &OrderData::metalStemp),
+
+      column("paymentMethod", &OrderData::paymentMethod),
+      column("totalAmount", &OrderData::totalAmount),
+      column("advance", &OrderData::advance),
+      column("remaining", &OrderData::remaining),
+
+      column("note", &OrderData::note),
+      column("extraDetail", &OrderData::extraDetail));
+};
+
+// casting_entry
+template <> struct Table<CastingData> {
+  static constexpr auto columns = RowMapper::columns(
+      column("casting_date", &CastingData::castingDate),
+      column("casting_name", &CastingData::castingName),
+      column("pcs", &CastingData::pcs),
+
+      column("issue_metal_name", &CastingData::issueMetalName),
+      column("issue_metal_purity", &CastingData::issueMetalPurity),
+      derived("issue_metal_fineness", &CastingData::issueMetalPurity,
+              &Purity::finenessOf),
+      column("issue_metal_wt", &CastingData::issueMetalWt),
+      column("issue_diamond_pcs", &CastingData::issueDiamondPcs),
+      column("issue_diamond_wt", &CastingData::issueDiamondWt),
+
+      column("receive_runner_wt", &CastingData::receiveRunnerWt),
+      column("receive_product_wt", &CastingData::receiveProductWt),
+      column("receive_diamond_pcs", &CastingData::receiveDiamondPcs),
+      column("receive_diamond_wt", &CastingData::receiveDiamondWt),
+
+      column("status", &CastingData::status));
+};
+
+// stocks
+template <> struct Table<StockData> {
+  static constexpr auto columns = RowMapper::columns(
+      column("date", &StockData::date), column("metal", &StockData::metal),
+      column("detail", &StockData::detail), column("note", &StockData::note),
+      column("voucher_no", &StockData::voucherNo),
+      column("purity", &StockData::purity),
+      column("weight", &StockData::weight),
+      column("weight_24k", &StockData::weight24k),
+      column("price", &StockData::price),
+      column("amount", &StockData::amount));
+};
+
+// metal_purchase_entry
+template <> struct Table<MetalPurchaseData> {
+  static constexpr auto columns = RowMapper::columns(
+      column("entry_date", &MetalPurchaseData::entryDate),
+      column("bill_no", &MetalPurchaseData::billNo),
+      column("party_name", &MetalPurchaseData::partyName),
+      column("pic", &MetalPurchaseData::pic),
+      column("product_name", &MetalPurchaseData::productName),
+      column("weight", &MetalPurchaseData::weight),
+      column("purity", &MetalPurchaseData::purity),
+      column("labour_amount", &MetalPurchaseData::labourAmount),
+      column("total_gold", &MetalPurchaseData::totalGold),
+      column("pay_weight", &MetalPurchaseData::payWeight),
+      column("total_pay_amount", &MetalPurchaseData::totalPayAmount),
+      column("costing_per_gm", &MetalPurchaseData::costingPerGm),
+      column("remark", &MetalPurchaseData::remark));
+};
+
+} // namespace RowMapper
+
+#endif // ROWMAPPINGS_H
@@ -0,0 +1,221 @@
+#include "sqlfunctions.h"
+
+#include <QDebug>
+#include <QSqlDriver>
+#include <QVariant>
+
+#ifdef LUXEMINE_SQLITE_FUNCTIONS
+
+#include <sqlite3.h>
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSet>
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+#include "common/fixedpoint.h"
+#include "common/formulaset.h"
+#include "common/ledgerformulas.h"
+#include "common/purity.h"
+
+namespace {
+// A purity argument: text is parsed, a number is read by its size
+Purity purityOf(sqlite3_value *v) {
+  switch (sqlite3_value_type(v)) {
+  case SQLITE_TEXT:
+    return Purity::parse(QString::fromUtf8(
+        reinterpret_cast<const char *>(sqlite3_value_text(v)),
+        sqlite3_value_bytes(v)));
+  case SQLITE_INTEGER:
+  case SQLITE_FLOAT:
+    return Purity::fromNumber(sqlite3_value_double(v));
+  default:
+    return Purity();
+  }
+}
+
+bool anyNull(int argc, sqlite3_value **argv) {
+  for (int i = 0; i < argc; ++i) {
+    if (sqlite3_value_type(argv[i]) == SQLITE_NULL)
+      return true;
+  }
+  return false;
+}
+
+void karatFactor(sqlite3_context *ctx, int argc, sqlite3_value **argv) {
+  if (anyNull(argc, argv))
+    return sqlite3_result_null(ctx);
+  const double kt = sqlite3_value_double(argv[0]);
+  const int whole = int(kt);
+  sqlite3_result_double(ctx, whole == kt ? Karat::factor(whole) : kt / 24.0);
+}
+
+void fineness(sqlite3_context *ctx, int, sqlite3_value **argv) {
+  const Purity p = purityOf(argv[0]);
+  if (!p.isValid())
+    return sqlite3_result_null(ctx);
+  sqlite3_result_double(ctx, p.fineness());
+}
+
+void fineWt(sqlite3_context *ctx, int argc, sqlite3_value **argv) {
+  const Purity p = purityOf(argv[1]);
+  if (anyNull(argc, argv) || !p.isValid())
+    return sqlite3_result_null(ctx);
+  sqlite3_result_double(ctx, p.toFine(sqlite3_value_double(argv[0])));
+}
+
+// The default jobs formulas, compiled once; the five arguments are their
+// issue_wt, gross_wt, receive_dia_wt, receive_stone_wt and
+// office_gold_receive inputs, the others stay 0
+struct JobLoss {
+  FormulaSet formulas{LedgerFormulas::inputs("jobs"),
+                      LedgerFormulas::defaults("jobs")};
+  int inputs[5] = {
+      formulas.slotOf("issue_wt"), formulas.slotOf("gross_wt"),
+      formulas.slotOf("receive_dia_wt"), formulas.slotOf("receive_stone_wt"),
+      formulas.slotOf("office_gold_receive")};
+  int grossLoss = formulas.slotOf("gross_loss");
+  int lossPercent = formulas.slotOf("loss_percent");
+
+  static const JobLoss &instance() {
+    static const JobLoss loss;
+    return loss;
+  }
+};
+
+void jobLoss(sqlite3_context *ctx, int argc, sqlite3_value **argv,
+             int JobLoss::*result) {
+  if (anyNull(argc, argv))
+    return sqlite3_result_null(ctx);
+  const JobLoss &loss = JobLoss::instance();
+  QVarLengthArray<double, 32> values(loss.formulas.slotCount());
+  std::fill(values.begin(), values.end(), 0.0);
+  for (int i = 0; i < argc; ++i)
+    values[loss.inputs[i]] = sqlite3_value_double(argv[i]);
+  loss.formulas.evaluate(values.data());
+  sqlite3_result_double(ctx, values[loss.*result]);
+}
+
+void grossLoss(sqlite3_context *ctx, int argc, sqlite3_value **argv) {
+  jobLoss(ctx, argc, argv, &JobLoss::grossLoss);
+}
+
+void lossPct(sqlite3_context *ctx, int argc, sqlite3_value **argv) {
+  jobLoss(ctx, argc, argv, &JobLoss::lossPercent);
+}
+
+// A job sheet weight, stored as "12.345" or as a number
+Milligrams weightOf(const QJsonValue &v) {
+  return v.isString() ? Milligrams::parse(v.toString())
+                      : Milligrams::fromDouble(v.toDouble());
+}
+
+void jsonWeightStep(sqlite3_context *ctx, int, sqlite3_value **argv) {
+  auto *total = static_cast<qint64 *>(
+      sqlite3_aggregate_context(ctx, sizeof(qint64))); // zeroed
+  if (!total || sqlite3_value_type(argv[0]) != SQLITE_TEXT)
+    return;
+  const QByteArray json = QByteArray::fromRawData(
+      reinterpret_cast<const char *>(sqlite3_value_text(argv[0])),
+      sqlite3_value_bytes(argv[0]));
+  const QJsonDocument doc = QJsonDocument::fromJson(json);
+  for (const QJsonValue &v : doc.array()) {
+    const QJsonObject entry = v.toObject();
+    *total += weightOf(entry.contains("weight") ? entry["weight"]
+                                                : entry["wt"])
+                  .raw();
+  }
+}
+
+void jsonWeightFinal(sqlite3_context *ctx) {
+  auto *total = static_cast<qint64 *>(sqlite3_aggregate_context(ctx, 0));
+  sqlite3_result_double(ctx,
+                        Milligrams::fromRaw(total ? *total : 0).toDouble());
+}
+
+const struct {
+  const char *name;
+  int args;
+  void (*scalar)(sqlite3_context *, int, sqlite3_value **);
+} kScalars[] = {
+    {"karat_factor", 1, karatFactor}, {"fineness", 1, fineness},
+    {"fine_wt", 2, fineWt},           {"gross_loss", 5, grossLoss},
+    {"loss_pct", 5, lossPct},
+};
+
+// Connections install() succeeded on, by name; worker connections are
+// installed from their own threads
+QMutex installedMutex;
+QSet<QString> installed;
+
+void markInstalled(const QString &connection, bool ok) {
+  QMutexLocker lock(&installedMutex);
+  if (ok)
+    installed.insert(connection);
+  else
+    installed.remove(connection);
+}
+
+sqlite3 *handleOf(const QSqlDatabase &db) {
+  const QVariant v = db.driver() ? db.driver()->handle() : QVariant();
+  if (!v.isValid() || qstrcmp(v.typeName(), "sqlite3*") != 0)
+    return nullptr;
+  return *static_cast<sqlite3 *const *>(v.constData());
+}
+} // namespace
+
+bool SqlFunctions::install(QSqlDatabase db) {
+  markInstalled(db.connectionName(), false);
+  sqlite3 *handle = handleOf(db);
+  if (!handle) {
+    qWarning() << "SqlFunctions: no SQLite handle on" << db.connectionName();
+    return false;
+  }
+
+  const int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC;
+  for (const auto &f : kScalars) {
+    if (sqlite3_create_function_v2(handle, f.name, f.args, flags, nullptr,
+                                   f.scalar, nullptr, nullptr,
+                                   nullptr) != SQLITE_OK) {
+      qWarning() << "SqlFunctions: cannot register" << f.name
+                 << sqlite3_errmsg(handle);
+      return false;
+    }
+  }
+  if (sqlite3_create_function_v2(handle, "json_weight_sum", 1, SQLITE_UTF8,
+                                 nullptr, nullptr, jsonWeightStep,
+                                 jsonWeightFinal, nullptr) != SQLITE_OK) {
+    qWarning() << "SqlFunctions: cannot register json_weight_sum"
+               << sqlite3_errmsg(handle);
+    return false;
+  }
+  markInstalled(db.connectionName(), true);
+  return true;
+}
+
+bool SqlFunctions::available(const QSqlDatabase &db) {
+  QMutexLocker lock(&installedMutex);
+  return db.isOpen() && installed.contains(db.connectionName());
+}
+
+#else // !LUXEMINE_SQLITE_FUNCTIONS
+
+bool SqlFunctions::install(QSqlDatabase) {
+  // Once, not for every worker connection
+  static const bool warned = [] {
+    qInfo() << "SqlFunctions: built without LUXEMINE_SQL_FUNCTIONS, SQL "
+               "functions are not available";
+    return true;
+  }();
+  Q_UNUSED(warned);
+  return false;
+}
+
+bool SqlFunctions::available(const QSqlDatabase &) { return false; }
+
+#endif // LUXEMINE_SQLITE_FUNCTIONS
@@ -0,0 +1,41 @@
+#ifndef SQLFUNCTIONS_H
+#define SQLFUNCTIONS_H
+
+#include <QSqlDatabase>
+
+// The karat, fine weight and loss arithmetic as SQL functions, so reports
+// can group and filter inside SQLite instead of pulling rows into C++:
+//
+//   karat_factor(kt)          chart purity factor of a karat (Karat::factor)
+//   fineness(purity)          parts per thousand of "18K", "75%", 0.75, 750
+//   fine_wt(weight, purity)   pure metal in `weight`; purity as above
+//   gross_loss(issue, gross, dia, stone, runner)
+//   loss_pct(issue, gross, dia, stone, runner)
+//                             the jobs ledger's default gross_loss and
+//                             loss_percent formulas (LedgerFormulas)
+//   json_weight_sum(json)     aggregate: total "weight" (or "wt") of the
+//                             entries of job sheet JSON arrays, summed in
+//                             exact milligrams
+//
+//   SELECT metal, SUM(fine_wt(weight, purity)) FROM stocks GROUP BY metal
+//
+// All but json_weight_sum are deterministic, so they may be used in
+// indexes on expressions. Shop overrides of the ledger formulas are not
+// seen by SQL; the lists still apply those.
+//
+// SQLite functions belong to one connection: install() runs on the main
+// connection and on each worker clone (DatabaseManager). It needs the
+// sqlite3 API of the very library Qt's QSQLITE driver uses, so it is only
+// built with the LUXEMINE_SQL_FUNCTIONS CMake option (Qt configured with
+// -system-sqlite). Otherwise install() returns false; callers check
+// available() and keep a C++ path.
+namespace SqlFunctions {
+
+bool install(QSqlDatabase db);
+
+// Whether install() succeeded on this connection
+bool available(const QSqlDatabase &db);
+
+} // namespace SqlFunctions
+
+#endif // SQLFUNCTIONS_H
@@ -1,5 +1,7 @@
 #include "UserRepository.h"
 #include "DatabaseManager.h"
+#include "writetransaction.h"
+#include "querycache.h"
 #include "models/UserPaymentView.h"
 
 #include <QSqlQuery>
@@ -84,10 +86,9 @@ bool UserRepository::createUser(
 {
     QSqlDatabase db = DatabaseManager::instance().database();
 
-    if (!db.transaction()) {
-        qCritical() << "Failed to start DB transaction";
+    WriteTransaction tx(db, "createUser");
+    if (!tx.begin())
         return false;
-    }
 
     // -----------------------------
     // 1️⃣ Insert into users
@@ -104,7 +105,7 @@ bool UserRepository::createUser(
 
     if (!userQuery.exec()) {
         qCritical() << "Insert users failed:" << userQuery.lastError().text();
-        db.rollback();
+        tx.rollback();
         return false;
     }
 
@@ -128,7 +129,7 @@ bool UserRepository::createUser(
 
     if (!empQuery.exec()) {
         qCritical() << "Insert employees failed:" << empQuery.lastError().text();
-        db.rollback();
+        tx.rollback();
         return false;
     }
 
@@ -145,7 +146,7 @@ bool UserRepository::createUser(
 
         if (!roleQuery.exec() || !roleQuery.next()) {
             qCritical() << "Role not found:" << roleName;
-            db.rollback();
+            tx.rollback();
             return false;
         }
 
@@ -163,7 +164,7 @@ bool UserRepository::createUser(
         if (!mapQuery.exec()) {
             qCritical() << "Insert user_roles failed:"
                         << mapQuery.lastError().text();
-            db.rollback();
+            tx.rollback();
             return false;
         }
     }
@@ -184,7 +185,7 @@ bool UserRepository::createUser(
         if (!sellerQuery.exec()) {
             qCritical() << "Insert seller_profile failed:"
                         << sellerQuery.lastError().text();
-            db.rollback();
+            tx.rollback();
             return false;
         }
     }
@@ -192,20 +193,19 @@ bool UserRepository::createUser(
     // -----------------------------
     // ✅ Commit transaction
     // -----------------------------
-    if (!db.commit()) {
-        qCritical() << "DB commit failed";
-        db.rollback();
+    if (!tx.commit())
         return false;
-    }
 
+    for (const char *table : {"users", "employees", "user_roles", "seller_profile"})
+        QueryCache::instance().bump(table);
     return true;
 }
 
 
-QList<UserPaymentView> UserRepository::getUsersWithPayments(int month, int year)
+namespace {
+// Uncached; see UserRepository::getUsersWithPayments()
+bool loadUsersWithPayments(int month, int year, QList<UserPaymentView> &list)
 {
-    QList<UserPaymentView> list;
-
     QSqlQuery query(DatabaseManager::instance().database());
 
     query.prepare(R"(
@@ -239,7 +239,7 @@ QList<UserPaymentView> UserRepository::getUsersWithPayments(int month, int year)
     if (!query.exec()) {
         qCritical() << "View users query failed:"
                     << query.lastError().text();
-        return list;
+        return false;
     }
 
     while (query.next()) {
@@ -262,7 +262,18 @@ QList<UserPaymentView> UserRepository::getUsersWithPayments(int month, int year)
         list.append(row);
     }
 
-    return list;
+    return true;
+}
+} // namespace
+
+QList<UserPaymentView> UserRepository::getUsersWithPayments(int month, int year)
+{
+    return QueryCache::instance().get<QList<UserPaymentView>>(
+        QString("getUsersWithPayments:%1-%2").arg(year).arg(month),
+        {"users", "employees", "user_roles", "roles", "employee_payments"},
+        [month, year](QList<UserPaymentView> &list) {
+            return loadUsersWithPayments(month, year, list);
+        });
 }
 
 bool UserRepository::updateMonthlyPayment(
@@ -276,54 +287,42 @@ bool UserRepository::updateMonthlyPayment(
 {
     QSqlDatabase db = DatabaseManager::instance().database();
 
-    if (!db.transaction()) {
-        qCritical() << "Failed to start payment transaction";
+    WriteTransaction tx(db, "updateMonthlyPayment");
+    if (!tx.begin())
         return false;
-    }
-    // qDebug()<<"here" << employeeId  ;
-    // Check if record exists
-    QSqlQuery check(db);
-    check.prepare(R"(
-        SELECT id FROM employee_payments
-        WHERE employee_id = ? AND month = ? AND year = ?
-    )");
-    check.addBindValue(employeeId);
-    check.addBindValue(month);
-    check.addBindValue(year);
 
-    if (!check.exec()) {
-        qCritical() << "Payment check failed:" << check.lastError().text();
-        db.rollback();
+    if (!writeMonthlyPayment(employeeId, month, year,
+                             workedDays, advancePaid, paidAmount)) {
+        tx.rollback();
         return false;
     }
 
-    bool exists = check.next();
+    return tx.commit();
+}
 
-    QSqlQuery query(db);
+bool UserRepository::writeMonthlyPayment(
+    int employeeId,
+    int month,
+    int year,
+    int workedDays,
+    double advancePaid,
+    double paidAmount
+    )
+{
+    QSqlDatabase db = DatabaseManager::instance().database();
 
-    if (exists) {
-        // -----------------------------
-        // UPDATE existing row
-        // -----------------------------
-        query.prepare(R"(
-            UPDATE employee_payments
-            SET worked_days = :days,
-                advance_paid = :advance,
-                paid_amount = :paid
-            WHERE employee_id = :emp
-              AND month = :month
-              AND year = :year
-        )");
-    } else {
-        // -----------------------------
-        // INSERT new row
-        // -----------------------------
-        query.prepare(R"(
-            INSERT INTO employee_payments
-            (employee_id, month, year, worked_days, advance_paid, paid_amount)
-            VALUES (:emp, :month, :year, :days, :advance, :paid)
-        )");
-    }
+    // One statement on UNIQUE(employee_id, month, year) instead of
+    // SELECT then INSERT or UPDATE
+    QSqlQuery query(db);
+    query.prepare(R"(
+        INSERT INTO employee_payments
+        (employee_id, month, year, worked_days, advance_paid, paid_amount)
+        VALUES (:emp, :month, :year, :days, :advance, :paid)
+        ON CONFLICT(employee_id, month, year) DO UPDATE SET
+            worked_days = excluded.worked_days,
+            advance_paid = excluded.advance_paid,
+            paid_amount = excluded.paid_amount
+    )");
 
     query.bindValue(":emp", employeeId);
     query.bindValue(":month", month);
@@ -334,16 +333,10 @@ bool UserRepository::updateMonthlyPayment(
 
     if (!query.exec()) {
         qCritical() << "Payment save failed:" << query.lastError().text();
-        db.rollback();
-        return false;
-    }
-
-    if (!db.commit()) {
-        qCritical() << "Payment commit failed";
-        db.rollback();
         return false;
     }
 
+    QueryCache::instance().bump("employee_payments");
     return true;
 }
 
@@ -389,6 +382,7 @@ bool UserRepository::updateUserPassword(int userId,
         return false;
     }
 
+    QueryCache::instance().bump("users");
     return true;
 }
 
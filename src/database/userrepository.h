@@ -40,6 +40,17 @@ public:
         double paidAmount
         );
 
+    // Same write without its own transaction, for callers that already
+    // hold one (WriteBehindQueue batches)
+    static bool writeMonthlyPayment(
+        int employeeId,
+        int month,
+        int year,
+        int workedDays,
+        double advancePaid,
+        double paidAmount
+        );
+
     static int getEmployeeIdByUsername(const QString &username);
 
     static bool updateUserPassword(int userId,
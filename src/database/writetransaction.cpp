@@ -0,0 +1,185 @@
+#include "writetransaction.h"
+#include "querycache.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+
+#include <atomic>
+
+namespace {
+// Attempts per BEGIN/COMMIT. They share one busy timeout between them:
+// each waits inside SQLite for its slice of what is left, so a locked
+// database fails after about one timeout, not one per attempt.
+constexpr int kMaxAttempts = 4;
+constexpr int kBackoffBaseMs = 50;
+constexpr int kDefaultBusyTimeoutMs = 5000;
+
+// A BEGIN/COMMIT slower than this was waiting for another writer
+constexpr qint64 kLockWaitMs = 20;
+
+int busyTimeoutOf(const QSqlDatabase &db) {
+  QSqlQuery q(db);
+  return q.exec("PRAGMA busy_timeout") && q.next() ? q.value(0).toInt()
+                                                   : kDefaultBusyTimeoutMs;
+}
+
+void setBusyTimeout(const QSqlDatabase &db, qint64 ms) {
+  QSqlQuery q(db);
+  q.exec(QString("PRAGMA busy_timeout = %1").arg(qMax<qint64>(0, ms)));
+}
+
+std::atomic<quint64> g_units{0};
+std::atomic<quint64> g_lockWaits{0};
+std::atomic<quint64> g_retries{0};
+std::atomic<quint64> g_busyFailures{0};
+std::atomic<qint64> g_waitMs{0};
+
+thread_local bool t_lastFailureWasBusy = false;
+thread_local WriteTransaction *t_open = nullptr; // begun, not yet ended
+} // namespace
+
+WriteTransaction::WriteTransaction(QSqlDatabase db, const char *name)
+    : m_db(db), m_name(name) {
+  t_lastFailureWasBusy = false;
+}
+
+WriteTransaction::~WriteTransaction() {
+  if (m_active)
+    rollback();
+}
+
+bool WriteTransaction::begin() {
+  if (!m_db.isOpen() && !m_db.open()) {
+    qCritical() << m_name << ": database not open";
+    return false;
+  }
+
+  ++g_units;
+  m_active = execWithRetry("BEGIN IMMEDIATE");
+  if (m_active)
+    t_open = this;
+  return m_active;
+}
+
+bool WriteTransaction::commit() {
+  if (!m_active)
+    return false;
+
+  // A busy COMMIT leaves the transaction open, so it can simply be retried
+  if (!execWithRetry("COMMIT")) {
+    rollback();
+    return false;
+  }
+  m_active = false;
+  t_open = nullptr;
+
+  const QList<std::function<void()>> pending = std::move(m_afterCommit);
+  m_afterCommit.clear();
+  for (const auto &fn : pending)
+    fn();
+  return true;
+}
+
+void WriteTransaction::rollback() {
+  if (!m_active)
+    return;
+  m_active = false;
+  t_open = nullptr;
+  m_afterCommit.clear();
+
+  QSqlQuery q(m_db);
+  if (!q.exec("ROLLBACK"))
+    qWarning() << m_name << ": rollback failed:" << q.lastError();
+
+  // Lists read back inside the transaction may hold uncommitted rows
+  QueryCache::instance().bumpAll();
+}
+
+bool WriteTransaction::execWithRetry(const char *sql) {
+  QElapsedTimer timer;
+  timer.start();
+
+  // The connection's own timeout is the budget; put back when done
+  const int busyTimeout = busyTimeoutOf(m_db);
+
+  QSqlQuery q(m_db);
+  int attempt = 1;
+  for (;; ++attempt) {
+    const qint64 left = busyTimeout - timer.elapsed();
+    setBusyTimeout(m_db, left / (kMaxAttempts - attempt + 1));
+    if (q.exec(QLatin1String(sql))) {
+      setBusyTimeout(m_db, busyTimeout);
+      const qint64 waited = timer.elapsed();
+      if (waited >= kLockWaitMs) {
+        ++g_lockWaits;
+        g_waitMs += waited;
+        qInfo() << "[perf]" << m_name << sql << "waited" << waited
+                << "ms for the write lock";
+      }
+      return true;
+    }
+
+    if (!isBusy(q.lastError()) || attempt == kMaxAttempts)
+      break;
+
+    // 50, 100, 200 ms plus jitter so two PCs do not retry in lockstep
+    const int backoff = (kBackoffBaseMs << (attempt - 1)) +
+                        QRandomGenerator::global()->bounded(kBackoffBaseMs);
+    if (timer.elapsed() + backoff >= busyTimeout)
+      break;
+    ++g_retries;
+    QThread::msleep(backoff);
+  }
+  setBusyTimeout(m_db, busyTimeout);
+
+  g_waitMs += timer.elapsed();
+  if (isBusy(q.lastError())) {
+    ++g_busyFailures;
+    t_lastFailureWasBusy = true;
+    qCritical() << m_name << ":" << sql << "gave up, database busy after"
+                << attempt << "attempts," << timer.elapsed() << "ms";
+  } else {
+    qCritical() << m_name << ":" << sql << "failed:" << q.lastError();
+  }
+  return false;
+}
+
+bool WriteTransaction::isBusy(const QSqlError &error) {
+  bool ok = false;
+  const int code = error.nativeErrorCode().toInt(&ok) & 0xff;
+  return ok && (code == 5 /* SQLITE_BUSY */ || code == 6 /* SQLITE_LOCKED */);
+}
+
+bool WriteTransaction::lastFailureWasBusy() { return t_lastFailureWasBusy; }
+
+void WriteTransaction::afterCommit(std::function<void()> fn) {
+  if (t_open)
+    t_open->m_afterCommit.append(std::move(fn));
+  else
+    fn();
+}
+
+WriteTransaction::Stats WriteTransaction::stats() {
+  Stats s;
+  s.units = g_units;
+  s.lockWaits = g_lockWaits;
+  s.retries = g_retries;
+  s.busyFailures = g_busyFailures;
+  s.waitMs = g_waitMs;
+  return s;
+}
+
+void WriteTransaction::logStats() {
+  const Stats s = stats();
+  qInfo().noquote() << QString("[perf] Write transactions: %1, lock waits "
+                               "%2 (%3 ms), retries %4, busy failures %5")
+                           .arg(s.units)
+                           .arg(s.lockWaits)
+                           .arg(s.waitMs)
+                           .arg(s.retries)
+                           .arg(s.busyFailures);
+}
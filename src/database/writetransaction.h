@@ -0,0 +1,67 @@
+#ifndef WRITETRANSACTION_H
+#define WRITETRANSACTION_H
+
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+
+#include <functional>
+
+// One write unit against a database file that other workstations share.
+//
+// begin() issues BEGIN IMMEDIATE, so the write lock is taken up front and
+// the statements inside cannot fail half way with "database is locked".
+// SQLITE_BUSY on BEGIN or COMMIT is retried with exponential backoff; the
+// attempts together wait about the connection's busy timeout, then give
+// up (lastFailureWasBusy()). Lock waits, retries and busy failures are
+// counted for the whole process.
+//
+//   WriteTransaction tx(db, "createOrder");
+//   if (!tx.begin()) return false;
+//   ... on error: tx.rollback(); return false;
+//   return tx.commit();
+//
+// A transaction still open when the object goes away is rolled back.
+// Cache invalidation inside one goes through afterCommit(), so other
+// connections cannot re-cache the old rows before COMMIT.
+class WriteTransaction {
+public:
+  struct Stats {
+    quint64 units = 0;     // transactions begun
+    quint64 lockWaits = 0; // BEGIN/COMMIT that waited for another writer
+    quint64 retries = 0;   // backoff retries after SQLITE_BUSY
+    quint64 busyFailures = 0;
+    qint64 waitMs = 0; // total time spent in those waits
+  };
+
+  WriteTransaction(QSqlDatabase db, const char *name);
+  ~WriteTransaction();
+
+  bool begin();
+  bool commit();
+  void rollback();
+
+  // SQLITE_BUSY / SQLITE_LOCKED, including extended codes
+  static bool isBusy(const QSqlError &error);
+
+  // True if the calling thread's last begin()/commit() gave up on a busy
+  // database, so the UI can say so instead of a generic save error
+  static bool lastFailureWasBusy();
+
+  // Runs `fn` now, or once the transaction open on this thread commits;
+  // dropped if it rolls back
+  static void afterCommit(std::function<void()> fn);
+
+  static Stats stats();
+  static void logStats();
+
+private:
+  bool execWithRetry(const char *sql);
+
+  QSqlDatabase m_db;
+  const char *m_name;
+  bool m_active = false;
+  QList<std::function<void()>> m_afterCommit;
+};
+
+#endif // WRITETRANSACTION_H
@@ -9,8 +9,12 @@
 #include <QComboBox>
 #include <QKeyEvent>
 #include <QDialog>
+#include <QImageReader>
 
 #include "database/databaseutils.h"
+#include "designer/shapesizedelegate.h"
+#include "common/imageingest.h"
+#include "common/imageservice.h"
 
 AddCatalog::AddCatalog(QWidget *parent)
     : QWidget(parent)
@@ -20,6 +24,8 @@ AddCatalog::AddCatalog(QWidget *parent)
     ui->setupUi(this);
 
     setupGoldTable();
+    ShapeSizeDelegate::install(ui->diaTable, "diamond");
+    ShapeSizeDelegate::install(ui->stoneTable, "stone");
     ui->companyName_lineEdit->setText("SHREE LAXMINARAYAN EXPORT");
 
     connect(ui->jewelryButton, &QPushButton::clicked, this, [this]() {
@@ -46,21 +52,15 @@ void AddCatalog::on_brows_clicked()
     if (filePath.isEmpty())
         return;
 
-    ui->imagPath_lineEdit->setText(filePath);
-
-    QPixmap pixmap(filePath);
-    if (pixmap.isNull()) {
+    if (!QImageReader(filePath).canRead()) {
         QMessageBox::warning(this, "Image Error", "Failed to load the selected image.");
         return;
     }
 
-    int labelWidth = ui->imageView_label_at_addImage->width();
-    int labelHeight = ui->imageView_label_at_addImage->height();
+    ui->imagPath_lineEdit->setText(filePath);
 
-    if (labelWidth > 0 && labelHeight > 0) {
-        ui->imageView_label_at_addImage->setPixmap(
-            pixmap.scaled(labelWidth, labelHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    }
+    // Decoded at label size; the full photo is only read once, on save
+    ImageService::instance().loadInto(ui->imageView_label_at_addImage, filePath);
 }
 
 void AddCatalog::calculateGoldWeights(QTableWidgetItem *item)
@@ -148,8 +148,8 @@ void AddCatalog::on_save_insert_clicked()
     QJsonArray diamondArray;
     for (int row = 0; row < ui->diaTable->rowCount(); ++row) {
         QJsonObject rowObject;
-        if (auto *combo = qobject_cast<QComboBox*>(ui->diaTable->cellWidget(row, 0))) rowObject["type"] = combo->currentText();
-        if (auto *combo = qobject_cast<QComboBox*>(ui->diaTable->cellWidget(row, 1))) rowObject["sizeMM"] = combo->currentText();
+        if (auto *item = ui->diaTable->item(row, 0)) rowObject["type"] = item->text();
+        if (auto *item = ui->diaTable->item(row, 1)) rowObject["sizeMM"] = item->text();
         if (auto *item = ui->diaTable->item(row, 2)) rowObject["quantity"] = item->text();
         diamondArray.append(rowObject);
     }
@@ -158,8 +158,8 @@ void AddCatalog::on_save_insert_clicked()
     QJsonArray stoneArray;
     for (int row = 0; row < ui->stoneTable->rowCount(); ++row) {
         QJsonObject rowObject;
-        if (auto *combo = qobject_cast<QComboBox*>(ui->stoneTable->cellWidget(row, 0))) rowObject["type"] = combo->currentText();
-        if (auto *combo = qobject_cast<QComboBox*>(ui->stoneTable->cellWidget(row, 1))) rowObject["sizeMM"] = combo->currentText();
+        if (auto *item = ui->stoneTable->item(row, 0)) rowObject["type"] = item->text();
+        if (auto *item = ui->stoneTable->item(row, 1)) rowObject["sizeMM"] = item->text();
         if (auto *item = ui->stoneTable->item(row, 2)) rowObject["quantity"] = item->text();
         stoneArray.append(rowObject);
     }
@@ -173,8 +173,11 @@ void AddCatalog::on_save_insert_clicked()
         goldArray.append(rowObject);
     }
 
-    // Save image
-    QString newImagePath = DatabaseUtils::saveImage(imagePath);
+    // Save image (oriented, downsized and re-encoded off the UI thread)
+    QString newImagePath = ImageIngest::runWithProgress(
+        this, "Saving image...", [&](const ImageIngest::ProgressFn &progress) {
+            return DatabaseUtils::saveImage(imagePath, progress);
+        });
     if (newImagePath.isEmpty()) {
         QMessageBox::warning(this, "File Error", "Failed to save the image!");
         return;
@@ -203,18 +206,9 @@ void AddCatalog::on_save_insert_clicked()
     ui->jewelryButton->setText("select jewelry type");
     ui->imageView_label_at_addImage->clear();
 
-    // Safely clear diamond + stone tables (delete widgets first)
-    auto clearTable = [](QTableWidget *table) {
-        for (int row = 0; row < table->rowCount(); ++row) {
-            for (int col = 0; col < table->columnCount(); ++col) {
-                QWidget *w = table->cellWidget(row, col);
-                if (w) delete w;
-            }
-        }
-        table->setRowCount(0);
-    };
-    clearTable(ui->diaTable);
-    clearTable(ui->stoneTable);
+    // Clear diamond + stone tables
+    ui->diaTable->setRowCount(0);
+    ui->stoneTable->setRowCount(0);
 
     // Reset gold weights
     for (int row = 0; row < ui->goldTable->rowCount(); ++row) {
@@ -267,37 +261,23 @@ void AddCatalog::on_demo_download_button_clicked()
 
 void AddCatalog::addTableRow(QTableWidget *table, const QString &tableType)
 {
-    int newRow = table->rowCount();
-    table->insertRow(newRow);
-
-    // parented to table → no leaks if row is removed
-    QComboBox *shapeCombo = new QComboBox(table);
-    QComboBox *sizeCombo = new QComboBox(table);
-
-    QStringList shapes = DatabaseUtils::fetchShapes(tableType);
+    // Shape/size are plain items edited through ShapeSizeDelegate;
+    // the lists come from the shared cached models
+    QStringList shapes = ShapeSizeModels::shapes(tableType)->stringList();
     if (shapes.isEmpty()) {
         QMessageBox::critical(this, "Database Error", "Failed to fetch shapes for " + tableType);
-        table->removeRow(newRow);
         return;
     }
 
-    shapeCombo->addItems(shapes);
-
-    auto populateSizeCombo = [this, sizeCombo, tableType](const QString &selectedShape) {
-        sizeCombo->clear();
-        QStringList sizes = DatabaseUtils::fetchSizes(tableType, selectedShape);
-        if (sizes.isEmpty()) {
-            QMessageBox::critical(this, "Database Error", "Failed to fetch sizes for " + selectedShape);
-            return;
-        }
-        sizeCombo->addItems(sizes);
-    };
-
-    populateSizeCombo(shapes.first());
-    connect(shapeCombo, &QComboBox::currentTextChanged, populateSizeCombo);
+    QStringList sizes = ShapeSizeModels::sizes(tableType, shapes.first())->stringList();
+    if (sizes.isEmpty()) {
+        QMessageBox::critical(this, "Database Error", "Failed to fetch sizes for " + shapes.first());
+    }
 
-    table->setCellWidget(newRow, 0, shapeCombo);
-    table->setCellWidget(newRow, 1, sizeCombo);
+    int newRow = table->rowCount();
+    table->insertRow(newRow);
+    table->setItem(newRow, 0, new QTableWidgetItem(shapes.first()));
+    table->setItem(newRow, 1, new QTableWidgetItem(sizes.value(0)));
 }
 
 void AddCatalog::keyPressEvent(QKeyEvent *event)
@@ -316,21 +296,11 @@ void AddCatalog::keyPressEvent(QKeyEvent *event)
 
         if (focusedTable && focusedTable->currentRow() >= 0) {
             if (QMessageBox::question(this, "Confirm Deletion", "Delete this row?") == QMessageBox::Yes) {
-                int row = focusedTable->currentRow();
-
-                // Explicitly delete widgets in the row to prevent leaks
-                for (int col = 0; col < focusedTable->columnCount(); ++col) {
-                    QWidget *cellWidget = focusedTable->cellWidget(row, col);
-                    if (cellWidget) {
-                        delete cellWidget;
-                    }
-                }
-
-                focusedTable->removeRow(row);
+                focusedTable->removeRow(focusedTable->currentRow());
             }
         }
     } else {
-        AddCatalog::keyPressEvent(event);
+        QWidget::keyPressEvent(event);
     }
 }
 
@@ -1,5 +1,6 @@
 #include "designerorderlistwidget.h"
 #include "database/databaseutils.h"
+#include "database/jobsheetcache.h"
 #include "ui_designerorderlist.h"
 
 #include <QAction>
@@ -11,7 +12,7 @@
 
 
 #include "dashboards/designerwindow.h"
-#include "manufacturer/jobsheetwidget.h"
+#include "manufacturer/jobsheetregistry.h"
 
 
 DesignerOrderListWidget::DesignerOrderListWidget(QWidget *parent)
@@ -19,6 +20,8 @@ DesignerOrderListWidget::DesignerOrderListWidget(QWidget *parent)
   ui->setupUi(this);
   setupTable();
   loadData();
+
+  JobSheetRegistry::instance().warmUp("designer");
 }
 
 DesignerOrderListWidget::~DesignerOrderListWidget() { delete ui; }
@@ -38,6 +41,9 @@ void DesignerOrderListWidget::setupTable() {
   ui->tableWidget->setContextMenuPolicy(Qt::CustomContextMenu);
   connect(ui->tableWidget, &QTableWidget::customContextMenuRequested, this,
           &DesignerOrderListWidget::onContextMenuRequested);
+
+  // Warm the job sheet cache for whatever row the user is heading towards
+  JobSheetCache::instance().prefetchFollowing(ui->tableWidget, 2); // Job No
 }
 
 void DesignerOrderListWidget::loadData() {
@@ -123,15 +129,7 @@ void DesignerOrderListWidget::openJobSheet() {
   if (!mdiArea)
     return;
 
-  // 🔹 Check if already open? (Optional enhancement, but nice)
-
-  // 🔹 Create JobSheet
-  JobSheetWidget *jobSheet = new JobSheetWidget();
-  jobSheet->set_value(jobNo);
-  jobSheet->setUserRole("designer");
-
-  QMdiSubWindow *subWindow = mdiArea->addSubWindow(jobSheet);
-  subWindow->setAttribute(Qt::WA_DeleteOnClose);
-  subWindow->setWindowTitle("Job Sheet - " + jobNo);
-  subWindow->show();
+  // 🔹 Focus the open sheet for this job, or bind a pooled one
+  JobSheetRegistry::instance().open(mdiArea, jobNo.toInt(), "designer",
+                                    "Job Sheet - " + jobNo);
 }
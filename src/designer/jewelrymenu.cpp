@@ -2,6 +2,7 @@
 
 #include "jewelrymenu.h"
 #include "databaseutils.h"
+#include "common/AppStyle.h"
 
 JewelryMenu::JewelryMenu(QObject *parent) : QObject(parent)
 {
@@ -10,34 +11,23 @@ JewelryMenu::JewelryMenu(QObject *parent) : QObject(parent)
 
     populateMenu();
 
-    menu->setStyleSheet(R"(
-        QMenu {
-            background-color: qlineargradient(spread:pad, x1:0, y1:0, x2:1, y2:1,
-                                              stop:0 #E0E0E0, stop:1 #F2F2F2);
-            color: #2C2C2C;
-            border: none;
-            border-radius: 6px;
-            padding: 3px 6px;
-            font-size: 14px;
-            font-weight: bold;
-            text-align: center;
-        }
-        QMenu::item {
-            background-color: transparent;
-            padding: 8px 20px;
-            margin: 2px 0;
-            border-radius: 4px;
-        }
-        QMenu::item:selected {
-            background-color: #D0D0D0;
-            color: #1A1A1A;
-        }
-        QMenu::separator {
-            height: 1px;
-            background: #B0B0B0;
-            margin: 6px 10px;
-        }
-    )");
+    // Light, bold menu via palette/font; submenus are separate windows so
+    // they do not inherit it and get the same treatment
+    QPalette pal = AppStyle::lightPalette();
+    pal.setColor(QPalette::Window, QColor("#EAEAEA"));
+    pal.setColor(QPalette::Highlight, QColor("#D0D0D0"));
+    pal.setColor(QPalette::HighlightedText, QColor("#1A1A1A"));
+
+    QFont f = menu->font();
+    f.setPixelSize(14);
+    f.setBold(true);
+
+    QList<QMenu*> menus = menu->findChildren<QMenu*>();
+    menus.prepend(menu);
+    for (QMenu *m : menus) {
+        m->setPalette(pal);
+        m->setFont(f);
+    }
 }
 
 JewelryMenu::~JewelryMenu()
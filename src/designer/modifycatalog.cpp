@@ -1,6 +1,10 @@
 #include "modifycatalog.h"
 #include "ui_modifycatalog.h"
 #include "database/databaseutils.h"
+#include "designer/shapesizedelegate.h"
+#include "common/AppStyle.h"
+#include "common/imageingest.h"
+#include "common/imageservice.h"
 
 #include <QVBoxLayout>
 #include <QSqlDatabase>
@@ -44,7 +48,17 @@ ModifyCatalog::ModifyCatalog(QWidget *parent)
     // 3. Load Initial Data
     loadCatalogGrid();
 
-    this->setStyleSheet(R"( QWidget{background-color:#F9FAFB;color:#2B2B2B;font-family:"Segoe UI","Arial";font-size:14px}QLineEdit{background-color:#FFFFFF;border:1px solid #C5C6C7;border-radius:0px;padding:4px 6px;selection-background-color:#4A90E2}QLineEdit:focus{border:1px solid #4A90E2;background-color:#FDFEFF}QPushButton{background-color:#E7E9EC;border:1px solid #C5C6C7;border-radius:0px;padding:6px 10px;font-weight:500}QPushButton:hover{background-color:#DDE4F2;border:1px solid #4A90E2}QPushButton:pressed{background-color:#C7D8F0;border:1px solid #4A90E2}QStackedWidget{background-color:#FFFFFF;border:1px solid #C5C6C7;border-radius:0px}QListView{background-color:#F9FAFB;border:1px solid #C5C6C7;border-radius:0px;color:#2B2B2B;outline:none;padding:6px}QListView::item{background-color:#FFFFFF;border:1px solid #D4D4D4;border-radius:0px;margin:8px;padding:8px 6px}QListView::item:hover{background-color:#EEF3FA;border:1px solid #9EB9E2;color:#1A1A1A}QListView::item:selected{background-color:#D9E8FC;border:1px solid #4A90E2;color:#000000;font-weight:500}QScrollBar:vertical,QScrollBar:horizontal{background:#F2F2F2;border:none;width:12px;height:12px}QScrollBar::handle:vertical,QScrollBar::handle:horizontal{background:#BDBDBD;border:1px solid #A5A5A5;border-radius:0px}QScrollBar::handle:vertical:hover,QScrollBar::handle:horizontal:hover{background:#9E9E9E}QScrollBar::add-line,QScrollBar::sub-line{background:none;border:none;width:0;height:0})");
+    // Light scheme through the palette (AppStyle draws it); only the catalog
+    // cards still need a small stylesheet
+    setPalette(AppStyle::lightPalette());
+    setAutoFillBackground(true);
+    QFont f = font();
+    f.setPixelSize(14);
+    setFont(f);
+    modifyCatalogView->setStyleSheet(
+        "QListView::item{background:#FFFFFF;border:1px solid #D4D4D4;padding:8px 6px}"
+        "QListView::item:hover{background:#EEF3FA;border:1px solid #9EB9E2}"
+        "QListView::item:selected{background:#D9E8FC;border:1px solid #4A90E2;color:#000000}");
 }
 
 ModifyCatalog::~ModifyCatalog()
@@ -163,6 +177,8 @@ void ModifyCatalog::setupFormPage()
     ui->designNO_lineEdit->setEnabled(false); // ID typically readonly in Edit mode
 
     setupGoldTable();
+    ShapeSizeDelegate::install(ui->diaTable, "diamond");
+    ShapeSizeDelegate::install(ui->stoneTable, "stone");
 
     // Connections
     connect(ui->save_insert, &QPushButton::clicked, this, &ModifyCatalog::on_save_insert_clicked);
@@ -194,7 +210,11 @@ void ModifyCatalog::loadCatalogGrid()
         QString fullPath = QFile::exists(path) ? path : QDir(qApp->applicationDirPath()).filePath(path);
         if (!QFile::exists(fullPath)) fullPath = ":/icon/icons/no_image_1.png"; // Fallback
 
-        QPixmap pix(fullPath);
+        // Ingested images have a small "_thumb" copy; decode that at icon size
+        QPixmap pix = QPixmap::fromImage(
+            ImageService::instance().image(ImageIngest::thumbnailFor(fullPath), iconSize));
+        if (pix.isNull())
+            pix.load(fullPath); // resource fallback icon
         if (pix.isNull()) {
             // Fallback generated or color
             pix = QPixmap(iconSize);
@@ -301,11 +321,6 @@ void ModifyCatalog::loadDesignForEdit(const QString & designNo)
         ui->imageView_label_at_addImage->clear();
     }
 
-    // Prepare shape lists once and log
-    QStringList diaShapes = DatabaseUtils::fetchShapes("diamond");
-    QStringList stoneShapes = DatabaseUtils::fetchShapes("stone");
-    qDebug() << "[ModifyCatalog] fetched shapes: diamond=" << diaShapes.size() << "stone=" << stoneShapes.size();
-
     // Tables population with defensive checks
     auto populateTable = [&](QTableWidget* table, const QString& jsonStr, const QString& type) {
         if (!table) {
@@ -317,18 +332,6 @@ void ModifyCatalog::loadDesignForEdit(const QString & designNo)
         table->setUpdatesEnabled(false);
         table->blockSignals(true);
 
-        // Remove existing cell widgets safely using deleteLater to avoid reentrancy issues
-        for (int r = table->rowCount() - 1; r >= 0; --r) {
-            for (int c = 0; c < table->columnCount(); ++c) {
-                QWidget* w = table->cellWidget(r, c);
-                if (w) {
-                    table->removeCellWidget(r, c);
-                    w->setParent(nullptr); // detach to be safe
-                    w->deleteLater();
-                }
-            }
-        }
-
         // Clear contents (removes QTableWidgetItems). We'll reset columns next.
         table->clearContents();
         table->setRowCount(0);
@@ -381,39 +384,10 @@ void ModifyCatalog::loadDesignForEdit(const QString & designNo)
                 table->setItem(row, 1, new QTableWidgetItem(obj.value("weight(g)").toString()));
             }
             else {
-                // shape combo
-                QComboBox* shapeBox = new QComboBox(table);
-                if (type == "diamond")
-                    shapeBox->addItems(diaShapes);
-                else
-                    shapeBox->addItems(stoneShapes);
-
-                QString shapeVal = obj.value("type").toString();
-                if (!shapeVal.isEmpty()) {
-                    if (shapeBox->findText(shapeVal) == -1)
-                        shapeBox->addItem(shapeVal);
-                    shapeBox->setCurrentText(shapeVal);
-                }
-
-                // size combo - fetch sizes defensively
-                QComboBox* sizeBox = new QComboBox(table);
-                QStringList sizes = DatabaseUtils::fetchSizes(type, shapeVal);
-                if (sizes.isEmpty()) {
-                    QString sizeVal = obj.value("sizeMM").toString();
-                    if (!sizeVal.isEmpty())
-                        sizeBox->addItem(sizeVal);
-                }
-                else {
-                    sizeBox->addItems(sizes);
-                    QString sizeVal = obj.value("sizeMM").toString();
-                    if (!sizeVal.isEmpty() && sizeBox->findText(sizeVal) == -1)
-                        sizeBox->addItem(sizeVal);
-                    sizeBox->setCurrentText(sizeVal);
-                }
-
-                // Parent widgets to the table by passing 'table' in constructor; safe to set as cell widgets now.
-                table->setCellWidget(row, 0, shapeBox);
-                table->setCellWidget(row, 1, sizeBox);
+                // Shape/size are edited through ShapeSizeDelegate, so no
+                // widgets or size queries per row here
+                table->setItem(row, 0, new QTableWidgetItem(obj.value("type").toString()));
+                table->setItem(row, 1, new QTableWidgetItem(obj.value("sizeMM").toString()));
                 table->setItem(row, 2, new QTableWidgetItem(obj.value("quantity").toString()));
             }
         }
@@ -458,12 +432,9 @@ void ModifyCatalog::on_save_insert_clicked()
                  if (t->item(i,1)) obj["weight(g)"] = t->item(i,1)->text();
                  if (obj["weight(g)"].toString().isEmpty()) continue; // skip empty rows
              } else {
-                 auto *cb1 = qobject_cast<QComboBox*>(t->cellWidget(i,0));
-                 auto *cb2 = qobject_cast<QComboBox*>(t->cellWidget(i,1));
-                 auto *item = t->item(i,2);
-                 if (cb1) obj["type"] = cb1->currentText();
-                 if (cb2) obj["sizeMM"] = cb2->currentText();
-                 if (item) obj["quantity"] = item->text();
+                 if (t->item(i,0)) obj["type"] = t->item(i,0)->text();
+                 if (t->item(i,1)) obj["sizeMM"] = t->item(i,1)->text();
+                 if (t->item(i,2)) obj["quantity"] = t->item(i,2)->text();
              }
              arr.append(obj);
         }
@@ -474,7 +445,10 @@ void ModifyCatalog::on_save_insert_clicked()
     QJsonArray diaArr = buildJson(ui->diaTable, false);
     QJsonArray stoneArr = buildJson(ui->stoneTable, false);
 
-    QString newImagePath = DatabaseUtils::saveImage(imagePath);
+    QString newImagePath = ImageIngest::runWithProgress(
+        this, "Saving image...", [&](const ImageIngest::ProgressFn &progress) {
+            return DatabaseUtils::saveImage(imagePath, progress);
+        });
 
     // Use insertCatalogData (logic in DBUtils handles modify if design exists)
     QString res = DatabaseUtils::insertCatalogData(
@@ -503,10 +477,7 @@ void ModifyCatalog::on_brows_clicked()
         this, "Select Image", "", "Images (*.png *.jpg *.jpeg *.bmp *.gif)");
     if (!filePath.isEmpty()) {
         ui->imagPath_lineEdit->setText(filePath);
-        QPixmap p(filePath);
-        if (!p.isNull()) {
-             ui->imageView_label_at_addImage->setPixmap(p.scaled(ui->imageView_label_at_addImage->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        }
+        ImageService::instance().loadInto(ui->imageView_label_at_addImage, filePath);
     }
 }
 
@@ -0,0 +1,144 @@
+#include "shapesizedelegate.h"
+
+#include <QAbstractItemView>
+#include <QComboBox>
+#include <QCoreApplication>
+#include <QTableWidget>
+
+#include <functional>
+
+#include "database/databaseutils.h"
+#include "database/querycache.h"
+
+namespace {
+QHash<QString, QStringListModel*> &modelCache()
+{
+    static QHash<QString, QStringListModel*> cache;
+    return cache;
+}
+
+// The reference tables a table type's lists are read from
+QStringList sourceTables(const QString &tableType)
+{
+    if (tableType == "diamond")
+        return {"Fancy_diamond", "Round_diamond"};
+    return {"stones"};
+}
+
+// The model for key, holding the list QueryCache has for it. The list is
+// fetched again once its tables change (or another workstation writes),
+// and an empty result, e.g. from a failed query, is never kept.
+QStringListModel *cachedModel(const QString &tableType, const QString &key,
+                              const std::function<QStringList()> &fetch)
+{
+    const QStringList list = QueryCache::instance().get<QStringList>(
+        "shapesize/" + key, sourceTables(tableType), [&](QStringList &out) {
+            out = fetch();
+            return !out.isEmpty();
+        });
+
+    auto &cache = modelCache();
+    QStringListModel *model = cache.value(key);
+    if (!model) {
+        // Owned by the application so the lists outlive any single form
+        model = new QStringListModel(list, QCoreApplication::instance());
+        cache.insert(key, model);
+    } else if (model->stringList() != list) {
+        model->setStringList(list);
+    }
+    return model;
+}
+} // namespace
+
+// ---------- ShapeSizeModels ----------
+
+QStringListModel *ShapeSizeModels::shapes(const QString &tableType)
+{
+    return cachedModel(tableType, tableType, [&]() {
+        return DatabaseUtils::fetchShapes(tableType);
+    });
+}
+
+QStringListModel *ShapeSizeModels::sizes(const QString &tableType, const QString &shape)
+{
+    return cachedModel(tableType, tableType + '/' + shape, [&]() {
+        return DatabaseUtils::fetchSizes(tableType, shape);
+    });
+}
+
+void ShapeSizeModels::seed(const QString &tableType, const QStringList &shapes,
+                           const QHash<QString, QStringList> &sizesByShape)
+{
+    cachedModel(tableType, tableType, [&]() { return shapes; });
+    for (auto it = sizesByShape.cbegin(); it != sizesByShape.cend(); ++it)
+        cachedModel(tableType, tableType + '/' + it.key(), [&]() { return it.value(); });
+}
+
+// ---------- ShapeSizeDelegate ----------
+
+ShapeSizeDelegate::ShapeSizeDelegate(const QString &tableType, Column column, QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_tableType(tableType)
+    , m_column(column)
+{
+}
+
+QWidget *ShapeSizeDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &,
+                                         const QModelIndex &index) const
+{
+    auto *combo = new QComboBox(parent);
+
+    if (m_column == Shape) {
+        combo->setModel(ShapeSizeModels::shapes(m_tableType));
+    } else {
+        const QString shape = index.sibling(index.row(), Shape).data().toString();
+        combo->setModel(ShapeSizeModels::sizes(m_tableType, shape));
+    }
+
+    // Commit as soon as a value is picked, like the old cell widgets did
+    connect(combo, &QComboBox::activated, this, &ShapeSizeDelegate::commitAndCloseEditor);
+    return combo;
+}
+
+void ShapeSizeDelegate::commitAndCloseEditor()
+{
+    auto *combo = qobject_cast<QComboBox*>(sender());
+    if (!combo)
+        return;
+    emit commitData(combo);
+    emit closeEditor(combo);
+}
+
+void ShapeSizeDelegate::setEditorData(QWidget *editor, const QModelIndex &index) const
+{
+    auto *combo = static_cast<QComboBox*>(editor);
+    // Legacy values missing from the lists stay untouched (index -1)
+    combo->setCurrentIndex(combo->findText(index.data().toString()));
+}
+
+void ShapeSizeDelegate::setModelData(QWidget *editor, QAbstractItemModel *model,
+                                     const QModelIndex &index) const
+{
+    auto *combo = static_cast<QComboBox*>(editor);
+    if (combo->currentIndex() < 0)
+        return;
+
+    const QString value = combo->currentText();
+    if (value == index.data().toString())
+        return;
+
+    model->setData(index, value);
+
+    // New shape → its first size, as the shape combo used to do
+    if (m_column == Shape) {
+        const QStringList sizes = ShapeSizeModels::sizes(m_tableType, value)->stringList();
+        model->setData(index.sibling(index.row(), Size), sizes.value(0));
+    }
+}
+
+void ShapeSizeDelegate::install(QTableWidget *table, const QString &tableType)
+{
+    table->setItemDelegateForColumn(Shape, new ShapeSizeDelegate(tableType, Shape, table));
+    table->setItemDelegateForColumn(Size, new ShapeSizeDelegate(tableType, Size, table));
+    table->setEditTriggers(table->editTriggers() | QAbstractItemView::SelectedClicked);
+}
@@ -0,0 +1,56 @@
+#ifndef SHAPESIZEDELEGATE_H
+#define SHAPESIZEDELEGATE_H
+
+#include <QHash>
+#include <QStyledItemDelegate>
+#include <QStringListModel>
+
+class QTableWidget;
+
+// Shape / size lists for the diamond and stone tables, one model per
+// (table type, shape) shared by every editor. The lists live in QueryCache,
+// so they are fetched again after the reference tables change.
+class ShapeSizeModels
+{
+public:
+    static QStringListModel *shapes(const QString &tableType);
+    static QStringListModel *sizes(const QString &tableType, const QString &shape);
+
+    // Fill the cache from lists fetched elsewhere (startup loads them on a
+    // worker thread). GUI thread only; lists already cached are kept, and
+    // empty ones are left to be fetched on first use.
+    static void seed(const QString &tableType, const QStringList &shapes,
+                     const QHash<QString, QStringList> &sizesByShape);
+};
+
+// Combo box editor for column 0 (shape) or 1 (size) of a diamond/stone
+// table. The editor only exists while the cell is being edited; the rest
+// of the time the cell is a plain item, so a 40-line design builds no
+// widgets and runs no per-row queries.
+class ShapeSizeDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    enum Column { Shape = 0, Size = 1 };
+
+    ShapeSizeDelegate(const QString &tableType, Column column, QObject *parent = nullptr);
+
+    QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                          const QModelIndex &index) const override;
+    void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+    void setModelData(QWidget *editor, QAbstractItemModel *model,
+                      const QModelIndex &index) const override;
+
+    // Put shape/size delegates on columns 0 and 1 of table
+    static void install(QTableWidget *table, const QString &tableType);
+
+private slots:
+    void commitAndCloseEditor();
+
+private:
+    QString m_tableType;
+    Column m_column;
+};
+
+#endif // SHAPESIZEDELEGATE_H
@@ -1,34 +1,75 @@
 #include <QApplication>
+#include <QFont>
 #include <QMessageBox>
+#include <QTimer>
 
 #include "auth/LoginWindow.h"
 #include "common/AppStyle.h"
+#include "common/startuppipeline.h"
 #include "database/DatabaseManager.h"
+#include "database/querycache.h"
+#include "database/writetransaction.h"
 
 
 int main(int argc, char *argv[]) {
+  StartupPipeline &startup = StartupPipeline::instance();
+  startup.begin();
+
   QApplication app(argc, argv);
+  startup.mark("qapplication");
 
   // -------------------------------------------------
   // Apply Global Style
   // -------------------------------------------------
-  app.setStyleSheet(AppStyle::getDarkTheme());
+  // Proxy style + palette; set LUXEMINE_LEGACY_QSS=1 to run with the old
+  // app-wide stylesheet instead (LuxeMineBench times the two).
+  if (qEnvironmentVariableIsSet("LUXEMINE_LEGACY_QSS")) {
+    app.setStyleSheet(AppStyle::getDarkTheme());
+  } else {
+    app.setFont(QFont("Segoe UI", 11));
+    app.setStyle(new AppStyle);
+    app.setPalette(AppStyle::darkPalette());
+  }
 
   // -------------------------------------------------
-  // Initialize Database
+  // Open Database (schema is checked in the background)
   // -------------------------------------------------
-  if (!DatabaseManager::instance().initialize()) {
+  if (!startup.stage("open-db",
+                     []() { return DatabaseManager::instance().open(); })) {
     QMessageBox::critical(
         nullptr, "Database Error",
         "Failed to initialize database.\nApplication will exit.");
     return -1;
   }
 
+  QObject::connect(&startup, &StartupPipeline::schemaReady, &app,
+                   [](bool ok) {
+                     if (ok)
+                       return;
+                     QMessageBox::critical(
+                         nullptr, "Database Error",
+                         "Failed to initialize database.\nApplication will "
+                         "exit.");
+                     QCoreApplication::exit(-1);
+                   });
+  startup.startBackground();
+
+  // Lock waits / busy retries over the session, for multi-PC setups
+  QObject::connect(&app, &QCoreApplication::aboutToQuit,
+                   &WriteTransaction::logStats);
+  QObject::connect(&app, &QCoreApplication::aboutToQuit,
+                   []() { QueryCache::instance().logStats(); });
+
   // -------------------------------------------------
   // Show Login Window
   // -------------------------------------------------
   LoginWindow loginWindow;
   loginWindow.show();
+  startup.mark("login-shown");
+
+  // First event-loop pass: the window is painted and takes input
+  QTimer::singleShot(0, &startup,
+                     [&startup]() { startup.mark("login-interactive"); });
 
   return app.exec();
 }
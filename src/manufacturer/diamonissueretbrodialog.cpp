@@ -215,8 +215,15 @@ void DiamonIssueRetBroDialog::saveToDatabase(const QJsonObject &entry) {
   else
     return;
 
-  if (DatabaseUtils::addJobSheetHistoryEntry(currentJobNo, colName, entry)) {
+  int version = historyVersion;
+  bool conflict = false;
+  if (DatabaseUtils::addJobSheetHistoryEntry(currentJobNo, colName, entry,
+                                             &version, &conflict)) {
     qDebug() << "✅ Updated" << colName;
+    if (conflict)
+      qInfo() << "Job" << currentJobNo << "was updated by another user"
+              << "meanwhile; entry appended after theirs";
+    historyVersion = version;
   } else {
     qDebug() << "❌ Update failed for" << colName;
   }
@@ -259,7 +266,8 @@ void DiamonIssueRetBroDialog::loadHistoryForCurrentContext() {
     return;
 
   // 🧭 Step 3: Fetch from DB using DatabaseUtils
-  QJsonArray arr = DatabaseUtils::fetchJobSheetHistory(currentJobNo, colName);
+  QJsonArray arr =
+      DatabaseUtils::fetchJobSheetHistory(currentJobNo, colName, &historyVersion);
 
   // 🧭 Step 4: Clear and show history
   ui->historyTableWidget->setRowCount(0);
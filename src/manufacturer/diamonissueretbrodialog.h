@@ -38,6 +38,7 @@ private:
     int currentCol;
     QString currentJobNo;
     QString currentMode;  // "issue" or "return"
+    int historyVersion = -1;  // jobsheet_detail.row_version behind the history
 
 
     void loadTypeOptions();
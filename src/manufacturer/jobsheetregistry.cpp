@@ -0,0 +1,154 @@
+#include "jobsheetregistry.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEvent>
+#include <QMdiArea>
+#include <QMdiSubWindow>
+#include <QTimer>
+
+#include "jobsheetwidget.h"
+
+JobSheetRegistry &JobSheetRegistry::instance() {
+  static JobSheetRegistry registry;
+  return registry;
+}
+
+JobSheetRegistry::JobSheetRegistry() {
+  // Pooled sheets have no parent; they must go before QApplication does
+  connect(qApp, &QCoreApplication::aboutToQuit, this,
+          &JobSheetRegistry::clearPool);
+}
+
+JobSheetWidget *JobSheetRegistry::open(QMdiArea *mdi, int jobId,
+                                       const QString &role,
+                                       const QString &title) {
+  if (!mdi)
+    return nullptr;
+
+  // ---------- Already open → focus it ----------
+  for (QMdiSubWindow *sub : mdi->subWindowList()) {
+    auto *sheet = qobject_cast<JobSheetWidget *>(sub->widget());
+    if (sheet && sheet->jobId() == jobId && sheet->role() == role) {
+      if (sub->isMinimized())
+        sub->showNormal();
+      mdi->setActiveSubWindow(sub);
+      touch(sub);
+      return sheet;
+    }
+  }
+
+  // ---------- Pooled (or new) sheet bound to this job ----------
+  JobSheetWidget *sheet = acquire(role);
+  sheet->set_value(QString::number(jobId));
+
+  QMdiSubWindow *sub = mdi->addSubWindow(sheet);
+  sub->setAttribute(Qt::WA_DeleteOnClose);
+  sub->setWindowTitle(title);
+  sub->installEventFilter(this);
+  connect(sub, &QMdiSubWindow::aboutToActivate, this,
+          [this, sub]() { touch(sub); });
+
+  sheet->show();
+  sub->show();
+  touch(sub);
+  enforceOpenLimit();
+
+  // Have the next one ready before it is asked for
+  if (m_pool.value(role).isEmpty())
+    warmUp(role);
+
+  return sheet;
+}
+
+void JobSheetRegistry::warmUp(const QString &role) {
+  QTimer::singleShot(0, this, [this, role]() { warmOne(role); });
+}
+
+void JobSheetRegistry::warmOne(const QString &role) {
+  auto &pool = m_pool[role];
+  if (pool.size() >= m_poolSize)
+    return;
+
+  auto *sheet = new JobSheetWidget;
+  sheet->setUserRole(role);
+  pool.append(sheet);
+
+  // One sheet per event-loop pass so input is never held up for long
+  if (pool.size() < m_poolSize)
+    warmUp(role);
+}
+
+void JobSheetRegistry::setMaxOpen(int count) {
+  m_maxOpen = qMax(1, count);
+  enforceOpenLimit();
+}
+
+void JobSheetRegistry::setPoolSize(int count) {
+  m_poolSize = qMax(0, count);
+  for (auto &pool : m_pool) {
+    while (pool.size() > m_poolSize)
+      pool.takeLast()->deleteLater();
+  }
+}
+
+void JobSheetRegistry::clearPool() {
+  for (auto &pool : m_pool)
+    qDeleteAll(pool);
+  m_pool.clear();
+}
+
+bool JobSheetRegistry::eventFilter(QObject *watched, QEvent *event) {
+  if (event->type() == QEvent::Close) {
+    auto *sub = qobject_cast<QMdiSubWindow *>(watched);
+    auto *sheet = sub ? qobject_cast<JobSheetWidget *>(sub->widget()) : nullptr;
+    if (sheet) {
+      m_open.removeAll(sub);
+      // Detach before the sub-window deletes itself; the sheet ends up
+      // parentless and hidden
+      sub->setWidget(nullptr);
+      release(sheet);
+    }
+  }
+  return QObject::eventFilter(watched, event);
+}
+
+JobSheetWidget *JobSheetRegistry::acquire(const QString &role) {
+  auto &pool = m_pool[role];
+  if (!pool.isEmpty())
+    return pool.takeLast();
+
+  auto *sheet = new JobSheetWidget;
+  sheet->setUserRole(role);
+  return sheet;
+}
+
+void JobSheetRegistry::release(JobSheetWidget *sheet) {
+  auto &pool = m_pool[sheet->role()];
+  if (pool.size() >= m_poolSize) {
+    sheet->deleteLater();
+    return;
+  }
+
+  sheet->resetForReuse();
+  sheet->hide();
+  pool.append(sheet);
+}
+
+void JobSheetRegistry::touch(QMdiSubWindow *sub) {
+  m_open.removeAll(sub);
+  m_open.prepend(sub);
+}
+
+void JobSheetRegistry::enforceOpenLimit() {
+  m_open.removeAll(nullptr); // sub-windows destroyed with their dashboard
+
+  while (m_open.size() > m_maxOpen) {
+    QPointer<QMdiSubWindow> oldest = m_open.takeLast();
+    if (oldest) {
+      qInfo() << "JobSheetRegistry: closing least recently used"
+              << oldest->windowTitle();
+      oldest->close(); // back to the pool through eventFilter()
+    }
+  }
+}
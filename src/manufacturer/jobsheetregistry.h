@@ -0,0 +1,59 @@
+#ifndef JOBSHEETREGISTRY_H
+#define JOBSHEETREGISTRY_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+class JobSheetWidget;
+class QMdiArea;
+class QMdiSubWindow;
+
+// Owns the life cycle of job sheet windows in the MDI dashboards.
+//  - Opening a job that is already shown focuses that window.
+//  - Closed sheets go back to a small per-role pool (hidden, reset) and
+//    are rebound to the next job instead of being rebuilt from jobsheet.ui.
+//  - At most maxOpen() sheets stay open; the least recently used one is
+//    closed (and pooled) when another is opened.
+class JobSheetRegistry : public QObject {
+  Q_OBJECT
+
+public:
+  static JobSheetRegistry &instance();
+
+  // Focus or open the sheet for jobId inside mdi. Returns the sheet shown.
+  JobSheetWidget *open(QMdiArea *mdi, int jobId, const QString &role,
+                       const QString &title);
+
+  // Build spare sheets for role in idle time, up to poolSize()
+  void warmUp(const QString &role);
+
+  void setMaxOpen(int count);
+  int maxOpen() const { return m_maxOpen; }
+
+  void setPoolSize(int count);
+  int poolSize() const { return m_poolSize; }
+
+  // Delete every pooled sheet (open ones are left alone)
+  void clearPool();
+
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+  JobSheetRegistry();
+
+  JobSheetWidget *acquire(const QString &role);
+  void release(JobSheetWidget *sheet);
+  void touch(QMdiSubWindow *sub);
+  void enforceOpenLimit();
+  void warmOne(const QString &role);
+
+  QHash<QString, QList<JobSheetWidget *>> m_pool; // role -> hidden sheets
+  QList<QPointer<QMdiSubWindow>> m_open;          // most recent first
+  int m_maxOpen = 8;
+  int m_poolSize = 2;
+};
+
+#endif // JOBSHEETREGISTRY_H
@@ -9,14 +9,19 @@
 #include <QJsonValue>
 #include <QKeyEvent>
 #include <QMessageBox>
+#include <QFileInfo>
 #include <QScreen>
+#include <QSignalBlocker>
+#include <QTimer>
 #include <cmath>
 
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
 
+#include "common/imageservice.h"
 #include "database/databaseutils.h"
+#include "database/jobsheetcache.h"
 
 JobSheetWidget::JobSheetWidget(QWidget *parent)
     : QWidget(parent), ui(new Ui::JobSheetWidget) {
@@ -84,6 +89,14 @@ JobSheetWidget::JobSheetWidget(QWidget *parent)
   scaleTable(ui->diamondAndStoneDetailTableWidget);
   scaleTable(ui->goldDetailTableWidget);
 
+  // Re-decode the product image once the user stops dragging, not on
+  // every resize step
+  imageResizeTimer = new QTimer(this);
+  imageResizeTimer->setSingleShot(true);
+  imageResizeTimer->setInterval(150);
+  connect(imageResizeTimer, &QTimer::timeout, this,
+          &JobSheetWidget::refreshProductImage);
+
   // set_value(jobNo);
 
   // qDebug() << userRole;
@@ -98,6 +111,10 @@ JobSheetWidget::JobSheetWidget(QWidget *parent)
 }
 
 void JobSheetWidget::setUserRole(const QString &role) {
+  // Role setup makes connections, so it runs once per sheet; pooled sheets
+  // are only rebound to jobs of the same role.
+  if (role == userRole)
+    return;
   userRole = role;
   if (userRole == "designer") {
     set_value_designer();
@@ -112,14 +129,49 @@ void JobSheetWidget::setUserRole(const QString &role) {
 
 JobSheetWidget::~JobSheetWidget() { delete ui; }
 
+int JobSheetWidget::jobId() const {
+  return ui->jobNoLineEdit->text().trimmed().toInt();
+}
+
+void JobSheetWidget::resetForReuse() {
+  // Popups read the job no from this sheet, so never leave one open
+  if (newManageGold)
+    newManageGold->hide();
+  if (newDiamonIssueRetBro)
+    newDiamonIssueRetBro->hide();
+  qApp->removeEventFilter(this);
+  manageGold = false;
+  diamondMenuVisible = false;
+
+  imageResizeTimer->stop();
+  productImagePath.clear();
+  ui->productImageLabel->setProperty("imageServicePath", QString());
+  ui->productImageLabel->clear();
+
+  for (QLineEdit *edit : findChildren<QLineEdit *>())
+    edit->clear();
+  ui->noteTextEdit->clear();
+  ui->diaAndStoneForDesignTableWidget->setRowCount(0);
+
+  // Fixed grids from the .ui: keep the items and their flags, drop the
+  // values. Column 0 holds the row labels. Signals stay blocked so the
+  // gold table does not try to save the cleared return cells.
+  for (QTableWidget *table :
+       {ui->goldDetailTableWidget, ui->diamondAndStoneDetailTableWidget}) {
+    const QSignalBlocker blocker(table);
+    for (int r = 0; r < table->rowCount(); ++r)
+      for (int c = 1; c < table->columnCount(); ++c)
+        if (QTableWidgetItem *item = table->item(r, c))
+          item->setText(QString());
+    table->clearSelection();
+  }
+}
+
 void JobSheetWidget::resizeEvent(QResizeEvent *event) {
   // resizeEvent(event);
 
-  if (!originalPixmap.isNull()) {
-    ui->productImageLabel->setPixmap(
-        originalPixmap.scaled(ui->productImageLabel->size() * scaleFactor,
-                              Qt::KeepAspectRatio, Qt::SmoothTransformation));
-  }
+  if (!productImagePath.isEmpty())
+    imageResizeTimer->start();
 
   int marginLeftRight = static_cast<int>(4 * scaleFactor);
   int marginTopBottom = static_cast<int>(4 * scaleFactor);
@@ -159,12 +211,13 @@ void JobSheetWidget::set_value(const QString &jobNo) {
     // Optionally handle error
   }
 
-  auto dataOpt = DatabaseUtils::fetchJobSheetData(jobId);
-  if (!dataOpt) {
+  // Usually already prefetched by the jobs / designer list
+  auto snapshot = JobSheetCache::instance().take(jobId);
+  if (!snapshot) {
     qDebug() << "No record found for jobId:" << jobId;
     return;
   }
-  const auto &data = *dataOpt;
+  const auto &data = snapshot->data;
 
   // Fill UI
   ui->jobIssuLineEdit->setText(data.sellerId);
@@ -191,22 +244,14 @@ void JobSheetWidget::set_value(const QString &jobNo) {
 
   // Image
   if (!data.imagePath.isEmpty()) {
-    QString fullPath = QDir::cleanPath(QCoreApplication::applicationDirPath() +
-                                       "/" + data.imagePath);
-    originalPixmap.load(fullPath);
-
-    // Optional: support high-DPI
-    originalPixmap.setDevicePixelRatio(devicePixelRatioF());
-
-    // Scale and set pixmap manually
-    ui->productImageLabel->setPixmap(
-        originalPixmap.scaled(ui->productImageLabel->size(),
-                              Qt::KeepAspectRatio, Qt::SmoothTransformation));
+    productImagePath = QDir::cleanPath(
+        QCoreApplication::applicationDirPath() + "/" + data.imagePath);
+    refreshProductImage();
   }
 
   // Diamond & Stone
-  auto [diamondJson, stoneJson] =
-      DatabaseUtils::fetchDiamondAndStoneJson(data.designNo);
+  const QString &diamondJson = snapshot->diamondJson;
+  const QString &stoneJson = snapshot->stoneJson;
 
   QTableWidget *table = ui->diaAndStoneForDesignTableWidget;
   table->setRowCount(0);
@@ -265,8 +310,14 @@ void JobSheetWidget::set_value(const QString &jobNo) {
   // ✅ Refresh Manufacturer Tables (Issue/Return/Broken)
   // This ensures that even if updateDiamondTotals ran in constructor (with
   // empty jobNo), it runs again now that we have the valid Job No set.
-  updateDiamondTotals();
-  updateGoldTotalWeight();
+  applyDiamondTotals(snapshot->diamondTotals);
+  applyGoldTotals(snapshot->goldTotals);
+}
+
+void JobSheetWidget::refreshProductImage() {
+  if (productImagePath.isEmpty())
+    return;
+  ImageService::instance().loadInto(ui->productImageLabel, productImagePath);
 }
 
 void JobSheetWidget::loadImageForDesignNo() {
@@ -293,15 +344,14 @@ void JobSheetWidget::loadImageForDesignNo() {
 
   QString fullPath =
       QDir::cleanPath(QCoreApplication::applicationDirPath() + "/" + imagePath);
-  QPixmap pixmap(fullPath);
 
-  if (!pixmap.isNull()) {
-    ui->productImageLabel->setPixmap(
-        pixmap.scaled(ui->productImageLabel->size(), Qt::KeepAspectRatio,
-                      Qt::SmoothTransformation));
+  if (QFileInfo::exists(fullPath)) {
+    productImagePath = fullPath;
+    refreshProductImage();
   } else {
     QMessageBox::warning(this, "Image Error",
                          "Image not found at path:\n" + fullPath);
+    productImagePath.clear();
     ui->productImageLabel->clear();
     return;
   }
@@ -368,8 +418,10 @@ void JobSheetWidget::set_value_designer() {
 
     // Make it read-only but still scrollable and interactive
     table->setFocusPolicy(Qt::NoFocus);
-    table->setStyleSheet(
-        "QTableWidget { background-color: #f0f0f0; }"); // optional visual cue
+    QPalette pal = table->palette(); // read-only visual cue
+    pal.setColor(QPalette::Base, QColor("#f0f0f0"));
+    pal.setColor(QPalette::Text, QColor("#2B2B2B"));
+    table->setPalette(pal);
   }
 
   QList<QLabel *> labels = findChildren<QLabel *>();
@@ -526,8 +578,10 @@ void JobSheetWidget::updateGoldTotalWeight() {
     return;
 
   // ✅ Use DatabaseUtils
-  auto totals = DatabaseUtils::fetchGoldTotals(jobNo);
+  applyGoldTotals(DatabaseUtils::fetchGoldTotals(jobNo));
+}
 
+void JobSheetWidget::applyGoldTotals(const GoldTotals &totals) {
   // --- Helper: product weight ---
   auto getProductWeight = [](const QString &returnJson) -> double {
     if (returnJson.isEmpty())
@@ -739,9 +793,11 @@ void JobSheetWidget::updateDiamondTotals() {
     return;
 
   // ✅ Use DatabaseUtils to fetch totals
+  applyDiamondTotals(DatabaseUtils::fetchDiamondTotals(jobNo));
+}
 
-  auto totalsMap = DatabaseUtils::fetchDiamondTotals(jobNo);
-
+void JobSheetWidget::applyDiamondTotals(
+    const QMap<QString, QPair<int, double>> &totalsMap) {
   // ✅ List of all columns with mapping to row & col
   struct Entry {
     QString col;
@@ -771,7 +827,7 @@ void JobSheetWidget::updateDiamondTotals() {
     if (!totalsMap.contains(e.col))
       continue;
 
-    auto [pcs, wt] = totalsMap[e.col];
+    auto [pcs, wt] = totalsMap.value(e.col);
 
     QTableWidgetItem *pcsItem =
         ui->diamondAndStoneDetailTableWidget->item(e.row, e.pcsCol);
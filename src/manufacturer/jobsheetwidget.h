@@ -4,6 +4,7 @@
 #include <QTableWidgetItem>
 #include <QWidget>
 
+#include "database/databaseutils.h"
 #include "diamonissueretbrodialog.h"
 #include "managegolddialog.h"
 
@@ -11,6 +12,8 @@ namespace Ui {
 class JobSheetWidget;
 }
 
+class QTimer;
+
 class JobSheetWidget : public QWidget {
   Q_OBJECT
 
@@ -21,6 +24,13 @@ public:
   void set_value(const QString &jobNo);
   void setUserRole(const QString &role);
 
+  int jobId() const;
+  QString role() const { return userRole; }
+
+  // Drop everything bound to the current job so JobSheetRegistry can hand
+  // this sheet to another job of the same role without rebuilding it.
+  void resetForReuse();
+
 protected:
   void keyPressEvent(QKeyEvent *event) override;
   void resizeEvent(QResizeEvent *event) override;
@@ -37,7 +47,9 @@ private:
   int finalHeight = 0;
   double scaleFactor = 1.0; // 🔹 scaling factor based on resolution
 
-  QPixmap originalPixmap;
+  // Decoded on demand at label size by ImageService
+  QString productImagePath;
+  QTimer *imageResizeTimer = nullptr;
 
   ManageGoldDialog *newManageGold = nullptr;
   bool manageGold = false;
@@ -47,6 +59,7 @@ private:
 
   void addTableRow(QTableWidget *table);
   void loadImageForDesignNo();
+  void refreshProductImage();
   void saveDesignNoAndImagePath(const QString &designNo,
                                 const QString &imagePath);
 
@@ -54,9 +67,11 @@ private:
   void set_value_manuf();
 
   void updateGoldTotalWeight();
+  void applyGoldTotals(const GoldTotals &totals);
   void handleCellSave(int row, int col);
 
   void updateDiamondTotals();
+  void applyDiamondTotals(const QMap<QString, QPair<int, double>> &totalsMap);
   void setupDiamondIssueClicks();
 };
 
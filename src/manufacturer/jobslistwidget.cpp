@@ -1,24 +1,119 @@
 #include "jobslistwidget.h"
+#include "common/dates.h"
+#include "common/fixedpoint.h"
+#include "common/ledgerformulas.h"
+#include "common/listsnapshot.h"
+#include "common/tablediff.h"
 #include "database/databaseutils.h"
+#include "database/jobsheetcache.h"
 #include "ui_jobslist.h"
 
+#include <QCloseEvent>
+#include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QHBoxLayout>
+#include <QHash>
 #include <QHeaderView>
+#include <QLocale>
 #include <QMdiArea>
 #include <QMdiSubWindow>
+#include <QPointer>
 #include <QPushButton>
+#include <QThreadPool>
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <iterator>
 
 #include "dashboards/manufacturerwindow.h"
-#include "jobsheetwidget.h"
+#include "jobsheetregistry.h"
+
+namespace {
+const auto kEditTriggers =
+    QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed;
+
+// Columns filled from the "jobs" ledger formulas
+const struct {
+  int col;
+  const char *name;
+} kFormulaColumns[] = {
+    {24, "net_wt"},       {26, "gross_loss"}, {27, "fine_loss"},
+    {28, "loss_percent"}, {29, "dia_loss"},   {30, "stone_loss"},
+};
+
+// Loss filter: all jobs, or the jobs with the highest gross loss or loss
+// percentage, at most this many
+enum LossFilter { AllJobs, HighestGrossLoss, HighestLossPercent };
+enum LossPeriod { AnyDueDate, DueThisMonth };
+constexpr int kLossFilterLimit = 100;
+
+// Columns with a total
+const QList<int> kSumCols = {3,  8,  9,  10, 11, 12, 13, 16, 17, 18,
+                             19, 20, 21, 22, 23, 24, 26, 27, 29, 30};
+
+// Exact total of a column as shown: every cell is read as a 3-decimal
+// fixed-point number, so totals do not drift like a sum of doubles
+Milligrams columnSum(const QTableWidget *table, int col, int rows) {
+  QVarLengthArray<qint64, 1024> raw(rows);
+  for (int r = 0; r < rows; r++) {
+    const QTableWidgetItem *it = table->item(r, col);
+    raw[r] = it ? Milligrams::parse(it->text()).raw() : 0;
+  }
+  return Milligrams::fromRaw(FixedPoint::sum(raw.data(), rows));
+}
+
+QString totalText(int col, Milligrams sum) {
+  // Pcs columns are whole numbers
+  const bool isInt =
+      (col == 3 || col == 10 || col == 12 || col == 17 || col == 19);
+  return isInt ? QString::number(sum.raw() / Milligrams::kScale)
+               : sum.toString();
+}
+} // namespace
 
 JobsListWidget::JobsListWidget(QWidget *parent)
     : QWidget(parent), ui(new Ui::JobsListWidget) {
   ui->setupUi(this);
+
+  m_writes = new WriteBehindQueue(ui->tableWidget, this);
+  connect(m_writes, &WriteBehindQueue::stateChanged, this,
+          &JobsListWidget::onWriteStateChanged);
+
   setupTable();
-  loadData();
+
+  // Paint the list as it was last time, then bring it up to date off the
+  // GUI thread. First run for this user and role: load the usual way.
+  QElapsedTimer paintTimer;
+  paintTimer.start();
+  QList<JobListData> snapshot;
+  QDateTime savedAt;
+  if (ListSnapshot::load(ListSnapshot::pathFor("jobs"), snapshot, &savedAt)) {
+    showRows(snapshot);
+    setStale(true, savedAt);
+    qInfo() << "[perf] Jobs list painted from snapshot in"
+            << paintTimer.elapsed() << "ms," << snapshot.size() << "rows";
+    refreshInBackground();
+  } else {
+    loadData();
+  }
+
+  JobSheetRegistry::instance().warmUp("manufacturer");
 }
 
-JobsListWidget::~JobsListWidget() { delete ui; }
+JobsListWidget::~JobsListWidget() {
+  delete m_writes; // flushes while the grid still exists
+  delete ui;
+}
+
+void JobsListWidget::closeEvent(QCloseEvent *event) {
+  // Receive edits that keep failing get a retry before the grid goes
+  if (!m_writes->confirmClose(this)) {
+    event->ignore();
+    return;
+  }
+  QWidget::closeEvent(event);
+}
 
 void JobsListWidget::setupTable() {
   QStringList headers = {"Delivery\nDate",
@@ -68,92 +163,275 @@ void JobsListWidget::setupTable() {
   ui->tableWidget->setAlternatingRowColors(true);
   ui->tableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
   // Enable editing triggers
-  ui->tableWidget->setEditTriggers(QAbstractItemView::DoubleClicked |
-                                   QAbstractItemView::EditKeyPressed);
+  ui->tableWidget->setEditTriggers(kEditTriggers);
 
   connect(ui->tableWidget, &QTableWidget::cellChanged, this,
           &JobsListWidget::onCellChanged);
+
+  // Warm the job sheet cache for whatever row the user is heading towards
+  JobSheetCache::instance().prefetchFollowing(ui->tableWidget, 2); // Job No
+
+  setupLossFilter();
+}
+
+void JobsListWidget::setupLossFilter() {
+  m_lossFilter = new QComboBox(this);
+  m_lossFilter->addItems(
+      {"All jobs", "Highest gross loss", "Highest loss percentage"});
+
+  m_lossMinimum = new QDoubleSpinBox(this);
+  m_lossMinimum->setDecimals(3);
+  m_lossMinimum->setRange(-1000000.0, 1000000.0);
+  m_lossMinimum->setValue(0.0);
+  m_lossMinimum->setEnabled(false);
+
+  m_lossPeriod = new QComboBox(this);
+  m_lossPeriod->addItems({"Any due date", "Due this month"});
+
+  auto *bar = new QHBoxLayout;
+  bar->addWidget(new QLabel("Show", this));
+  bar->addWidget(m_lossFilter);
+  bar->addWidget(new QLabel("at least", this));
+  bar->addWidget(m_lossMinimum);
+  bar->addWidget(m_lossPeriod);
+  bar->addStretch();
+  ui->gridLayout->addLayout(bar, 2, 0);
+
+  connect(m_lossFilter, &QComboBox::currentIndexChanged, this, [this](int i) {
+    m_lossMinimum->setEnabled(i != AllJobs);
+    m_lossMinimum->setSuffix(i == HighestLossPercent ? " %" : QString());
+    showFiltered();
+  });
+  // Each change is a query; run it once the number is entered, not per
+  // keystroke
+  connect(m_lossMinimum, &QDoubleSpinBox::editingFinished, this,
+          &JobsListWidget::showFiltered);
+  connect(m_lossPeriod, &QComboBox::currentIndexChanged, this,
+          &JobsListWidget::showFiltered);
+}
+
+Dates::Range JobsListWidget::lossPeriod() const {
+  if (m_lossPeriod->currentIndex() != DueThisMonth)
+    return {};
+  const QDate today = QDate::currentDate();
+  return Dates::monthOf(today.year(), today.month());
 }
 
 void JobsListWidget::loadData() {
-  ui->tableWidget->setRowCount(0);
-  QList<JobListData> list = DatabaseUtils::getJobsList();
+  // Queued receive weights would be overwritten by the reload
+  m_writes->flush();
 
-  // Block signals to prevent onCellChanged from firing during population
-  const bool wasBlocked = ui->tableWidget->blockSignals(true);
+  const QList<JobListData> list = DatabaseUtils::getJobsList();
+  showRows(list);
+
+  const QString path = ListSnapshot::pathFor("jobs");
+  QThreadPool::globalInstance()->start(
+      [path, list]() { ListSnapshot::save(path, list); });
+}
+
+void JobsListWidget::refreshInBackground() {
+  const QString path = ListSnapshot::pathFor("jobs");
+  QPointer<JobsListWidget> self(this);
+
+  QThreadPool::globalInstance()->start([self, path]() {
+    const QList<JobListData> list = DatabaseUtils::getJobsList();
+    ListSnapshot::save(path, list);
+
+    QMetaObject::invokeMethod(
+        qApp,
+        [self, list]() {
+          if (!self)
+            return; // window closed while the query ran
+          self->showRows(list);
+          self->setStale(false);
+        },
+        Qt::QueuedConnection);
+  });
+}
+
+void JobsListWidget::showRows(const QList<JobListData> &list) {
+  // Rows come with their losses computed; these are for edits in the grid
+  m_formulas = LedgerFormulas::forLedger("jobs");
+  m_allRows = list;
+  showFiltered();
+}
+
+QList<JobListData> JobsListWidget::lossFiltered() const {
+  const Dates::Range due = lossPeriod();
+  auto isDue = [&due](const JobListData &d) {
+    if (!due.isValid())
+      return true;
+    const QDate date = Dates::parse(d.deliveryDate).date();
+    return date >= due.from && date < due.to;
+  };
+
+  const int mode = m_lossFilter->currentIndex();
+  if (mode == AllJobs) {
+    if (!due.isValid())
+      return m_allRows;
+    QList<JobListData> list;
+    std::copy_if(m_allRows.cbegin(), m_allRows.cend(),
+                 std::back_inserter(list), isDue);
+    return list;
+  }
 
-  for (const JobListData &d : list) {
-    int row = ui->tableWidget->rowCount();
-    ui->tableWidget->insertRow(row);
+  const bool byPercent = mode == HighestLossPercent;
+  const double minimum = m_lossMinimum->value();
+  QList<JobListData> list;
+
+  // job_totals keeps the default formulas' values, indexed: while the shop
+  // has not overridden them, SQL picks the jobs
+  if (LedgerFormulas::isDefault(m_formulas, "jobs",
+                                {"net_wt", "gross_loss", "loss_percent"})) {
+    // Queued receive edits would otherwise rank on the old totals
+    m_writes->flush();
+
+    QHash<int, int> rowOf;
+    for (int i = 0; i < m_allRows.size(); ++i)
+      rowOf.insert(m_allRows.at(i).jobId, i);
+
+    const QList<JobTotalsRow> top = DatabaseUtils::getJobsByTotal(
+        byPercent ? "loss_pct" : "gross_loss", kLossFilterLimit, due, minimum);
+    for (const JobTotalsRow &t : top) {
+      auto it = rowOf.constFind(t.jobId);
+      if (it != rowOf.cend())
+        list << m_allRows.at(*it);
+    }
+    return list;
+  }
+
+  // Overridden: the losses on the rows are the shop's, SQL's are not
+  auto loss = [byPercent](const JobListData &d) {
+    return byPercent ? d.percentage : d.grossLoss;
+  };
+  for (const JobListData &d : m_allRows) {
+    if (loss(d) >= minimum && isDue(d))
+      list << d;
+  }
+  std::stable_sort(list.begin(), list.end(),
+                   [&](const JobListData &a, const JobListData &b) {
+                     return loss(a) > loss(b);
+                   });
+  if (list.size() > kLossFilterLimit)
+    list.resize(kLossFilterLimit);
+  return list;
+}
+
+void JobsListWidget::showFiltered() {
+  const QList<JobListData> list = lossFiltered();
+
+  // Only rows that came, went or changed touch the grid; the rest keep
+  // their items, so scroll position, selection and an open editor survive
+  const TableDiff::Stats stats = TableDiff::apply(
+      ui->tableWidget, m_rows, list,
+      [this](int row, const JobListData &d) { renderRow(row, d); });
+  m_rows = list;
+
+  qInfo().noquote() << QString("[perf] Jobs list refresh: %1 rows, %2 added, "
+                               "%3 removed, %4 changed%5")
+                           .arg(list.size())
+                           .arg(stats.inserted)
+                           .arg(stats.removed)
+                           .arg(stats.changed)
+                           .arg(stats.rebuilt ? " (rebuilt)" : "");
+
+  const bool wasBlocked = ui->tableWidget->blockSignals(true);
+  calculateTotals();
+  ui->tableWidget->blockSignals(wasBlocked);
+}
 
-    int col = 0;
+void JobsListWidget::renderRow(int row, const JobListData &d) {
+  auto *table = ui->tableWidget;
+  int col = 0;
 
-    auto setItem = [&](const QString &text, bool editable = false,
-                       int jobId = -1) {
-      QTableWidgetItem *item = new QTableWidgetItem(text);
+  auto setItem = [&](const QString &text, bool editable = false,
+                     int jobId = -1) {
+    QTableWidgetItem *item = table->item(row, col);
+    if (!item) {
+      item = new QTableWidgetItem;
       item->setTextAlignment(Qt::AlignCenter);
-      if (!editable) {
-        item->setFlags(item->flags() & ~Qt::ItemIsEditable);
-      } else {
-        item->setFlags(item->flags() | Qt::ItemIsEditable);
-        if (jobId != -1) {
-          item->setData(Qt::UserRole, jobId);
-        }
-      }
-      ui->tableWidget->setItem(row, col++, item);
-    };
-
-    auto setNum = [&](double val, int prec = 3, bool editable = false,
-                      int jobId = -1) {
-      setItem(QString::number(val, 'f', prec), editable, jobId);
-    };
-
-    auto setInt = [&](int val) { setItem(QString::number(val)); };
-
-    setItem(d.deliveryDate);
-    setItem(d.designNo);
-    setItem(d.jobNo);
-    setInt(d.pcs);
-    setItem(d.metal);
-    setItem(d.purity);
-    setItem(d.status);
-    setItem(d.mfgIssueDate);
-    setNum(d.issueWt);
-    setNum(d.materialIssueWt);
-    setInt(d.issueDiaPcs);
-    setNum(d.issueDiaWt);
-    setInt(d.issueStonePcs);
-    setNum(d.issueStoneWt);
-    setItem(d.issueDiaCategory);
-
-    setItem(d.receiveDate);
-    setNum(d.grossWt);
-    setInt(d.receiveDiaPcs);
-    setNum(d.receiveDiaWt);
-    setInt(d.receiveStonePcs);
-    setNum(d.receiveStoneWt);
-    setNum(d.officeGoldReceive, 3, true, d.jobId);      // Col 21 Editable
-    setNum(d.officeReceive, 3, true, d.jobId);          // Col 22 Editable
-    setNum(d.manufacturerMfgReceive, 3, true, d.jobId); // Col 23 Editable
-    setNum(d.netWt);
-    setItem(d.purity);
-    setNum(d.grossLoss);
-    setNum(d.fineLoss);
-    setItem(QString::number(d.percentage, 'f', 2) + "%");
-    setNum(d.diaLoss);
-    setNum(d.stoneLoss);
-    setItem(d.remark);
-
-    // Action
-    QPushButton *btn = new QPushButton("Open");
-    btn->setProperty("jobId", d.dbJobId);
+      table->setItem(row, col, item);
+    }
+    ++col;
+
+    if (item->text() != text)
+      item->setText(text);
+    const Qt::ItemFlags flags = editable
+                                    ? item->flags() | Qt::ItemIsEditable
+                                    : item->flags() & ~Qt::ItemIsEditable;
+    if (item->flags() != flags)
+      item->setFlags(flags);
+    if (editable && jobId != -1)
+      item->setData(Qt::UserRole, jobId);
+  };
+
+  auto setNum = [&](double val, int prec = 3, bool editable = false,
+                    int jobId = -1) {
+    setItem(QString::number(val, 'f', prec), editable, jobId);
+  };
+
+  auto setInt = [&](int val) { setItem(QString::number(val)); };
+
+  setItem(d.deliveryDate);
+  table->item(row, 0)->setData(TableDiff::kKeyRole, d.jobId);
+  setItem(d.designNo);
+  setItem(d.jobNo);
+  setInt(d.pcs);
+  setItem(d.metal);
+  setItem(d.purity);
+  setItem(d.status);
+  setItem(d.mfgIssueDate);
+  setNum(d.issueWt);
+  setNum(d.materialIssueWt);
+  setInt(d.issueDiaPcs);
+  setNum(d.issueDiaWt);
+  setInt(d.issueStonePcs);
+  setNum(d.issueStoneWt);
+  setItem(d.issueDiaCategory);
+
+  setItem(d.receiveDate);
+  setNum(d.grossWt);
+  setInt(d.receiveDiaPcs);
+  setNum(d.receiveDiaWt);
+  setInt(d.receiveStonePcs);
+  setNum(d.receiveStoneWt);
+  setNum(d.officeGoldReceive, 3, true, d.jobId);      // Col 21 Editable
+  setNum(d.officeReceive, 3, true, d.jobId);          // Col 22 Editable
+  setNum(d.manufacturerMfgReceive, 3, true, d.jobId); // Col 23 Editable
+  setNum(d.netWt);
+  setItem(d.purity);
+  setNum(d.grossLoss);
+  setNum(d.fineLoss);
+  setItem(QString::number(d.percentage, 'f', 2) + "%");
+  setNum(d.diaLoss);
+  setNum(d.stoneLoss);
+  setItem(d.remark);
+
+  // Action
+  auto *btn = qobject_cast<QPushButton *>(table->cellWidget(row, col));
+  if (!btn) {
+    btn = new QPushButton("Open");
     connect(btn, &QPushButton::clicked, this,
             &JobsListWidget::onOpenJobClicked);
-    ui->tableWidget->setCellWidget(row, col++, btn);
+    table->setCellWidget(row, col, btn);
   }
+  btn->setProperty("jobId", d.dbJobId);
+}
 
-  ui->tableWidget->blockSignals(wasBlocked);
-  calculateTotals();
+void JobsListWidget::setStale(bool stale, const QDateTime &savedAt) {
+  if (!m_staleLabel) {
+    m_staleLabel = new QLabel(this);
+    ui->gridLayout->addWidget(m_staleLabel, 1, 0);
+  }
+  m_staleLabel->setText(
+      QString("Showing the list as of %1, refreshing...")
+          .arg(QLocale().toString(savedAt, QLocale::ShortFormat)));
+  m_staleLabel->setVisible(stale);
+
+  // No edits on rows that may already be out of date
+  ui->tableWidget->setEditTriggers(
+      stale ? QAbstractItemView::EditTriggers(QAbstractItemView::NoEditTriggers)
+            : kEditTriggers);
 }
 
 void JobsListWidget::calculateTotals() {
@@ -172,34 +450,9 @@ void JobsListWidget::calculateTotals() {
   label->setFlags(label->flags() & ~Qt::ItemIsEditable);
   ui->tableWidget->setItem(rowCount, 0, label);
 
-  // Columns to sum
-  QList<int> sumCols = {3,  8,  9,  10, 11, 12, 13, 16, 17, 18,
-                        19, 20, 21, 22, 23, 24, 26, 27, 29, 30};
-
-  for (int col : sumCols) {
-    double sum = 0.0;
-    bool isInt = true; // Assumption, check based on col index if needed or just
-                       // sum as double
-
-    // Check if integer column
-    if (col == 3 || col == 10 || col == 12 || col == 17 || col == 19)
-      isInt = true;
-    else
-      isInt = false;
-
-    for (int r = 0; r < rowCount; r++) {
-      QTableWidgetItem *it = ui->tableWidget->item(r, col);
-      if (it) {
-        sum += it->text().toDouble();
-      }
-    }
-
-    QTableWidgetItem *totalItem = new QTableWidgetItem();
-    if (isInt) {
-      totalItem->setText(QString::number((int)sum));
-    } else {
-      totalItem->setText(QString::number(sum, 'f', 3));
-    }
+  for (int col : kSumCols) {
+    QTableWidgetItem *totalItem = new QTableWidgetItem(
+        totalText(col, columnSum(ui->tableWidget, col, rowCount)));
 
     totalItem->setTextAlignment(Qt::AlignCenter);
     totalItem->setFont(font);
@@ -245,64 +498,121 @@ void JobsListWidget::onOpenJobClicked() {
   if (!mdiArea)
     return;
 
-  // Check if already open? (Optional)
-
-  JobSheetWidget *jobSheet = new JobSheetWidget;
-  jobSheet->setUserRole("manufacturer");
-  jobSheet->set_value(QString::number(jobId));
-
-  QMdiSubWindow *sub = mdiArea->addSubWindow(jobSheet);
-  sub->setWindowTitle("JobSheet - " + QString::number(jobId));
-  sub->setAttribute(Qt::WA_DeleteOnClose);
-  jobSheet->show();
+  // Focuses the sheet if this job is already open, else reuses a pooled one
+  JobSheetRegistry::instance().open(mdiArea, jobId, "manufacturer",
+                                    "JobSheet - " + QString::number(jobId));
 }
 
+namespace {
+// Editable receive columns and the jobsheet_detail field behind each. The
+// field is also the name of the input in the "jobs" ledger formulas.
+struct ReceiveColumn {
+  int col;
+  const char *field;
+  bool (*update)(int jobId, double weight);
+  double JobListData::*member;
+};
+
+const ReceiveColumn kReceiveColumns[] = {
+    {21, "office_gold_receive", &DatabaseUtils::updateOfficeGoldReceive,
+     &JobListData::officeGoldReceive},
+    {22, "office_receive", &DatabaseUtils::updateOfficeReceive,
+     &JobListData::officeReceive},
+    {23, "manufacturer_mfg_receive",
+     &DatabaseUtils::updateManufacturerMfgReceive,
+     &JobListData::manufacturerMfgReceive},
+};
+} // namespace
+
 void JobsListWidget::onCellChanged(int row, int col) {
-  // Office Gold Rec is index 21
-  if (col == 21) {
-    QTableWidgetItem *item = ui->tableWidget->item(row, col);
-    if (!item)
-      return;
-
-    int jobId = item->data(Qt::UserRole).toInt();
-    if (jobId <= 0)
-      return; // Should not happen if set correctly
-
-    bool ok = false;
-    double val = item->text().toDouble(&ok);
-    if (ok) {
-      DatabaseUtils::updateOfficeGoldReceive(jobId, val);
-      qDebug() << "Updated Office Gold Rec for Job" << jobId << "to" << val;
-    }
-  } else if (col == 22) {
-    QTableWidgetItem *item = ui->tableWidget->item(row, col);
-    if (!item)
-      return;
-
-    int jobId = item->data(Qt::UserRole).toInt();
-    if (jobId <= 0)
-      return;
-
-    bool ok = false;
-    double val = item->text().toDouble(&ok);
-    if (ok) {
-      DatabaseUtils::updateOfficeReceive(jobId, val);
-      qDebug() << "Updated Office Receive for Job" << jobId << "to" << val;
+  const ReceiveColumn *rc = nullptr;
+  for (const ReceiveColumn &c : kReceiveColumns) {
+    if (c.col == col)
+      rc = &c;
+  }
+  if (!rc)
+    return;
+
+  QTableWidgetItem *item = ui->tableWidget->item(row, col);
+  if (!item)
+    return;
+
+  int jobId = item->data(Qt::UserRole).toInt();
+  if (jobId <= 0)
+    return; // Should not happen if set correctly
+
+  bool ok = false;
+  double val = item->text().toDouble(&ok);
+  if (!ok)
+    return;
+
+  // Written with the other queued edits once typing pauses
+  auto update = rc->update;
+  m_writes->enqueue(QString::number(jobId), rc->field,
+                    [update, jobId, val]() { return update(jobId, val); });
+
+  // Net weight and losses of this row follow at once
+  if (row >= m_rows.size())
+    return;
+  JobListData &d = m_rows[row];
+
+  QVector<double> values(m_formulas.slotCount());
+  LedgerFormulas::fill(d, values.data());
+  m_formulas.evaluate(values.data());
+
+  const int slot = m_formulas.slotOf(QLatin1String(rc->field));
+  values[slot] = val;
+  const QList<int> changed = m_formulas.update(values.data(), slot);
+
+  // A refresh that brings the same values back leaves the row alone
+  d.*rc->member = val;
+  LedgerFormulas::store(m_formulas, values.data(), d);
+  for (JobListData &loaded : m_allRows) {
+    if (loaded.jobId == d.jobId) {
+      loaded = d;
+      break;
     }
-  } else if (col == 23) {
-    QTableWidgetItem *item = ui->tableWidget->item(row, col);
-    if (!item)
-      return;
-
-    int jobId = item->data(Qt::UserRole).toInt();
-    if (jobId <= 0)
-      return;
-
-    bool ok = false;
-    double val = item->text().toDouble(&ok);
-    if (ok) {
-      DatabaseUtils::updateManufacturerMfgReceive(jobId, val);
-      qDebug() << "Updated Mfg Receive for Job" << jobId << "to" << val;
+  }
+
+  QList<int> cols = {col};
+  for (const auto &c : kFormulaColumns) {
+    if (changed.contains(m_formulas.slotOf(QLatin1String(c.name))))
+      cols << c.col;
+  }
+
+  const bool wasBlocked = ui->tableWidget->blockSignals(true);
+  renderRow(row, d); // only the cells whose text changed are touched
+  updateTotals(cols);
+  ui->tableWidget->blockSignals(wasBlocked);
+}
+
+void JobsListWidget::updateTotals(const QList<int> &cols) {
+  const int totalRow = m_rows.size();
+  if (totalRow >= ui->tableWidget->rowCount())
+    return; // no totals row
+
+  for (int col : cols) {
+    if (!kSumCols.contains(col))
+      continue;
+    if (QTableWidgetItem *total = ui->tableWidget->item(totalRow, col))
+      total->setText(
+          totalText(col, columnSum(ui->tableWidget, col, totalRow)));
+  }
+}
+
+void JobsListWidget::onWriteStateChanged(const QString &row,
+                                         const QString &field,
+                                         WriteBehindQueue::State state) {
+  const int jobId = row.toInt();
+  for (const ReceiveColumn &c : kReceiveColumns) {
+    if (field != QLatin1String(c.field))
+      continue;
+    for (int r = 0; r < ui->tableWidget->rowCount(); ++r) {
+      QTableWidgetItem *item = ui->tableWidget->item(r, c.col);
+      if (item && item->data(Qt::UserRole).toInt() == jobId) {
+        WriteBehindQueue::decorate(item, state);
+        return;
+      }
     }
   }
 }
@@ -1,8 +1,17 @@
 #ifndef JOBSLISTWIDGET_H
 #define JOBSLISTWIDGET_H
 
+#include <QComboBox>
+#include <QDateTime>
+#include <QDoubleSpinBox>
+#include <QLabel>
 #include <QWidget>
 
+#include "common/dates.h"
+#include "common/formulaset.h"
+#include "common/writebehindqueue.h"
+#include "database/databaseutils.h"
+
 namespace Ui {
 class JobsListWidget;
 }
@@ -14,15 +23,37 @@ public:
   explicit JobsListWidget(QWidget *parent = nullptr);
   ~JobsListWidget();
 
+protected:
+  void closeEvent(QCloseEvent *event) override;
+
 private:
   Ui::JobsListWidget *ui;
+  WriteBehindQueue *m_writes = nullptr; // receive-weight edits
+  QLabel *m_staleLabel = nullptr;       // shown while a snapshot is on screen
+  QList<JobListData> m_rows;            // rows on screen, above the totals
+  QList<JobListData> m_allRows;         // as loaded, before the loss filter
+  FormulaSet m_formulas;                // "jobs" ledger, for receive edits
+  QComboBox *m_lossFilter = nullptr;    // all jobs / highest gross loss / %
+  QDoubleSpinBox *m_lossMinimum = nullptr;
+  QComboBox *m_lossPeriod = nullptr;    // any due date / due this month
   void setupTable();
+  void setupLossFilter();
   void loadData();
+  void refreshInBackground();
+  void showRows(const QList<JobListData> &list);
+  void showFiltered();
+  QList<JobListData> lossFiltered() const;
+  Dates::Range lossPeriod() const;
+  void renderRow(int row, const JobListData &d);
+  void setStale(bool stale, const QDateTime &savedAt = QDateTime());
   void calculateTotals();
+  void updateTotals(const QList<int> &cols);
 
 private slots:
   void onOpenJobClicked();
   void onCellChanged(int row, int col);
+  void onWriteStateChanged(const QString &row, const QString &field,
+                           WriteBehindQueue::State state);
 };
 
 #endif // JOBSLISTWIDGET_H
@@ -1,6 +1,7 @@
 #include "managegolddialog.h"
 #include "ui_managegold.h"
 
+#include "common/dates.h"
 #include "database/databaseutils.h"
 #include <QDateTime>
 #include <QDir>
@@ -20,7 +21,10 @@ ManageGoldDialog::ManageGoldDialog(QWidget *parent)
   ui->stackedWidget->setCurrentIndex(0);
   // ui->typeComboBox->addItems({"gold", "solder"});
 
-  setStyleSheet("QDialog { background-color: #84bbe8; }");
+  QPalette pal = palette();
+  pal.setColor(QPalette::Window, QColor("#84bbe8"));
+  setPalette(pal);
+  setAutoFillBackground(true);
 
   QDoubleValidator *validator = new QDoubleValidator(0.0, 999999.999, 3, this);
   validator->setNotation(QDoubleValidator::StandardNotation);
@@ -94,8 +98,7 @@ void ManageGoldDialog::on_issueAddPushButton_clicked() {
   }
 
   QString type = ui->typeComboBox->currentText().trimmed();
-  QString dateTime =
-      QDateTime::currentDateTime().toString("dd-MM-yyyy HH:mm:ss");
+  QString dateTime = Dates::toStored(QDateTime::currentDateTime());
 
   // Build JSON object
   QJsonObject newEntry;
@@ -124,8 +127,19 @@ void ManageGoldDialog::on_issueAddPushButton_clicked() {
   else
     columnName = "filling_dust"; // ✅ new column
 
-  if (DatabaseUtils::addJobSheetHistoryEntry(jobNo, columnName, newEntry)) {
-    QMessageBox::information(this, "Success", "Data saved successfully.");
+  int version = historyVersion;
+  bool conflict = false;
+  if (DatabaseUtils::addJobSheetHistoryEntry(jobNo, columnName, newEntry,
+                                             &version, &conflict)) {
+    // The job changed after the table was loaded; their entries are kept
+    // and show up on reload
+    if (conflict)
+      QMessageBox::information(
+          this, "Success",
+          "Data saved. Another user updated this job at the same time; "
+          "both entries were kept.");
+    else
+      QMessageBox::information(this, "Success", "Data saved successfully.");
     loadHistory();
   } else {
     QMessageBox::critical(this, "Update Error",
@@ -159,7 +173,8 @@ void ManageGoldDialog::loadHistory() {
       {"Type", "Weight", "Date Time"});
 
   if (!jobNo.isEmpty()) {
-    QJsonArray arr = DatabaseUtils::fetchJobSheetHistory(jobNo, columnName);
+    QJsonArray arr =
+        DatabaseUtils::fetchJobSheetHistory(jobNo, columnName, &historyVersion);
 
     // Update table
     ui->fillingIssueTableWidget->setRowCount(arr.size());
@@ -169,8 +184,14 @@ void ManageGoldDialog::loadHistory() {
           i, 0, new QTableWidgetItem(obj["type"].toString()));
       ui->fillingIssueTableWidget->setItem(
           i, 1, new QTableWidgetItem(obj["weight"].toString()));
+      // Stored as ISO, shown day first
+      const QString stamp = obj["date_time"].toString();
+      const QDateTime when = Dates::parse(stamp);
       ui->fillingIssueTableWidget->setItem(
-          i, 2, new QTableWidgetItem(obj["date_time"].toString()));
+          i, 2,
+          new QTableWidgetItem(when.isValid()
+                                   ? when.toString("dd-MM-yyyy HH:mm:ss")
+                                   : stamp));
       totalWeight += obj["weight"].toString().toDouble();
     }
   }
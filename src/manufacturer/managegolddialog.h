@@ -41,6 +41,8 @@ private:
 
     void hideEvent(QHideEvent *event);
     void loadHistory();  // renamed generic version
+
+    int historyVersion = -1;  // jobsheet_detail.row_version behind the table
 };
 
 #endif // MANAGEGOLDDIALOG_H
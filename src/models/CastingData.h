@@ -34,6 +34,7 @@ struct CastingData
     int accountantId = 0;
     QString status;          // OPEN / RECEIVED / CLOSED
     QString createdAt;
+    int rowVersion = 0;      // casting_entry.row_version when read
 };
 
 #endif // CASTINGDATA_H
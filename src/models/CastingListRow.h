@@ -14,6 +14,7 @@ struct CastingListRow
 
     QString issueMetal;
     QString purity;
+    double fineness = 0;   // purity in parts per thousand, parsed when written
     double issueMetalWt = 0;
     int issueDiaPcs = 0;
     double issueDiaWt = 0;
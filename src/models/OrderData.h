@@ -98,6 +98,7 @@ struct OrderData
 
     // State
     int isSaved = 0;
+    int rowVersion = 0;   // order_book_detail.row_version when read
 
     // 🔑 Workflow status
     QString designerStatus = "Pending";   // Pending / Started / Completed
@@ -0,0 +1,29 @@
+#ifndef ORDERLISTROW_H
+#define ORDERLISTROW_H
+
+#include <QString>
+
+// One line of the order list: the columns getOrdersForSeller() and
+// getAllOrders() read, not the whole OrderData form
+struct OrderListRow
+{
+    int orderId = 0;
+    int jobId = 0;
+    int sellerOrderSeq = 0;
+    int productPis = 0;
+
+    QString partyName;
+    QString sellerName;
+    QString metalName;
+    QString metalPurity;
+    QString designNo;
+    QString orderDate;
+    QString deliveryDate;
+    QString extraDetail;
+
+    // Designer status is not stored yet, so every order is still open to
+    // its seller, as with OrderData's default
+    bool isEditable() const { return true; }
+};
+
+#endif // ORDERLISTROW_H
@@ -3,7 +3,9 @@
 
 #include "DatabaseUtils.h"
 #include "SessionManager.h"
+#include "database/changenotifier.h"
 
+#include <QCheckBox>
 #include <QMessageBox>
 #include <QPushButton>
 
@@ -14,6 +16,26 @@ OrderListWidget::OrderListWidget(QWidget *parent)
 
   setupTable();
   loadOrders();
+
+  connect(ui->dueThisWeekCheckBox, &QCheckBox::toggled, this,
+          &OrderListWidget::loadOrders);
+
+  // Reload only when an order form saved a column this list shows
+  connect(&ChangeNotifier::instance(), &ChangeNotifier::rowChanged, this,
+          [this](const QString &table, int, const QStringList &columns) {
+            static const QStringList shown = {
+                "partyName",   "productPis", "metalName",
+                "metalPurity", "designNo",   "orderDate",
+                "deliveryDate", "extraDetail"};
+            if (table != "order_book_detail")
+              return;
+            for (const QString &c : columns) {
+              if (shown.contains(c)) {
+                loadOrders();
+                return;
+              }
+            }
+          });
 }
 
 OrderListWidget::~OrderListWidget() { delete ui; }
@@ -43,13 +65,18 @@ void OrderListWidget::setupTable() {
 void OrderListWidget::loadOrders() {
   ui->ordersTableWidget->setRowCount(0);
 
-  QList<OrderData> orders;
+  QList<OrderListRow> orders;
+
+  // Filtered in the query, on the delivery date index
+  const Dates::Range due = ui->dueThisWeekCheckBox->isChecked()
+                               ? Dates::weekOf(QDate::currentDate())
+                               : Dates::Range();
 
   if (SessionManager::isSeller()) {
-    orders =
-        DatabaseUtils::getOrdersForSeller(SessionManager::currentUser().id);
+    orders = DatabaseUtils::getOrdersForSeller(
+        SessionManager::currentUser().id, due);
   } else if (SessionManager::isAdmin()) {
-    orders = DatabaseUtils::getAllOrders();
+    orders = DatabaseUtils::getAllOrders(due);
   }
 
   ui->ordersTableWidget->setRowCount(orders.size());
@@ -109,7 +136,7 @@ void OrderListWidget::calculateTotals() {
   }
 }
 
-void OrderListWidget::addRow(int row, const OrderData &order) {
+void OrderListWidget::addRow(int row, const OrderListRow &order) {
   auto *table = ui->ordersTableWidget;
   // qDebug() << order.orderId << "order added!" << order.jobId;
   // table->setItem(row, 0, new
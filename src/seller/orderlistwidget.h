@@ -1,7 +1,7 @@
 #ifndef ORDERLISTWIDGET_H
 #define ORDERLISTWIDGET_H
 
-#include "OrderData.h"
+#include "OrderListRow.h"
 #include <QTableWidget>
 #include <QWidget>
 
@@ -29,7 +29,7 @@ private:
   Ui::OrderListWidget *ui;
 
   void setupTable();
-  void addRow(int row, const OrderData &order);
+  void addRow(int row, const OrderListRow &order);
   void calculateTotals();
 };
 
@@ -2,7 +2,11 @@
 #include "ui_order.h"
 
 #include "database/DatabaseUtils.h"
+#include "common/dates.h"
 #include "common/sessionmanager.h"
+#include "common/imageservice.h"
+#include "common/imageingest.h"
+#include "database/writetransaction.h"
 #include "models/imageclicklabel.h"
 
 #include <QMessageBox>
@@ -12,6 +16,7 @@
 #include <QFileDialog>
 #include <QMdiSubWindow>
 #include <QPixmap>
+#include <QPushButton>
 
 OrderWidget::OrderWidget(QWidget *parent)
     : QWidget(parent)
@@ -133,8 +138,8 @@ void OrderWidget::fillOrderData(OrderData &order)
     // --------------------
     // Dates
     // --------------------
-    order.orderDate    = QDate::currentDate().toString("yyyy-MM-dd");
-    order.deliveryDate = ui->deliveryDateDateEdit->date().toString("yyyy-MM-dd");
+    order.orderDate    = Dates::toStored(QDate::currentDate());
+    order.deliveryDate = Dates::toStored(ui->deliveryDateDateEdit->date());
 
     // --------------------
     // Product
@@ -247,15 +252,57 @@ void OrderWidget::on_savePushButton_clicked()
     fillOrderData(o);
 
     if (isEditMode) {
-        if (!DatabaseUtils::updateOrder(m_orderId, o)) {
+        o.jobId = m_loaded.jobId;
+        auto result = DatabaseUtils::updateOrderChanges(m_orderId, m_loaded, o);
+
+        if (result == DatabaseUtils::CasResult::Conflict) {
+            QMessageBox box(QMessageBox::Warning, "Order Changed",
+                            "Someone else saved this order after you opened it.\n"
+                            "Reload to see their version, or save your changes "
+                            "on top of it (only the fields you edited are written).",
+                            QMessageBox::Cancel, this);
+            QPushButton *reload = box.addButton("Reload", QMessageBox::RejectRole);
+            QPushButton *mine = box.addButton("Save mine", QMessageBox::AcceptRole);
+            box.exec();
+
+            if (box.clickedButton() == reload) {
+                loadOrder(m_orderId);
+                return;
+            }
+            if (box.clickedButton() != mine)
+                return;
+
+            // Same baseline, newer version: their fields stay unless we edited them too
+            OrderData latest;
+            if (!DatabaseUtils::getOrderById(m_orderId, latest)) {
+                QMessageBox::critical(this, "Error", "Failed to load order");
+                return;
+            }
+            m_loaded.rowVersion = latest.rowVersion;
+            result = DatabaseUtils::updateOrderChanges(m_orderId, m_loaded, o);
+            if (result == DatabaseUtils::CasResult::Conflict) {
+                QMessageBox::warning(this, "Order Changed",
+                                     "The order changed again while saving. "
+                                     "Please reload and try again.");
+                return;
+            }
+        }
+
+        if (result != DatabaseUtils::CasResult::Saved) {
             QMessageBox::critical(this, "Error", "Failed to update order");
             return;
         }
+        m_loaded = o;
         QMessageBox::information(this, "Success", "Order updated successfully");
     } else {
         int jobId = 0, sellerSeq = 0;
         if (!DatabaseUtils::createOrder(o, jobId, sellerSeq)) {
-            QMessageBox::critical(this, "Error", "Failed to create order");
+            if (WriteTransaction::lastFailureWasBusy())
+                QMessageBox::warning(this, "Database Busy",
+                                     "Another workstation is saving right now.\n"
+                                     "Nothing was saved; please try again.");
+            else
+                QMessageBox::critical(this, "Error", "Failed to create order");
             return;
         }
         QMessageBox::information(this, "Success", "Order created successfully");
@@ -398,7 +445,7 @@ void OrderWidget::setupImageUploadHandlers() {
     connect(ui->imageLabel1, &ImageClickLabel::rightClicked, this, [=]() {
         QString path = selectAndSaveImage("image1");
         if (!path.isEmpty()) {
-            ui->imageLabel1->setPixmap(QPixmap(path).scaled(ui->imageLabel1->size(), Qt::KeepAspectRatio));
+            ImageService::instance().loadInto(ui->imageLabel1, path);
             imagePath1 = path;
         }
     });
@@ -406,7 +453,7 @@ void OrderWidget::setupImageUploadHandlers() {
     connect(ui->imageLabel2, &ImageClickLabel::rightClicked, this, [=]() {
         QString path = selectAndSaveImage("image2");
         if (!path.isEmpty()) {
-            ui->imageLabel2->setPixmap(QPixmap(path).scaled(ui->imageLabel2->size(), Qt::KeepAspectRatio));
+            ImageService::instance().loadInto(ui->imageLabel2, path);
             imagePath2 = path;
         }
     });
@@ -421,21 +468,27 @@ QString OrderWidget::selectAndSaveImage(const QString &prefix) {
 
     QDir().mkpath(imageDirPath);  // ensure OrderBookImages/ exists
 
-    QString fileName = prefix + "_" + QFileInfo(filePath).fileName();
-    QString destPath = QDir(imageDirPath).filePath(fileName);
+    QString destBase = QDir(imageDirPath).filePath(prefix + "_" + QFileInfo(filePath).completeBaseName());
 
-    // ✅ If already exists, skip copying
-    if (QFile::exists(destPath)) {
-        qDebug() << "⚠️ Image already exists, using existing file:" << destPath;
-        return destPath;
+    // ✅ If already ingested, skip re-encoding
+    for (const QString &ext : {QStringLiteral("jpg"), QStringLiteral("png")}) {
+        if (QFile::exists(destBase + "." + ext)) {
+            qDebug() << "⚠️ Image already exists, using existing file:" << destBase + "." + ext;
+            return destBase + "." + ext;
+        }
     }
 
-    // Try to copy
-    if (QFile::copy(filePath, destPath)) {
-        qDebug() << "✅ Image copied to:" << destPath;
+    // Orient, downsize and re-encode on a worker thread
+    QString destPath = ImageIngest::runWithProgress(
+        this, "Saving image...", [&](const ImageIngest::ProgressFn &progress) {
+            return ImageIngest::ingest(filePath, destBase, progress);
+        });
+
+    if (!destPath.isEmpty()) {
+        qDebug() << "✅ Image saved to:" << destPath;
         return destPath;
     } else {
-        QMessageBox::warning(this, "Image Copy Failed", "Could not copy image to:\n" + destPath);
+        QMessageBox::warning(this, "Image Save Failed", "Could not save image to:\n" + imageDirPath);
         return "";
     }
 }
@@ -543,7 +596,10 @@ void OrderWidget::loadOrder(int orderId)
 
     imagePath1 = o.image1Path;
     imagePath2 = o.image2Path;
-    // refreshImagePreview(); // if you have preview logic
+    if (!imagePath1.isEmpty())
+        ImageService::instance().loadInto(ui->imageLabel1, imagePath1);
+    if (!imagePath2.isEmpty())
+        ImageService::instance().loadInto(ui->imageLabel2, imagePath2);
 
     // --------------------
     // Certification (Multi-select)
@@ -596,6 +652,16 @@ void OrderWidget::loadOrder(int orderId)
     // --------------------
     ui->notePlainTextEdit->setPlainText(o.note);
     ui->extraDetailPlainTextEdit->setPlainText(o.extraDetail);
+
+    // --------------------
+    // Baseline for dirty-field tracking
+    // --------------------
+    // Taken through the form, not from `o`, so that trimming and combo
+    // fallbacks do not show up as edits
+    m_loaded = OrderData();
+    fillOrderData(m_loaded);
+    m_loaded.jobId = o.jobId;
+    m_loaded.rowVersion = o.rowVersion;
 }
 
 
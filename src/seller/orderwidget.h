@@ -40,6 +40,10 @@ private:
     bool isEditMode = false;
     int m_orderId = 0;
 
+    // What fillOrderData() returned right after loadOrder(); saving in edit
+    // mode writes only the fields that differ from it
+    OrderData m_loaded;
+
 };
 
 #endif // ORDERWIDGET_H